@@ -0,0 +1,584 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Dice/hypertrie/hypertrie.hpp>
+
+#include <fmt/format.h>
+
+#include "utils/GenerateTriples.hpp"
+
+/**
+ * Reproducible benchmarks for the core operations of hypertrie.
+ *
+ * The benchmarks run on a depth 3 hypertrie filled with random triples generated by tests/utils/GenerateTriples.hpp
+ * with a fixed seed. Each benchmark prints one JSON object per line to stdout with its throughput, latency percentiles
+ * and the peak resident set size of the process so far.
+ *
+ * usage: benchmarks_hypertrie [triples] [max_key_part] [runs]
+ */
+namespace hypertrie::benchmarks {
+	using namespace std::chrono;
+	using namespace fmt::literals;
+
+	using tr = default_bool_Hypertrie_t;
+	using key_part_type = typename tr::key_part_type;
+	using Key = typename tr::Key;
+	using SliceKey = typename tr::SliceKey;
+
+	/**
+	 * @return the peak resident set size (VmHWM) of this process in KiB or 0 if it is not available.
+	 */
+	inline size_t peak_rss_kb() {
+		std::FILE *file = std::fopen("/proc/self/status", "r");
+		if (file == nullptr)
+			return 0;
+		char line[128];
+		size_t peak_rss = 0;
+		while (std::fgets(line, 128, file) != nullptr) {
+			if (std::strncmp(line, "VmHWM:", 6) == 0) {
+				peak_rss = std::strtoul(line + 6, nullptr, 10);
+				break;
+			}
+		}
+		std::fclose(file);
+		return peak_rss;
+	}
+
+	/**
+	 * Collects the latencies of the samples of a benchmark. A sample may consist of several operations,
+	 * e.g. a full iteration over a hypertrie. Throughput is reported in operations per second.
+	 */
+	class Measurement {
+		std::string name_;
+		std::vector<uint64_t> latencies_ns_;
+		size_t operations_ = 0;
+
+	public:
+		explicit Measurement(std::string name) : name_(std::move(name)) {}
+
+		/**
+		 * Times f() as one sample. f returns the number of operations it performed.
+		 */
+		template<typename F>
+		void sample(F &&f) {
+			auto start = steady_clock::now();
+			size_t operations = f();
+			auto end = steady_clock::now();
+			latencies_ns_.push_back(duration_cast<nanoseconds>(end - start).count());
+			operations_ += operations;
+		}
+
+		void report(std::ostream &out) {
+			std::sort(latencies_ns_.begin(), latencies_ns_.end());
+			auto percentile = [&](double p) -> uint64_t {
+				if (latencies_ns_.empty())
+					return 0;
+				return latencies_ns_[std::min(latencies_ns_.size() - 1, size_t(p * double(latencies_ns_.size())))];
+			};
+			const uint64_t total_ns = std::accumulate(latencies_ns_.begin(), latencies_ns_.end(), uint64_t(0));
+			const double seconds = double(total_ns) / 1e9;
+			out << fmt::format(R"({{"benchmark": "{}", "samples": {}, "operations": {}, "seconds": {:.6f}, "throughput_ops_per_s": {:.1f}, )"
+							   R"("latency_ns": {{"p50": {}, "p90": {}, "p99": {}, "max": {}}}, "peak_rss_kb": {}}})",
+							   name_, latencies_ns_.size(), operations_, seconds, (seconds > 0) ? double(operations_) / seconds : 0.0,
+							   percentile(0.5), percentile(0.9), percentile(0.99), (latencies_ns_.empty()) ? 0 : latencies_ns_.back(),
+							   peak_rss_kb())
+				<< std::endl;
+		}
+	};
+
+	struct Config {
+		size_t triples = 1'000'000;
+		key_part_type max_key_part = 100'000;
+		size_t runs = 5;
+	};
+
+	inline std::vector<Key> generateTriples(const Config &config) {
+		tests::utils::resetDefaultRandomNumberGenerator();
+		auto triples = tests::utils::generateNTuples<key_part_type>(config.triples, 3, config.max_key_part);
+		// key part 0 is reserved for unset key parts
+		for (auto &triple : triples)
+			for (auto &key_part : triple)
+				++key_part;
+		return triples;
+	}
+
+	void benchmarkSet(const Config &, const std::vector<Key> &triples) {
+		Measurement measurement{"set"};
+		HypertrieContext<tr> context;
+		Hypertrie<tr> hypertrie{3, context};
+		for (const auto &triple : triples)
+			measurement.sample([&]() -> size_t { hypertrie.set(triple, true); return 1; });
+		measurement.report(std::cout);
+	}
+
+	void benchmarkBulkInserter(const Config &config, const std::vector<Key> &triples) {
+		Measurement measurement{"bulk_insert"};
+		for ([[maybe_unused]] size_t run = 0; run < config.runs; ++run) {
+			HypertrieContext<tr> context;
+			Hypertrie<tr> hypertrie{3, context};
+			measurement.sample([&]() -> size_t {
+				BulkInserter<tr> bulk_inserter{hypertrie, 0};
+				for (const auto &triple : triples)
+					bulk_inserter.add(Key{triple});
+				bulk_inserter.flush(true);
+				return triples.size();
+			});
+		}
+		measurement.report(std::cout);
+	}
+
+	/**
+	 * Bulk loads the triples into a ShardedHypertrie with one shard per hardware thread and evaluates einsum over it.
+	 * Compare with bulk_insert and einsum of the unsharded hypertrie.
+	 */
+	void benchmarkSharded(const Config &config, const std::vector<Key> &triples) {
+		const size_t shard_count = std::max(1U, std::thread::hardware_concurrency());
+		Measurement load{"sharded_bulk_insert_{}_shards"_format(shard_count)};
+		std::unique_ptr<ShardedHypertrie<tr>> sharded;
+		for ([[maybe_unused]] size_t run = 0; run < config.runs; ++run) {
+			sharded = std::make_unique<ShardedHypertrie<tr>>(3, shard_count);
+			load.sample([&]() -> size_t {
+				sharded->bulk_insert(triples);
+				return triples.size();
+			});
+		}
+		load.report(std::cout);
+
+		for (const std::string subscript_string : {"abc->a", "abc,ade->bcde", "abc,adb->cd"}) {
+			// all operands are the same ShardedHypertrie, so they are co-partitioned if they share the label at position 0
+			auto subscript = std::make_shared<Subscript>(subscript_string);
+			std::vector<ShardedOperand<tr>> operands(subscript->getRawSubscript().operands.size(), ShardedOperand<tr>{*sharded});
+			Measurement measurement{"sharded_einsum<size_t> {}"_format(subscript_string)};
+			for ([[maybe_unused]] size_t run = 0; run < config.runs; ++run)
+				measurement.sample([&]() -> size_t {
+					return sharded_einsum2map<size_t, tr>(subscript, operands).size();
+				});
+			measurement.report(std::cout);
+		}
+	}
+
+	/**
+	 * Sets triples through a WriteAheadLog that is synced after every group, for several group sizes.
+	 * Without group commit (group size 1) every set is synced, so only a prefix of the triples is used.
+	 */
+	void benchmarkLoggedSet(const Config &, const std::vector<Key> &triples) {
+		const auto path = std::filesystem::temp_directory_path() / "hypertrie_benchmark.wal";
+		for (size_t group_size : {size_t(1), size_t(64), size_t(4096)}) {
+			std::filesystem::remove(path);
+			Measurement measurement{"logged_set_group{}"_format(group_size)};
+			HypertrieContext<tr> context;
+			Hypertrie<tr> hypertrie{3, context};
+			WriteAheadLog<tr> log{path, {group_size, true}};
+			const size_t sets = (group_size == 1) ? std::min<size_t>(triples.size(), 10'000) : triples.size();
+			for (size_t i = 0; i < sets; ++i)
+				measurement.sample([&]() -> size_t { log.set(hypertrie, triples[i], true); return 1; });
+			log.commit();
+			measurement.report(std::cout);
+		}
+		std::filesystem::remove(path);
+	}
+
+	/**
+	 * Writes a full checkpoint of all triples but the last 1 %, sets those and writes an incremental checkpoint.
+	 * The operations of a checkpoint are the bytes written.
+	 */
+	void benchmarkCheckpoint(const Config &, const std::vector<Key> &triples) {
+		const auto full_path = std::filesystem::temp_directory_path() / "hypertrie_benchmark_full.ckpt";
+		const auto incremental_path = std::filesystem::temp_directory_path() / "hypertrie_benchmark_incremental.ckpt";
+		HypertrieContext<tr> context;
+		Hypertrie<tr> hypertrie{3, context};
+		const size_t checkpointed = triples.size() - triples.size() / 100;
+		for (size_t i = 0; i < checkpointed; ++i)
+			hypertrie.set(triples[i], true);
+
+		Measurement full{"checkpoint_full"};
+		full.sample([&]() -> size_t {
+			HypertrieCheckpoint<tr>::write(context, {hypertrie}, full_path);
+			return std::filesystem::file_size(full_path);
+		});
+		full.report(std::cout);
+
+		for (size_t i = checkpointed; i < triples.size(); ++i)
+			hypertrie.set(triples[i], true);
+		Measurement incremental{"checkpoint_incremental"};
+		incremental.sample([&]() -> size_t {
+			HypertrieCheckpoint<tr>::write(context, {hypertrie}, incremental_path);
+			return std::filesystem::file_size(incremental_path);
+		});
+		incremental.report(std::cout);
+
+		Measurement restore{"checkpoint_restore"};
+		restore.sample([&]() -> size_t {
+			HypertrieContext<tr> restored_context;
+			auto restored = HypertrieCheckpoint<tr>::restore(restored_context, {full_path, incremental_path});
+			return restored[0].size();
+		});
+		restore.report(std::cout);
+		std::filesystem::remove(full_path);
+		std::filesystem::remove(incremental_path);
+	}
+
+	/**
+	 * Looks up all triples in a hypertrie with paging enabled. At most one depth 1 or 2 node per 10 triples is kept in
+	 * memory, so most lookups fault in nodes from the page file.
+	 */
+	void benchmarkPagedLookup(const Config &, const std::vector<Key> &triples) {
+		const auto page_file = std::filesystem::temp_directory_path() / "hypertrie_benchmark.pages";
+		HypertrieContext<tr> context;
+		context.enableNodePaging({page_file, std::max<size_t>(triples.size() / 10, 1), 3});
+		Hypertrie<tr> hypertrie{3, context};
+		for (const auto &triple : triples)
+			hypertrie.set(triple, true);
+
+		Measurement evict{"paged_evict"};
+		evict.sample([&]() -> size_t { return context.evictNodes(); });
+		evict.report(std::cout);
+
+		Measurement lookups{"paged_lookup"};
+		size_t found = 0;
+		for (const auto &triple : triples)
+			lookups.sample([&]() -> size_t { found += hypertrie[triple]; return 1; });
+		lookups.report(std::cout);
+		if (found != triples.size())
+			std::cerr << "paged lookups failed" << std::endl;
+	}
+
+	void benchmarkLookup(const Config &config, const Hypertrie<tr> &hypertrie, const std::vector<Key> &triples) {
+		Measurement hits{"lookup_hit"};
+		size_t found = 0;
+		for (const auto &triple : triples)
+			hits.sample([&]() -> size_t { found += hypertrie[triple]; return 1; });
+		hits.report(std::cout);
+
+		Measurement misses{"lookup_random"};
+		auto random_triples = tests::utils::generateNTuples<key_part_type>(triples.size(), 3, config.max_key_part);
+		for (auto &triple : random_triples) {
+			for (auto &key_part : triple)
+				++key_part;
+			misses.sample([&]() -> size_t { found += hypertrie[triple]; return 1; });
+		}
+		misses.report(std::cout);
+		if (found == 0)
+			std::cerr << "no lookup succeeded" << std::endl;
+	}
+
+	void benchmarkSlice(const Config &, const Hypertrie<tr> &hypertrie, const std::vector<Key> &triples) {
+		const size_t slices = std::min<size_t>(triples.size(), 100'000);
+		for (size_t pos = 0; pos < 3; ++pos) {
+			Measurement measurement{"slice_depth2_pos{}"_format(pos)};
+			for (size_t i = 0; i < slices; ++i) {
+				SliceKey slice_key(3);
+				slice_key[pos] = triples[i][pos];
+				measurement.sample([&]() -> size_t { auto result = hypertrie[slice_key]; return std::get<0>(result).size() > 0; });
+			}
+			measurement.report(std::cout);
+		}
+		for (size_t pos = 0; pos < 3; ++pos) {
+			Measurement measurement{"slice_depth1_pos{}"_format(pos)};
+			for (size_t i = 0; i < slices; ++i) {
+				SliceKey slice_key(triples[i].begin(), triples[i].end());
+				slice_key[pos] = std::nullopt;
+				measurement.sample([&]() -> size_t { auto result = hypertrie[slice_key]; return std::get<0>(result).size() > 0; });
+			}
+			measurement.report(std::cout);
+		}
+	}
+
+	void benchmarkIteration(const Config &config, const Hypertrie<tr> &hypertrie) {
+		Measurement measurement{"iteration"};
+		for ([[maybe_unused]] size_t run = 0; run < config.runs; ++run)
+			measurement.sample([&]() -> size_t {
+				size_t count = 0;
+				for ([[maybe_unused]] const auto &key : hypertrie)
+					++count;
+				return count;
+			});
+		measurement.report(std::cout);
+	}
+
+	void benchmarkRawKeyIteration(const Config &config, const Hypertrie<tr> &hypertrie) {
+		const StaticHypertrie<3, tr> static_hypertrie{hypertrie};
+		Measurement measurement{"iteration_raw_key"};
+		for ([[maybe_unused]] size_t run = 0; run < config.runs; ++run)
+			measurement.sample([&]() -> size_t {
+				size_t count = 0;
+				for (auto it = static_hypertrie.rawKeyBegin(); it; ++it)
+					++count;
+				return count;
+			});
+		measurement.report(std::cout);
+
+		Measurement fill_measurement{"iteration_raw_key_fill"};
+		std::vector<typename StaticHypertrie<3, tr>::Key> block(1024);
+		for ([[maybe_unused]] size_t run = 0; run < config.runs; ++run)
+			fill_measurement.sample([&]() -> size_t {
+				size_t count = 0;
+				auto it = static_hypertrie.rawKeyBegin();
+				for (size_t written = it.fill(block); written > 0; written = it.fill(block))
+					count += written;
+				return count;
+			});
+		fill_measurement.report(std::cout);
+	}
+
+	void benchmarkHashDiagonal(const Config &config, const Hypertrie<tr> &hypertrie) {
+		for (pos_type pos = 0; pos < 3; ++pos) {
+			Measurement measurement{"hash_diagonal_pos{}"_format(pos)};
+			for ([[maybe_unused]] size_t run = 0; run < config.runs; ++run)
+				measurement.sample([&]() -> size_t {
+					size_t count = 0;
+					HashDiagonal<tr> diagonal{hypertrie, {pos}};
+					for (diagonal.begin(); diagonal != diagonal.end(); ++diagonal)
+						count += diagonal.currentHypertrie().size() > 0;
+					return count;
+				});
+			measurement.report(std::cout);
+		}
+	}
+
+	void benchmarkHashJoin(const Config &config, const Hypertrie<tr> &hypertrie) {
+		// subject-object join
+		Measurement measurement{"hash_join_pos0_pos2"};
+		for ([[maybe_unused]] size_t run = 0; run < config.runs; ++run)
+			measurement.sample([&]() -> size_t {
+				size_t count = 0;
+				HashJoin<tr> join{{hypertrie, hypertrie}, {{0}, {2}}};
+				for (auto it = join.begin(); it; ++it)
+					++count;
+				return count;
+			});
+		measurement.report(std::cout);
+	}
+
+	/**
+	 * Joins depth 1 hypertries of similar size, which HashJoin intersects with sorted buffers, and compares it with
+	 * probing every key part of the smallest operand in the others via HashDiagonal::find. A skewed join of a small with a
+	 * large operand shows that it is left to the diagonals.
+	 * The benchmark names are prefixed by depth1_join.
+	 */
+	void benchmarkDepth1Join(const Config &config) {
+		constexpr size_t operand_size = 300'000;
+		std::mt19937_64 random{42};
+		std::uniform_int_distribution<key_part_type> key_parts{1, 4 * operand_size};
+		HypertrieContext<tr> context;
+		std::vector<Hypertrie<tr>> hypertries;
+		for (size_t size : {operand_size, operand_size, operand_size, size_t(2)}) {
+			auto &hypertrie = hypertries.emplace_back(1, context);
+			while (hypertrie.size() < size)
+				hypertrie.set({key_parts(random)}, true);
+		}
+		const std::vector<const_Hypertrie<tr>> similar{hypertries[0], hypertries[1], hypertries[2]};
+		const std::vector<const_Hypertrie<tr>> skewed{hypertries[3], hypertries[0]};
+
+		auto measureJoin = [&](const std::string &name, const std::vector<const_Hypertrie<tr>> &operands) {
+			Measurement measurement{"depth1_join_{}"_format(name)};
+			for ([[maybe_unused]] size_t run = 0; run < config.runs; ++run)
+				measurement.sample([&]() -> size_t {
+					size_t count = 0;
+					HashJoin<tr> join{operands, std::vector<HashJoin<tr>::poss_type>(operands.size(), {0})};
+					for (auto it = join.begin(); it; ++it)
+						++count;
+					return std::max(count, size_t(1));
+				});
+			measurement.report(std::cout);
+		};
+		measureJoin("sorted", similar);
+		measureJoin("skewed", skewed);
+
+		Measurement probing{"depth1_join_probing"};
+		for ([[maybe_unused]] size_t run = 0; run < config.runs; ++run)
+			probing.sample([&]() -> size_t {
+				size_t count = 0;
+				std::vector<HashDiagonal<tr>> diagonals;
+				for (const auto &operand : similar)
+					diagonals.emplace_back(operand, typename tr::KeyPositions{0});
+				for (diagonals[0].begin(); not diagonals[0].ended(); ++diagonals[0]) {
+					const key_part_type key_part = diagonals[0].currentKeyPart();
+					count += diagonals[1].find(key_part) and diagonals[2].find(key_part);
+				}
+				return std::max(count, size_t(1));
+			});
+		probing.report(std::cout);
+	}
+
+	template<typename value_type>
+	void benchmarkEinsum(const Config &config, const Hypertrie<tr> &hypertrie, const std::string &subscript_string) {
+		auto subscript = std::make_shared<Subscript>(subscript_string);
+		std::vector<const_Hypertrie<tr>> operands(subscript->getRawSubscript().operands.size(), hypertrie);
+		Measurement measurement{"einsum<{}> {}"_format((std::is_same_v<value_type, bool>) ? "bool" : "size_t", subscript_string)};
+		for ([[maybe_unused]] size_t run = 0; run < config.runs; ++run)
+			measurement.sample([&]() -> size_t {
+				size_t count = 0;
+				Einsum<value_type, tr> einsum{subscript, operands};
+				for (auto it = einsum.begin(); it; ++it)
+					++count;
+				return count;
+			});
+		measurement.report(std::cout);
+	}
+
+	/**
+	 * Counts the triangles and 4-cycles of the graph formed by the triples (subject and object are nodes, the predicate
+	 * is projected out) with the label-at-a-time JoinOperator and with the GenericJoinOperator.
+	 * The benchmark names are prefixed by cycle_<strategy>.
+	 */
+	void benchmarkCycleCounting(const Config &config, const Hypertrie<tr> &hypertrie) {
+		for (const auto &subscript_string : {"axb,byc,cza->", "awb,bxc,cyd,dza->"}) {
+			auto subscript = std::make_shared<Subscript>(subscript_string);
+			std::vector<const_Hypertrie<tr>> operands(subscript->getRawSubscript().operands.size(), hypertrie);
+			std::vector<size_t> cycles;
+			for (const auto &[strategy_name, join_strategy] : {std::pair{"label_at_a_time", JoinStrategy::label_at_a_time},
+															   std::pair{"generic_join", JoinStrategy::generic_join}}) {
+				Measurement measurement{"cycle_{} {}"_format(strategy_name, subscript_string)};
+				size_t count = 0;
+				for ([[maybe_unused]] size_t run = 0; run < config.runs; ++run)
+					measurement.sample([&]() -> size_t {
+						Einsum<size_t, tr> einsum{subscript, operands, TimePoint::max(), join_strategy};
+						count = 0;
+						for (auto &&entry : einsum)
+							count += entry.value;
+						return 1;
+					});
+				measurement.report(std::cout);
+				cycles.push_back(count);
+			}
+			if (cycles.front() != cycles.back())
+				std::cerr << "cycle counts differ for {}"_format(subscript_string) << std::endl;
+		}
+	}
+
+	/**
+	 * Evaluates a subscript with the generic Einsum and with the StaticEinsum that is specialized for it at compile time.
+	 * The benchmark names are prefixed by static_<path>.
+	 */
+	template<::einsum::internal::SubscriptLiteral subscript>
+	void benchmarkStaticEinsum(const Config &config, const Hypertrie<tr> &hypertrie) {
+		const std::string subscript_string{subscript.chars.data()};
+		std::vector<const_Hypertrie<tr>> operands(StaticEinsum<subscript, size_t, tr>::operand_count, hypertrie);
+		auto shared_subscript = std::make_shared<Subscript>(subscript_string);
+
+		Measurement generic{"static_generic {}"_format(subscript_string)};
+		size_t generic_sum = 0;
+		for ([[maybe_unused]] size_t run = 0; run < config.runs; ++run)
+			generic.sample([&]() -> size_t {
+				Einsum<size_t, tr> einsum{shared_subscript, operands};
+				generic_sum = 0;
+				for (auto &&entry : einsum)
+					generic_sum += entry.value;
+				return 1;
+			});
+		generic.report(std::cout);
+
+		Measurement specialized{"static_specialized {}"_format(subscript_string)};
+		size_t specialized_sum = 0;
+		for ([[maybe_unused]] size_t run = 0; run < config.runs; ++run)
+			specialized.sample([&]() -> size_t {
+				specialized_sum = 0;
+				StaticEinsum<subscript, size_t, tr>::run(operands, [&](const auto &, size_t value) { specialized_sum += value; });
+				return 1;
+			});
+		specialized.report(std::cout);
+
+		if (generic_sum != specialized_sum)
+			std::cerr << "static einsum results differ for {}"_format(subscript_string) << std::endl;
+	}
+
+	/**
+	 * Compares the container choices for node edges and node storage on a load and two query workloads.
+	 * The benchmark names are prefixed by container_<name>.
+	 */
+	template<HypertrieTrait container_tr>
+	void benchmarkContainer(const Config &, const std::vector<Key> &triples, const std::string &name) {
+		HypertrieContext<container_tr> context;
+		Hypertrie<container_tr> hypertrie{3, context};
+		Measurement load{"container_{}_set"_format(name)};
+		for (const auto &triple : triples)
+			load.sample([&]() -> size_t { hypertrie.set(triple, true); return 1; });
+		load.report(std::cout);
+
+		Measurement hits{"container_{}_lookup_hit"_format(name)};
+		size_t found = 0;
+		for (const auto &triple : triples)
+			hits.sample([&]() -> size_t { found += hypertrie[triple]; return 1; });
+		hits.report(std::cout);
+
+		Measurement slices{"container_{}_slice_depth1"_format(name)};
+		for (size_t i = 0; i < std::min<size_t>(triples.size(), 100'000); ++i) {
+			SliceKey slice_key(triples[i].begin(), triples[i].end());
+			slice_key[2] = std::nullopt;
+			slices.sample([&]() -> size_t { auto result = hypertrie[slice_key]; return std::get<0>(result).size() > 0; });
+		}
+		slices.report(std::cout);
+		if (found == 0)
+			std::cerr << "no lookup succeeded" << std::endl;
+	}
+
+	void run(const Config &config) {
+		std::cout << fmt::format(R"({{"config": {{"triples": {}, "max_key_part": {}, "runs": {}}}}})",
+								 config.triples, config.max_key_part, config.runs)
+				  << std::endl;
+		auto triples = generateTriples(config);
+
+		benchmarkSet(config, triples);
+		benchmarkBulkInserter(config, triples);
+		benchmarkSharded(config, triples);
+		benchmarkLoggedSet(config, triples);
+		benchmarkCheckpoint(config, triples);
+		benchmarkPagedLookup(config, triples);
+
+		HypertrieContext<tr> context;
+		Hypertrie<tr> hypertrie{3, context};
+		for (const auto &triple : triples)
+			hypertrie.set(triple, true);
+
+		benchmarkLookup(config, hypertrie, triples);
+		benchmarkSlice(config, hypertrie, triples);
+		benchmarkIteration(config, hypertrie);
+		benchmarkRawKeyIteration(config, hypertrie);
+		benchmarkHashDiagonal(config, hypertrie);
+		benchmarkHashJoin(config, hypertrie);
+		benchmarkDepth1Join(config);
+
+		// projection, star join, path join, cycle
+		for (const auto &subscript : {"abc->a", "abc->b", "abc,ade->bcde", "abc,cde->ae", "abc,cde,efa->ace"}) {
+			benchmarkEinsum<size_t>(config, hypertrie, subscript);
+			benchmarkEinsum<bool>(config, hypertrie, subscript);
+		}
+		benchmarkCycleCounting(config, hypertrie);
+
+		benchmarkStaticEinsum<"abc,cde->ae">(config, hypertrie);
+		benchmarkStaticEinsum<"abc,ade->bcde">(config, hypertrie);
+		benchmarkStaticEinsum<"axb,byc,cza->">(config, hypertrie);
+
+		benchmarkContainer<default_bool_Hypertrie_t>(config, triples, "tsl_sparse");
+		benchmarkContainer<Hypertrie_t<key_part_type, bool, internal::container::std_unordered_map, internal::container::std_unordered_set>>(config, triples, "std_unordered");
+		benchmarkContainer<swiss_bool_Hypertrie_t>(config, triples, "swiss");
+		benchmarkContainer<depth_tuned_bool_Hypertrie_t>(config, triples, "depth_tuned");
+	}
+}// namespace hypertrie::benchmarks
+
+int main(int argc, char *argv[]) {
+	hypertrie::benchmarks::Config config;
+	if (argc > 1)
+		config.triples = std::stoul(argv[1]);
+	if (argc > 2)
+		config.max_key_part = std::stoul(argv[2]);
+	if (argc > 3)
+		config.runs = std::stoul(argv[3]);
+	if (argc > 4 or config.triples == 0 or config.max_key_part == 0 or config.runs == 0) {
+		std::cerr << "usage: " << argv[0] << " [triples] [max_key_part] [runs]" << std::endl;
+		return EXIT_FAILURE;
+	}
+	hypertrie::benchmarks::run(config);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,98 @@
+#ifndef HYPERTRIE_ASYNCEINSUM_HPP
+#define HYPERTRIE_ASYNCEINSUM_HPP
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <tsl/sparse_set.h>
+
+#include "Dice/einsum/internal/Einsum.hpp"
+#include "Dice/einsum/internal/util/AsyncGenerator.hpp"
+#include "Dice/einsum/internal/util/Executor.hpp"
+
+namespace einsum::internal {
+
+	struct AsyncEinsumConfig {
+		/**
+		 * The executor that the query yields to. If nullptr, the query never yields and runs on the consumer's thread
+		 * until a batch is complete.
+		 */
+		util::Executor *executor = nullptr;
+		/**
+		 * Maximal number of entries per batch.
+		 */
+		size_t batch_size = 1024;
+		/**
+		 * Number of loop iterations in JoinOperator and CartesianOperator after which the query yields to the executor,
+		 * so that other queries can run.
+		 */
+		size_t yield_interval = 4096;
+		TimePoint timeout = TimePoint::max();
+		JoinStrategy join_strategy = JoinStrategy::label_at_a_time;
+	};
+
+	/**
+	 * Evaluates einsum as a coroutine that produces the result in batches. Between batches, and at the yield points of
+	 * the operators (see Context::shouldYield()), the query is suspended and continued by config.executor, so that many
+	 * queries can be multiplexed on a few threads.
+	 *
+	 * As with Einsum, for value_type bool every key is produced once; otherwise, the values of entries with equal keys
+	 * must be summed. The operands must not be modified while the generator is in use.
+	 * @param subscript the subscript. The query uses its own copy, as subscripts are not thread-safe.
+	 * @param operands the operands
+	 * @param config executor, batch size, yield interval and timeout
+	 * @return a generator of non-empty batches of entries
+	 */
+	template<typename value_type, HypertrieTrait tr>
+	util::AsyncGenerator<std::vector<Entry<value_type, tr>>>
+	asyncEinsum(std::shared_ptr<Subscript> subscript, std::vector<const_Hypertrie<tr>> operands, AsyncEinsumConfig config = {}) {
+		using Operator_t = Operator<value_type, tr>;
+		using Entry_t = Entry<value_type, tr>;
+
+		auto query_subscript = std::make_shared<Subscript>(subscript->getRawSubscript());
+		subscript.reset();
+		auto context = std::make_shared<Context>(config.timeout, config.join_strategy);
+		if (config.executor != nullptr)
+			context->yield_interval = config.yield_interval;
+		auto op = Operator_t::construct(query_subscript, context);
+		Entry_t entry(query_subscript->resultLabelCount(), Operator_t::default_key_part);
+		tsl::sparse_set<size_t, std::identity> found_entries{};
+
+		std::vector<Entry_t> batch;
+		batch.reserve(config.batch_size);
+		if (config.executor != nullptr)
+			co_await config.executor->schedule();
+		op->load(operands, entry);
+		while (true) {
+			if (context->yield_requested) {
+				context->yield_requested = false;
+				co_await config.executor->schedule();
+				if (op->ended())
+					break;
+				op->next();
+				continue;
+			}
+			if (op->ended())
+				break;
+			if constexpr (std::is_same_v<value_type, bool>) {
+				if (found_entries.insert(Dice::hash::dice_hash(entry.key)).second)
+					batch.push_back(entry);
+			} else {
+				batch.push_back(entry);
+			}
+			if (batch.size() == config.batch_size) {
+				co_yield std::exchange(batch, {});
+				batch.reserve(config.batch_size);
+				if (config.executor != nullptr)
+					co_await config.executor->schedule();
+			}
+			op->next();
+		}
+		if (not batch.empty())
+			co_yield std::move(batch);
+	}
+
+}// namespace einsum::internal
+
+#endif//HYPERTRIE_ASYNCEINSUM_HPP
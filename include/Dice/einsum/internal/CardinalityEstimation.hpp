@@ -2,6 +2,7 @@
 #define HYPERTRIE_CARDINALITYESTIMATION_HPP
 
 #include <cmath>
+#include <span>
 #include "Dice/einsum/internal/Subscript.hpp"
 #include "Dice/einsum/internal/Entry.hpp"
 
@@ -18,7 +19,7 @@ namespace einsum::internal {
 		 * @param sc
 		 * @return
 		 */
-		static Label getMinCardLabel(const std::vector<const_Hypertrie<tr>> &operands,
+		static Label getMinCardLabel(std::span<const const_Hypertrie<tr>> operands,
 		                             const std::shared_ptr<Subscript> &sc,
 		                             [[maybe_unused]] std::shared_ptr<Context> context) {
 			const tsl::hopscotch_set <Label> &operandsLabelSet = sc->getOperandsLabelSet();
@@ -44,7 +45,7 @@ namespace einsum::internal {
 
 
 		static double estimate(
-				const std::vector<const_Hypertrie<tr>> &operands,
+				std::span<const const_Hypertrie<tr>> operands,
 				const std::shared_ptr<Subscript> &sc,
 				[[maybe_unused]] std::shared_ptr<Context> context) {
 			const tsl::hopscotch_set<Label> &operandsLabelSet = sc->getOperandsLabelSet();
@@ -73,6 +74,18 @@ namespace einsum::internal {
 			return card;
 		}
 
+		/**
+		 * Estimates the number of key parts that a label is bound to when it is joined.
+		 * @param operands the operands of the subscript
+		 * @param label a label of the subscript
+		 * @param sc the subscript
+		 * @return the estimated cardinality of label
+		 */
+		static double estimateLabel(std::span<const const_Hypertrie<tr>> operands, const Label label,
+		                            const std::shared_ptr<Subscript> &sc) {
+			return calcCard(operands, label, sc);
+		}
+
 	protected:
 		/**
 		 * Calculates the cardinality of an Label in an Step.
@@ -82,7 +95,7 @@ namespace einsum::internal {
 		 * @param label the label
 		 * @return label's cardinality in current step.
 		 */
-		static double calcCard(const std::vector<const_Hypertrie<tr>> &operands, const Label label,
+		static double calcCard(std::span<const const_Hypertrie<tr>> operands, const Label label,
 		                       const std::shared_ptr<Subscript> &sc) {
 			// get operands that have the label
 			const std::vector<LabelPos> &op_poss = sc->getPossOfOperandsWithLabel(label);
@@ -18,12 +18,43 @@ namespace einsum::internal {
 
 		std::vector<std::shared_ptr<Operator_t>> sub_operators; // set in construct
 		std::vector<Entry_t> sub_entries;
+		std::vector<OperandFrame<tr>> sub_operands; // set in construct // refilled in load_impl
 
 		std::size_t iterated_pos; // set in load_impl
 		OriginalResultPoss iterated_sub_operator_result_mapping; // set in load_impl
 		FullCartesianResult calculated_operands; // set in load_impl // updated in next
 		bool ended_ = true; // set in load_impl // updated in load_impl, next
 
+		/**
+		 * Where the operator suspended at a yield point. It is resumed there by the next call of next().
+		 */
+		enum struct Suspension {
+			none,
+			/**
+			 * the sub_operator at suspended_pos suspended while it was loaded
+			 */
+			loading,
+			/**
+			 * the sub_operator at suspended_pos suspended while its results were collected
+			 */
+			collecting,
+			/**
+			 * suspended at the yield point while the results of the sub_operator at suspended_pos were collected
+			 */
+			collecting_self,
+			/**
+			 * the iterated sub_operator suspended
+			 */
+			iterating
+		};
+		Suspension suspended_ = Suspension::none;
+		std::size_t suspended_pos = 0;
+		// state of load_impl that is kept while the operator is suspended
+		Operands<tr> pending_operands;
+		double max_estimated_size = 0;
+		std::vector<SubResult> sub_results;
+		SubResult sub_result;
+
 	public:
 		CartesianOperator(const std::shared_ptr<Subscript> &subscript, const std::shared_ptr<Context> &context)
 				: Operator_t(Subscript::Type::Cartesian, subscript, context, this) {
@@ -31,9 +62,11 @@ namespace einsum::internal {
 			const std::vector<std::shared_ptr<Subscript>> &sub_subscripts = this->subscript->getCartesianSubscript().getSubSubscripts();
 			sub_operators.reserve(sub_subscripts.size());
 			sub_entries.reserve(sub_subscripts.size());
+			sub_operands.reserve(sub_subscripts.size());
 			for (const auto &sub_subscript : sub_subscripts) {
 				sub_operators.push_back(Operator_t::construct(sub_subscript, context));
 				sub_entries.push_back(Entry_t(sub_subscript->resultLabelCount(), default_key_part));
+				sub_operands.emplace_back(&this->context->operand_memory);
 			}
 
 		}
@@ -41,6 +74,10 @@ namespace einsum::internal {
 
 		static void next(void *self_raw) {
 			auto &self = *static_cast<CartesianOperator *>(self_raw);
+			if (self.suspended_ != Suspension::none) {
+				self.resume();
+				return;
+			}
 			// get the accumulated entry from the from pre-calculated carth_operands
 			if constexpr (bool_value_type) {
 				if (self.subscript->all_result_done) {
@@ -53,22 +90,10 @@ namespace einsum::internal {
 			if (self.calculated_operands.ended()) {
 				auto &intereated_sub_op = self.sub_operators[self.iterated_pos];
 				intereated_sub_op->operator++();
-				if (not intereated_sub_op->ended()) {
-					self.calculated_operands.restart();
-
-				} else { // if it is ended, set to ended_
-					self.ended_ = true;
-					return;
-				}
+				self.continueIterated();
+				return;
 			}
-			const auto &iterated_sub_entry = self.sub_entries[self.iterated_pos];
-			updateEntryKey(self.iterated_sub_operator_result_mapping, *self.entry, iterated_sub_entry.key);
-			assert(iterated_sub_entry.value);
-			assert(self.entry->value);
-			if constexpr (not bool_value_type)
-				self.entry->value *= iterated_sub_entry.value;
-			if constexpr (_debugeinsum_)
-				fmt::print("[{}]->{} {}\n", fmt::join(self.entry->key, ","), self.entry->value, self.subscript);
+			self.writeIteratedEntry();
 		}
 
 		static bool ended(const void *self_raw) {
@@ -77,8 +102,8 @@ namespace einsum::internal {
 		}
 
 		static void
-		load(void *self_raw, std::vector<const_Hypertrie<tr>> operands, Entry_t &entry) {
-			static_cast<CartesianOperator *>(self_raw)->load_impl(std::move(operands), entry);
+		load(void *self_raw, Operands<tr> operands, Entry_t &entry) {
+			static_cast<CartesianOperator *>(self_raw)->load_impl(operands, entry);
 		}
 
 		static void clear(void *self_raw) {
@@ -88,16 +113,18 @@ namespace einsum::internal {
 
 	private:
 
-		std::vector<const_Hypertrie<tr>>
-		extractOperands(CartesianOperandPos cart_op_pos, const std::vector<const_Hypertrie<tr>> &operands) {
-
-			std::vector<const_Hypertrie<tr>> sub_operands;
-
+		/**
+		 * Fills the operand frame of a sub_operator with its operands.
+		 */
+		Operands<tr>
+		extractOperands(CartesianOperandPos cart_op_pos, Operands<tr> operands) {
+			auto &frame = sub_operands[cart_op_pos];
+			frame.clear();
 			for (const auto &original_op_pos : this->subscript->getCartesianSubscript().getOriginalOperandPoss(
 					cart_op_pos))
-				sub_operands.emplace_back(operands[original_op_pos]);
+				frame.push_back(operands[original_op_pos]);
 
-			return sub_operands;
+			return frame;
 		}
 
 		inline void clear_impl(){
@@ -105,42 +132,101 @@ namespace einsum::internal {
 				sub_operator->clear();
 			for (auto &sub_entry : sub_entries)
 				sub_entry.clear(default_key_part);
+			for (auto &frame : sub_operands)
+				frame.clear();
 			calculated_operands = {};
+			suspended_ = Suspension::none;
+			pending_operands = {};
+			sub_results = {};
+			sub_result = {};
 		}
 
-		inline void load_impl(std::vector<const_Hypertrie<tr>> operands, Entry_t &entry) {
+		inline void load_impl(Operands<tr> operands, Entry_t &entry) {
 			if constexpr(_debugeinsum_) fmt::print("Cartesian {}\n", this->subscript);
 			this->entry = &entry;
 			ended_ = false;
+			suspended_ = Suspension::none;
 
-			double max_estimated_size = 0;
+			max_estimated_size = 0;
 			iterated_pos = 0;
+			sub_results.clear();
+			sub_result.clear();
+			pending_operands = operands;
 
 			// initialize operands of the Cartesian product
 			if constexpr (_debugeinsum_) fmt::print("Cartesian sub start {}\n", this->subscript);
-			for (auto cart_op_pos : iter::range(sub_operators.size())) {
+			loadSubOperators(0);
+		}
+
+		/**
+		 * Continues at the point where the operator suspended.
+		 */
+		void resume() {
+			const auto pos = suspended_pos;
+			switch (std::exchange(suspended_, Suspension::none)) {
+				case Suspension::loading:
+					sub_operators[pos]->next();
+					if (this->context->yield_requested) {
+						suspended_ = Suspension::loading;
+						return;
+					}
+					if (sub_operators[pos]->ended()) {
+						ended_ = true;
+						return;
+					}
+					loadSubOperators(pos + 1);
+					return;
+				case Suspension::collecting:
+					sub_operators[pos]->next();
+					collectSubResults(pos);
+					return;
+				case Suspension::collecting_self:
+					collectSubResults(pos);
+					return;
+				case Suspension::iterating:
+					sub_operators[iterated_pos]->next();
+					continueIterated();
+					return;
+				case Suspension::none:
+					return;
+			}
+		}
+
+		void loadSubOperators(std::size_t first_pos) {
+			for (auto cart_op_pos : iter::range(first_pos, sub_operators.size())) {
 				auto &cart_op = sub_operators[cart_op_pos];
-				auto sub_operands = extractOperands(cart_op_pos, operands);
-				const double estimated_size = CardinalityEstimation<tr>::estimate(sub_operands, cart_op->getSubscript(), this->context);
+				const auto cart_op_operands = extractOperands(cart_op_pos, pending_operands);
+				const double estimated_size = CardinalityEstimation<tr>::estimate(cart_op_operands, cart_op->getSubscript(), this->context);
 				if (estimated_size > max_estimated_size) {
 					max_estimated_size = estimated_size;
 					iterated_pos = cart_op_pos;
 				}
-				cart_op->load(std::move(sub_operands), sub_entries[cart_op_pos]);
+				cart_op->load(cart_op_operands, sub_entries[cart_op_pos]);
+				if (this->context->yield_requested) {
+					suspended_ = Suspension::loading;
+					suspended_pos = cart_op_pos;
+					return;
+				}
 				if (cart_op->ended()) {
 					ended_ = true;
 					return;
 				}
 			}
+			pending_operands = {};
 
 			if constexpr (_debugeinsum_) fmt::print("Cartesian sub gen {}\n", this->subscript);
-			// calculate results of non-iterated sub_operators
-			std::vector<SubResult> sub_results{};
+			collectSubResults(0);
+		}
+
+		/**
+		 * Calculates the results of the non-iterated sub_operators, starting with the sub_operator at first_pos and its
+		 * results collected so far.
+		 */
+		void collectSubResults(std::size_t first_pos) {
 			// TODO: parallelize
-			for (auto cart_op_pos : iter::range(sub_operators.size())) {
+			for (auto cart_op_pos : iter::range(first_pos, sub_operators.size())) {
 				if (cart_op_pos == iterated_pos)
 					continue;
-				SubResult sub_result{};
 				auto &cart_op = sub_operators[cart_op_pos];
 				if constexpr (bool_value_type) {
 					if (this->subscript->all_result_done) {
@@ -152,11 +238,17 @@ namespace einsum::internal {
 						assert(sub_entry.value);
 						sub_result[sub_entry.key] = sub_entry.value;
 						sub_results.emplace_back(std::move(sub_result));
+						sub_result = {};
 						continue;
 					}
 				}
 				auto &sub_entry = sub_entries[cart_op_pos];
 				while (not cart_op->ended()) {
+					if (this->context->yield_requested) {
+						suspended_ = Suspension::collecting;
+						suspended_pos = cart_op_pos;
+						return;
+					}
 					assert(sub_entry.value);
 					sub_result[sub_entry.key] += sub_entry.value;
 					cart_op->operator++();
@@ -164,16 +256,24 @@ namespace einsum::internal {
 						ended_ = true;
 						return;
 					}
+					// yield only after progress was made, so that resuming does not yield again right away
+					if (not this->context->yield_requested and this->context->shouldYield()) {
+						suspended_ = Suspension::collecting_self;
+						suspended_pos = cart_op_pos;
+						return;
+					}
 				}
 				if (sub_result.empty()) {
 					ended_ = true;
 					return;
 				}
 				sub_results.emplace_back(std::move(sub_result));
+				sub_result = {};
 			}
 			calculated_operands = FullCartesianResult(std::move(sub_results), this->subscript->getCartesianSubscript(),
 													  *this->entry,
 													  iterated_pos);
+			sub_results = {};
 			if constexpr (_debugeinsum_) fmt::print("Cartesian main start {}\n", this->subscript);
 
 			// init iterator for the subscript part that is iterated as results are written out.
@@ -190,6 +290,35 @@ namespace einsum::internal {
 			this->entry->value *= sub_entries[iterated_pos].value;
 		}
 
+		/**
+		 * Called after the iterated sub_operator was forwarded because calculated_operands ended.
+		 */
+		void continueIterated() {
+			auto &intereated_sub_op = sub_operators[iterated_pos];
+			if (this->context->yield_requested) {
+				suspended_ = Suspension::iterating;
+				return;
+			}
+			if (not intereated_sub_op->ended()) {
+				calculated_operands.restart();
+			} else { // if it is ended, set to ended_
+				ended_ = true;
+				return;
+			}
+			writeIteratedEntry();
+		}
+
+		void writeIteratedEntry() {
+			const auto &iterated_sub_entry = sub_entries[iterated_pos];
+			updateEntryKey(iterated_sub_operator_result_mapping, *this->entry, iterated_sub_entry.key);
+			assert(iterated_sub_entry.value);
+			assert(this->entry->value);
+			if constexpr (not bool_value_type)
+				this->entry->value *= iterated_sub_entry.value;
+			if constexpr (_debugeinsum_)
+				fmt::print("[{}]->{} {}\n", fmt::join(this->entry->key, ","), this->entry->value, this->subscript);
+		}
+
 
 		static void
 		updateEntryKey(const OriginalResultPoss &original_result_poss, Entry_t &sink,
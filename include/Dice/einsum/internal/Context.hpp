@@ -3,11 +3,30 @@
 
 #include "Dice/einsum/internal/Subscript.hpp"
 #include <chrono>
+#include <memory_resource>
 
 namespace einsum::internal {
 
 	using TimePoint = std::chrono::steady_clock::time_point;
 
+	/**
+	 * How the operator graph evaluates subscripts of type Join.
+	 */
+	enum struct JoinStrategy {
+		/**
+		 * A JoinOperator binds one label and passes the remaining subscript on to a sub-operator.
+		 */
+		label_at_a_time,
+		/**
+		 * A GenericJoinOperator binds all labels of a join, one after the other, within a single operator.
+		 */
+		generic_join,
+		/**
+		 * generic_join for cyclic subscripts (see Subscript::isCyclic()), e.g. triangles, otherwise label_at_a_time.
+		 */
+		generic_join_if_cyclic
+	};
+
 	/**
 	 * The context is passed to very operator. It helps to pass information into the operator graph and allows the
 	 * operators to communicate during execution.
@@ -21,6 +40,11 @@ namespace einsum::internal {
 		 */
 		TimePoint timeout;
 
+		/**
+		 * The join strategy used by Operator::construct.
+		 */
+		JoinStrategy join_strategy;
+
 		/**
 		 * The time is only checked when counter hits max_counter.
 		 */
@@ -31,7 +55,44 @@ namespace einsum::internal {
 		 */
 		bool timed_out = false;
 
-		Context(TimePoint const &timeout = TimePoint::max()) : timeout(timeout) {}
+		/**
+		 * Number of loop iterations after which JoinOperator and CartesianOperator suspend at a yield point (see
+		 * shouldYield()). 0 disables yielding.
+		 */
+		size_t yield_interval = 0;
+
+		/**
+		 * Loop iterations since the last yield.
+		 */
+		size_t steps_since_yield = 0;
+
+		/**
+		 * Set when an operator suspended at a yield point. The operators return up to the root operator without producing
+		 * an entry, i.e. the current entry is not valid although the root operator has not ended. The caller resets the
+		 * flag and calls next() on the root operator to resume.
+		 */
+		bool yield_requested = false;
+
+		/**
+		 * Per-query arena from which the operators allocate their operand frames (see OperandFrame). The operators hold
+		 * the context, so it outlives all frames. Frames of operators that are replaced are recycled by the pool.
+		 */
+		std::pmr::unsynchronized_pool_resource operand_memory;
+
+		Context(TimePoint const &timeout = TimePoint::max(), JoinStrategy join_strategy = JoinStrategy::label_at_a_time)
+			: timeout(timeout), join_strategy(join_strategy) {}
+
+		/**
+		 * Called by operators in every iteration of a loop that may run long without producing an entry.
+		 * @return if the operator shall suspend. yield_requested is set in that case.
+		 */
+		inline bool shouldYield() {
+			if (this->yield_interval == 0 or ++this->steps_since_yield < this->yield_interval)
+				return false;
+			this->steps_since_yield = 0;
+			this->yield_requested = true;
+			return true;
+		}
 
 		/**
 		 * Checks if the timeout is already reached. This method is intentionally unsynchronized.
@@ -32,12 +32,12 @@ namespace einsum::internal {
 		}
 
 		static void
-		load(void *self_raw, std::vector<const_Hypertrie<tr>> operands, Entry_t &entry) {
+		load(void *self_raw, Operands<tr> operands, Entry_t &entry) {
 			static_cast<CountOperator *>(self_raw)->load_impl(operands, entry);
 		}
 
 	private:
-		inline void load_impl(std::vector<const_Hypertrie<tr>> operands, Entry_t &entry) {
+		inline void load_impl(Operands<tr> operands, Entry_t &entry) {
 			this->entry = &entry;
 			assert(operands.size() == 1);// only one operand must be left to be resolved
 			_ended = operands[0].empty();
@@ -7,6 +7,7 @@
 #include "Dice/einsum/internal/Operator.hpp"
 #include "Dice/einsum/internal/CartesianOperator.hpp"
 #include "Dice/einsum/internal/JoinOperator.hpp"
+#include "Dice/einsum/internal/GenericJoinOperator.hpp"
 #include "Dice/einsum/internal/ResolveOperator.hpp"
 #include "Dice/einsum/internal/CountOperator.hpp"
 #include "Dice/einsum/internal/EntryGeneratorOperator.hpp"
@@ -20,6 +21,9 @@ namespace einsum::internal {
 																	   const std::shared_ptr<Context> &context) {
 		switch (subscript->type) {
 			case Subscript::Type::Join:
+				if (context->join_strategy == JoinStrategy::generic_join or
+					(context->join_strategy == JoinStrategy::generic_join_if_cyclic and subscript->isCyclic()))
+					return std::make_shared<GenericJoinOperator<value_type, tr>>(subscript, context);
 				return std::make_shared<JoinOperator<value_type, tr>>(subscript, context);
 			case Subscript::Type::Resolve:
 				return std::make_shared<ResolveOperator<value_type, tr>>(subscript, context);
@@ -55,8 +59,8 @@ namespace einsum::internal {
 		Einsum() = default;
 
 		Einsum(std::shared_ptr<Subscript> subscript, const std::vector<const_Hypertrie<tr>> &operands,
-			   TimePoint timeout = TimePoint::max())
-			: subscript(std::move(subscript)), context{std::make_shared<Context>(timeout)},
+			   TimePoint timeout = TimePoint::max(), JoinStrategy join_strategy = JoinStrategy::label_at_a_time)
+			: subscript(std::move(subscript)), context{std::make_shared<Context>(timeout, join_strategy)},
 			  operands(operands),
 			  op{Operator_t::construct(this->subscript, context)},
 			  entry(this->subscript->resultLabelCount(), Operator_t::default_key_part) {}
@@ -136,8 +140,8 @@ namespace einsum::internal {
 
 	public:
 		Einsum(std::shared_ptr<Subscript> subscript, const std::vector<const_Hypertrie<tr>> &operands,
-			   TimePoint timeout = std::numeric_limits<TimePoint>::max())
-			: subscript(std::move(subscript)), context{std::make_shared<Context>(timeout)},
+			   TimePoint timeout = std::numeric_limits<TimePoint>::max(), JoinStrategy join_strategy = JoinStrategy::label_at_a_time)
+			: subscript(std::move(subscript)), context{std::make_shared<Context>(timeout, join_strategy)},
 			  operands(operands),
 			  op{Operator_t::construct(this->subscript, context)},
 			  entry(this->subscript->resultLabelCount(), Operator_t::default_key_part) {}
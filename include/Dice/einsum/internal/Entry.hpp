@@ -16,6 +16,7 @@ constexpr bool _debugeinsum_ = false;
 #include "Dice/hypertrie/hypertrie.hpp"
 #include <Dice/hypertrie/internal/Hypertrie.hpp>
 #include <boost/container_hash/hash.hpp>
+#include <span>
 #include <type_traits>
 
 
@@ -53,9 +54,19 @@ namespace einsum::internal {
 			init(key_size, default_key_part);
 		}
 
+		/**
+		 * Resets the entry. The key reuses its buffer, so re-initializing an entry does not allocate.
+		 */
 		void init(const size_t key_size, const key_part_type default_key_part) noexcept {
 			value = value_type_t(0);
-			key = Key(key_size, default_key_part);
+			key.assign(key_size, default_key_part);
+		}
+
+		/**
+		 * The key as a non-owning view, e.g. to look it up in a const_Hypertrie without copying.
+		 */
+		[[nodiscard]] std::span<const key_part_type> keyView() const noexcept {
+			return {key.data(), key.size()};
 		}
 
 		void clear(const key_part_type default_key_part) noexcept {
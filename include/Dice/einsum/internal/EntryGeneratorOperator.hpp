@@ -31,12 +31,12 @@ namespace einsum::internal {
 			//
 		}
 
-		static void load(void *self_raw, std::vector<const_Hypertrie<tr>> operands, Entry_t &entry) {
-			static_cast<EntryGeneratorOperator *>(self_raw)->load_impl(std::move(operands), entry);
+		static void load(void *self_raw, Operands<tr> operands, Entry_t &entry) {
+			static_cast<EntryGeneratorOperator *>(self_raw)->load_impl(operands, entry);
 		}
 
 	private:
-		inline void load_impl([[maybe_unused]]std::vector<const_Hypertrie<tr>> operands,
+		inline void load_impl([[maybe_unused]]Operands<tr> operands,
 							  Entry_t &entry) {
 			assert(operands.size() == 0); // no operand must be left
 			if constexpr(_debugeinsum_) fmt::print("EntryGen {}\n", this->subscript);
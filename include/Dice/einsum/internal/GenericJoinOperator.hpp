@@ -0,0 +1,292 @@
+#ifndef HYPERTRIE_GENERICJOINOPERATOR_HPP
+#define HYPERTRIE_GENERICJOINOPERATOR_HPP
+
+#include <algorithm>
+#include <optional>
+
+#include "Dice/einsum/internal/Operator.hpp"
+#include <Dice/hypertrie/internal/HashJoin.hpp>
+
+namespace einsum::internal {
+
+	/**
+	 * Worst-case optimal join of a subscript of type Join. Where JoinOperator binds one label and constructs a
+	 * sub-operator for the remaining subscript, the GenericJoinOperator binds a whole sequence of labels itself: every
+	 * label is a level with a HashJoin iterator that is reloaded with the operands of the level above. Only the subscript
+	 * that is left when no label needs to be joined anymore (Cartesian, Resolve, Count or EntryGenerator) is evaluated by
+	 * a sub-operator.
+	 *
+	 * The label order is chosen when the operator is loaded. Labels with a small estimated cardinality come first, but
+	 * labels that share an operand with an already bound label are preferred, so that every level intersects.
+	 */
+	template<typename value_type, HypertrieTrait tr_t>
+	class GenericJoinOperator : public Operator<value_type, tr_t> {
+#include "Dice/einsum/internal/OperatorMemberTypealiases.hpp"
+
+		using Join_t = hypertrie::HashJoin<tr>;
+		using GenericJoinOperator_t = GenericJoinOperator<value_type, tr>;
+
+		struct Level {
+			Label label = std::numeric_limits<Label>::max();
+			/**
+			 * The subscript of the operands that are joined at this level.
+			 */
+			std::shared_ptr<Subscript> subscript;
+			LabelPossInOperands label_poss_in_ops;
+			bool is_result_label = false;
+			LabelPos label_pos_in_result = 0;
+			/**
+			 * Its operands() are the operands of the next level or of sub_operator.
+			 */
+			typename Join_t::iterator join_iter;
+
+			explicit Level(std::pmr::memory_resource *memory) : join_iter(memory) {}
+		};
+
+		std::vector<Level> levels;
+		// number of levels of the current plan. levels may hold more, so that their buffers are reused.
+		std::size_t level_count = 0;
+		/**
+		 * The level that next() forwards. If it is level_count, sub_operator is forwarded. Only for value_type bool
+		 * it can be smaller: after all result labels are bound, a single entry per binding suffices.
+		 */
+		std::size_t forwarded_level = 0;
+
+		std::vector<std::pair<Label, double>> label_cards;
+		std::vector<Label> bound_labels;
+
+		std::shared_ptr<Operator_t> sub_operator;
+
+		bool ended_ = true;
+
+		enum struct Suspension {
+			none,
+			/**
+			 * suspended at the yield point in find_next_valid() at suspended_level
+			 */
+			self,
+			/**
+			 * sub_operator suspended, its entry is not valid
+			 */
+			sub_operator
+		};
+		Suspension suspended_ = Suspension::none;
+		std::size_t suspended_level = 0;
+
+	public:
+		GenericJoinOperator(const std::shared_ptr<Subscript> &subscript, const std::shared_ptr<Context> &context)
+				: Operator_t(Subscript::Type::Join, subscript, context, this) {}
+
+		static void next(void *self_raw) {
+			auto &self = *static_cast<GenericJoinOperator *>(self_raw);
+			switch (std::exchange(self.suspended_, Suspension::none)) {
+				case Suspension::self:
+					self.find_next_valid(self.suspended_level);
+					return;
+				case Suspension::sub_operator:
+					self.sub_operator->next();
+					self.continue_sub_operator();
+					return;
+				case Suspension::none:
+					break;
+			}
+			if constexpr (bool_value_type) {
+				if (self.subscript->all_result_done) {
+					self.ended_ = true;
+					return;
+				}
+			}
+			if (self.forwarded_level == self.level_count) {
+				self.sub_operator->next();
+				self.continue_sub_operator();
+			} else {
+				++self.levels[self.forwarded_level].join_iter;
+				self.find_next_valid(self.forwarded_level);
+			}
+		}
+
+		static bool ended(const void *self_raw) {
+			auto &self = *static_cast<const GenericJoinOperator *>(self_raw);
+			return self.ended_ or self.context->hasTimedOut();
+		}
+
+		static void clear(void *self_raw) {
+			return static_cast<GenericJoinOperator_t *>(self_raw)->clear_impl();
+		}
+
+		static void
+		load(void *self_raw, Operands<tr> operands, Entry_t &entry) {
+			static_cast<GenericJoinOperator *>(self_raw)->load_impl(operands, entry);
+		}
+
+	private:
+		/**
+		 * Finds the next binding of all levels for which sub_operator has an entry, depth-first. The iterator of level was
+		 * just loaded or forwarded. Finally, the key parts are written to entry.
+		 * If this operator or sub_operator suspends at a yield point, suspended_ is set and the search is continued by the
+		 * next call of next().
+		 */
+		void find_next_valid(std::size_t level) {
+			while (true) {
+				auto &join_iter = levels[level].join_iter;
+				if (not join_iter or this->context->hasTimedOut()) {
+					if (level == 0) {
+						ended_ = true;
+						return;
+					}
+					--level;
+					++levels[level].join_iter;
+				} else if (level + 1 < level_count) {
+					++level;
+					levels[level].join_iter.load(join_iter.operands(), levels[level].label_poss_in_ops);
+				} else {
+					sub_operator->load(join_iter.operands(), *this->entry);
+					if (this->context->yield_requested) {
+						suspended_ = Suspension::sub_operator;
+						return;
+					}
+					if (not sub_operator->ended()) {
+						write_key_parts();
+						return;
+					}
+					++join_iter;
+				}
+				// yield only after progress was made, so that resuming does not yield again right away
+				if (this->context->shouldYield()) {
+					suspended_ = Suspension::self;
+					suspended_level = level;
+					return;
+				}
+			}
+		}
+
+		/**
+		 * Called after sub_operator was forwarded.
+		 */
+		void continue_sub_operator() {
+			if (this->context->yield_requested) {
+				suspended_ = Suspension::sub_operator;
+				return;
+			}
+			if (sub_operator->ended()) {
+				const std::size_t last_level = level_count - 1;
+				++levels[last_level].join_iter;
+				find_next_valid(last_level);
+				return;
+			}
+			write_key_parts();
+		}
+
+		void write_key_parts() {
+			// sub_operator may have cleared the entry when it was loaded
+			for (std::size_t i = 0; i < level_count; ++i)
+				if (const auto &level = levels[i]; level.is_result_label)
+					this->entry->key[level.label_pos_in_result] = level.join_iter.keyPart();
+
+			if constexpr (_debugeinsum_)
+				fmt::print("[{}]->{} {}\n", fmt::join(this->entry->key, ","), this->entry->value, this->subscript);
+		}
+
+		/**
+		 * @return if label shares an operand with a bound label
+		 */
+		bool is_connected_to_bound_labels(Label label) const {
+			for (const auto &operand : this->subscript->getRawSubscript().operands) {
+				if (std::find(operand.begin(), operand.end(), label) == operand.end())
+					continue;
+				for (const Label bound_label : bound_labels)
+					if (std::find(operand.begin(), operand.end(), bound_label) != operand.end())
+						return true;
+			}
+			return false;
+		}
+
+		/**
+		 * Chooses the label that is bound next for the operands of level_subscript.
+		 */
+		Label next_label(const Subscript &level_subscript) const {
+			const auto &operands_label_set = level_subscript.getOperandsLabelSet();
+			const auto &lonely_non_result_labels = level_subscript.getLonelyNonResultLabelSet();
+			std::optional<Label> first_candidate;
+			// label_cards is ordered by cardinality
+			for (const auto &[label, card] : label_cards) {
+				if (not operands_label_set.count(label) or lonely_non_result_labels.count(label))
+					continue;
+				if (bound_labels.empty() or is_connected_to_bound_labels(label))
+					return label;
+				if (not first_candidate)
+					first_candidate = label;
+			}
+			if (first_candidate)
+				return *first_candidate;
+			return *operands_label_set.begin();
+		}
+
+		/**
+		 * Chooses the order in which the labels are bound and prepares a level for each of them.
+		 */
+		void plan(Operands<tr> operands) {
+			label_cards.clear();
+			for (const Label label : this->subscript->getOperandsLabelSet())
+				label_cards.emplace_back(label, CardinalityEstimation_t::estimateLabel(operands, label, this->subscript));
+			std::sort(label_cards.begin(), label_cards.end(), [](const auto &left, const auto &right) {
+				return std::tie(left.second, left.first) < std::tie(right.second, right.first);
+			});
+
+			bound_labels.clear();
+			level_count = 0;
+			std::shared_ptr<Subscript> level_subscript = this->subscript;
+			while (level_subscript->type == Subscript::Type::Join) {
+				const Label label = next_label(*level_subscript);
+				if (levels.size() == level_count)
+					levels.emplace_back(&this->context->operand_memory);
+				auto &level = levels[level_count++];
+				if (level.subscript != level_subscript or level.label != label) {
+					level.subscript = level_subscript;
+					level.label = label;
+					level.label_poss_in_ops = level_subscript->getLabelPossInOperands(label);
+					level.is_result_label = this->subscript->isResultLabel(label);
+					if (level.is_result_label)
+						level.label_pos_in_result = this->subscript->getLabelPosInResult(label);
+				}
+				bound_labels.push_back(label);
+				level_subscript = level_subscript->removeLabel(label);
+			}
+			// check if sub_operator was not yet initialized or if the remaining subscript is different
+			if (not sub_operator or sub_operator->hash() != level_subscript->hash())
+				sub_operator = Operator_t::construct(level_subscript, this->context);
+
+			forwarded_level = level_count;
+			if constexpr (bool_value_type) {
+				for (std::size_t level = 1; level < level_count; ++level) {
+					if (levels[level].subscript->all_result_done) {
+						forwarded_level = level - 1;
+						break;
+					}
+				}
+				if (forwarded_level == level_count and level_subscript->all_result_done)
+					forwarded_level = level_count - 1;
+			}
+		}
+
+		inline void clear_impl() {
+			if (this->sub_operator)
+				this->sub_operator->clear();
+			for (auto &level : levels)
+				level.join_iter.clear();
+			this->suspended_ = Suspension::none;
+		}
+
+		inline void load_impl(Operands<tr> operands, Entry_t &entry) {
+			if constexpr (_debugeinsum_) fmt::print("GenericJoin {}\n", this->subscript);
+
+			this->entry = &entry;
+			ended_ = false;
+			suspended_ = Suspension::none;
+			plan(operands);
+			levels[0].join_iter.load(operands, levels[0].label_poss_in_ops);
+			find_next_valid(0);
+		}
+	};
+}// namespace einsum::internal
+#endif//HYPERTRIE_GENERICJOINOPERATOR_HPP
@@ -13,7 +13,10 @@ namespace einsum::internal {
 		using Join_t = hypertrie::HashJoin<tr>;
 		using JoinOperator_t = JoinOperator<value_type, tr>;
 
-		Join_t join;
+		/**
+		 * Loaded with the operands of every binding of the parent operator. Its operands() are the frame that
+		 * is passed on to sub_operator.
+		 */
 		typename Join_t::iterator join_iter;
 		bool is_result_label = false;
 		LabelPossInOperands label_poss_in_ops;
@@ -25,13 +28,33 @@ namespace einsum::internal {
 
 		bool ended_ = true;
 
+		enum struct Suspension {
+			none,
+			/**
+			 * suspended at the yield point in find_next_valid()
+			 */
+			self,
+			/**
+			 * sub_operator suspended, its entry is not valid
+			 */
+			sub_operator
+		};
+		Suspension suspended_ = Suspension::none;
+
 	public:
 		JoinOperator(const std::shared_ptr<Subscript> &subscript, const std::shared_ptr<Context> &context)
-				: Operator_t(Subscript::Type::Join, subscript, context, this) {}
+				: Operator_t(Subscript::Type::Join, subscript, context, this),
+				  join_iter(&this->context->operand_memory) {}
 
 
 		static void next(void *self_raw) {
 			JoinOperator &self = *static_cast<JoinOperator *>(self_raw);
+			if (self.suspended_ != Suspension::none) {
+				if (std::exchange(self.suspended_, Suspension::none) == Suspension::sub_operator)
+					self.sub_operator->next();
+				self.find_next_valid();
+				return;
+			}
 			if constexpr (bool_value_type) {
 				if (self.subscript->all_result_done) {
 					assert(self.sub_operator);
@@ -50,19 +73,29 @@ namespace einsum::internal {
 		 * - If sub_operator has already a valid entry, it is not incremented.
 		 * - If sub_operator has ended, join_iter is increased until either a valid sub_operator entry is found or join_iter is ended
 		 * Finally, results are written to entry.
+		 * If this operator or sub_operator suspends at a yield point, suspended_ is set and the search is continued by the
+		 * next call of next().
 		 */
 		void find_next_valid() {
 			assert(join_iter);
 			while (sub_operator->ended()) {
 				++join_iter;
 				if (join_iter and not this->context->hasTimedOut()) {
-					std::vector<const_Hypertrie<tr>> next_operands;
-					std::tie(next_operands, current_key_part) = *join_iter;
-					sub_operator->load(std::move(next_operands), *this->entry);
+					current_key_part = join_iter.keyPart();
+					sub_operator->load(join_iter.operands(), *this->entry);
 				} else {
 					ended_ = true;
 					return;
 				}
+				// yield only after progress was made, so that resuming does not yield again right away
+				if (not this->context->yield_requested and this->context->shouldYield()) {
+					suspended_ = Suspension::self;
+					return;
+				}
+			}
+			if (this->context->yield_requested) {
+				suspended_ = Suspension::sub_operator;
+				return;
 			}
 			if (is_result_label)
 				this->entry->key[label_pos_in_result] = current_key_part;
@@ -82,23 +115,24 @@ namespace einsum::internal {
 		}
 
 		static void
-		load(void *self_raw, std::vector<const_Hypertrie<tr>> operands, Entry_t &entry) {
-			static_cast<JoinOperator *>(self_raw)->load_impl(std::move(operands), entry);
+		load(void *self_raw, Operands<tr> operands, Entry_t &entry) {
+			static_cast<JoinOperator *>(self_raw)->load_impl(operands, entry);
 		}
 
 	private:
 		inline void clear_impl(){
 			if (this->sub_operator)
 				this->sub_operator->clear();
-			this->join = {};
-			this->join_iter = {};
+			this->join_iter.clear();
+			this->suspended_ = Suspension::none;
 		}
 
-		inline void load_impl(std::vector<const_Hypertrie<tr>> operands, Entry_t &entry) {
+		inline void load_impl(Operands<tr> operands, Entry_t &entry) {
 			if constexpr (_debugeinsum_) fmt::print("Join {}\n", this->subscript);
 
 			this->entry = &entry;
 			ended_ = false;
+			suspended_ = Suspension::none;
 			Label last_label = label;
 			label = CardinalityEstimation_t::getMinCardLabel(operands, this->subscript, this->context);
 			if (label != last_label) {
@@ -114,14 +148,12 @@ namespace einsum::internal {
 			}
 
 			// initialize the join
-			join = Join_t{operands, label_poss_in_ops};
-			join_iter = join.begin();
+			join_iter.load(operands, label_poss_in_ops);
 			// check if join has entries
 			if (join_iter) {
-				std::vector<const_Hypertrie<tr>> next_operands;
-				std::tie(next_operands, current_key_part) = *join_iter;
+				current_key_part = join_iter.keyPart();
 				// initialize the next sub_operator
-				sub_operator->load(std::move(next_operands), *this->entry);
+				sub_operator->load(join_iter.operands(), *this->entry);
 				find_next_valid();
 			} else {
 				this->ended_ = true;
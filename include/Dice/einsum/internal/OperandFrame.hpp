@@ -0,0 +1,30 @@
+#ifndef HYPERTRIE_OPERANDFRAME_HPP
+#define HYPERTRIE_OPERANDFRAME_HPP
+
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+#include "Dice/einsum/internal/Context.hpp"
+#include "Dice/einsum/internal/Entry.hpp"
+
+namespace einsum::internal {
+
+	/**
+	 * View on the operands that are loaded into an operator. The operands are owned by the OperandFrame of the parent
+	 * operator (or by the Einsum for the root operator). The parent does not change the frame before the operator is
+	 * loaded again, so the view stays valid for as long as the operator is loaded.
+	 */
+	template<HypertrieTrait tr>
+	using Operands = std::span<const const_Hypertrie<tr>>;
+
+	/**
+	 * Operands that an operator passes on to a sub-operator. A frame is allocated from the query's
+	 * Context::operand_memory once per operator and refilled for every binding, so that its capacity is reused.
+	 */
+	template<HypertrieTrait tr>
+	using OperandFrame = std::pmr::vector<const_Hypertrie<tr>>;
+
+}// namespace einsum::internal
+
+#endif//HYPERTRIE_OPERANDFRAME_HPP
@@ -7,6 +7,7 @@
 #include "Dice/einsum/internal/Subscript.hpp"
 #include "Dice/einsum/internal/Context.hpp"
 #include "Dice/einsum/internal/CardinalityEstimation.hpp"
+#include "Dice/einsum/internal/OperandFrame.hpp"
 
 namespace einsum::internal {
 
@@ -49,9 +50,9 @@ namespace einsum::internal {
 		/**
 		 * Pointer to the load Function of the operator implementation.
 		 * @param self actual operator instance
-		 * @param operands operands to be loaded
+		 * @param operands view on the operands to be loaded. They must stay valid while the operator is loaded.
 		 */
-		void (*load_fp)(void *self, std::vector<const_Hypertrie<tr>> operands,
+		void (*load_fp)(void *self, Operands<tr> operands,
 						Entry<value_type, tr> &entry);
 
 		void (*clear_fp)(void *self);
@@ -114,9 +115,9 @@ namespace einsum::internal {
 
 		bool end() { return false; }
 
-		void load(std::vector<const_Hypertrie<tr>> operands,
+		void load(Operands<tr> operands,
 				  Entry<value_type, tr> &entry) {
-			load_fp(this, std::move(operands), entry);
+			load_fp(this, operands, entry);
 		}
 
 		std::size_t hash() const { return subscript->hash(); }
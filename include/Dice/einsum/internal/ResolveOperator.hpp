@@ -54,13 +54,13 @@ namespace einsum::internal {
 		}
 
 		static void
-		load(void *self_raw, std::vector<const_Hypertrie<tr>> operands, Entry_t &entry) {
+		load(void *self_raw, Operands<tr> operands, Entry_t &entry) {
 			auto &self = *static_cast<ResolveOperator *>(self_raw);
-			self.load_impl(std::move(operands), entry);
+			self.load_impl(operands, entry);
 		}
 
 	private:
-		inline void load_impl(std::vector<const_Hypertrie<tr>> operands, Entry_t &entry) {
+		inline void load_impl(Operands<tr> operands, Entry_t &entry) {
 			// TODO: do I need to preserve the operand here?
 			if constexpr(_debugeinsum_) fmt::print("Resolve {}\n", this->subscript);
 			this->entry = &entry;
@@ -0,0 +1,217 @@
+#ifndef HYPERTRIE_SHARDEDEINSUM_HPP
+#define HYPERTRIE_SHARDEDEINSUM_HPP
+
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <tsl/sparse_set.h>
+
+#include "Dice/einsum/internal/Einsum.hpp"
+#include "Dice/hypertrie/internal/ShardedHypertrie.hpp"
+
+namespace einsum::internal {
+
+	/**
+	 * An einsum operand that is either a single hypertrie or the shards of a ShardedHypertrie.
+	 */
+	template<HypertrieTrait tr>
+	class ShardedOperand {
+		std::vector<const_Hypertrie<tr>> shards_;
+		std::optional<hypertrie::pos_type> shard_pos_;
+
+	public:
+		ShardedOperand(const const_Hypertrie<tr> &hypertrie) : shards_{hypertrie} {}
+
+		ShardedOperand(const hypertrie::ShardedHypertrie<tr> &hypertrie)
+			: shards_(hypertrie.shards()), shard_pos_(hypertrie.shardPos()) {}
+
+		[[nodiscard]] bool sharded() const noexcept { return shard_pos_.has_value(); }
+
+		/**
+		 * @return the position by which the operand is sharded. Requires sharded().
+		 */
+		[[nodiscard]] hypertrie::pos_type shardPos() const noexcept { return *shard_pos_; }
+
+		[[nodiscard]] const std::vector<const_Hypertrie<tr>> &shards() const noexcept { return shards_; }
+	};
+
+	/**
+	 * Evaluates einsum over operands of which some are ShardedHypertries.
+	 *
+	 * The sharded operands must be co-partitioned: they have the same number of shards and the same label at their shard
+	 * positions. Entries of co-partitioned operands only meet in shards with the same index, so einsum over the operands
+	 * is the sum of N einsums, the i-th of which is over the i-th shards and the unsharded operands. The N shard
+	 * combinations are independent and can be evaluated in parallel (see sharded_einsum2map()).
+	 *
+	 * Operands that are sharded by different labels or into different numbers of shards are rejected: shards of them
+	 * meet in every combination, which would cost N^k einsums for k such operands.
+	 *
+	 * The iterator behaves like Einsum::iterator: for value_type bool, every key is yielded once; otherwise, the values of
+	 * entries with equal keys must be summed.
+	 */
+	template<typename value_type, HypertrieTrait tr_t>
+	class ShardedEinsum {
+	public:
+		using tr = tr_t;
+		using Einsum_t = Einsum<value_type, tr>;
+		using Entry_t = Entry<value_type, tr>;
+		using Operands = std::vector<const_Hypertrie<tr>>;
+
+	private:
+		std::shared_ptr<Subscript> subscript;
+		TimePoint timeout;
+		std::vector<Operands> combinations;
+
+		size_t next_combination = 0;
+		std::unique_ptr<Einsum_t> current_einsum{};
+		typename Einsum_t::iterator current_iter{};
+		bool ended_ = true;
+		tsl::sparse_set<size_t, std::identity> found_entries{};
+
+	public:
+		ShardedEinsum(std::shared_ptr<Subscript> subscript, const std::vector<ShardedOperand<tr>> &operands,
+					  TimePoint timeout = TimePoint::max())
+			: subscript(std::move(subscript)), timeout(timeout),
+			  combinations(combine(*this->subscript, operands)) {}
+
+		/**
+		 * Computes the operand combinations of which the results sum up to the result of the sharded einsum: the i-th
+		 * combination consists of the i-th shards of the sharded operands and the unsharded operands.
+		 * Combinations with an empty operand are left out.
+		 * @param subscript the subscript
+		 * @param operands the operands
+		 * @return the combinations
+		 * @throws std::invalid_argument if the sharded operands are not co-partitioned
+		 */
+		static std::vector<Operands> combine(const Subscript &subscript, const std::vector<ShardedOperand<tr>> &operands) {
+			std::optional<Label> shard_label;
+			size_t shard_count = 1;
+			for (const auto &[op_pos, operand] : iter::enumerate(operands)) {
+				if (not operand.sharded())
+					continue;
+				const Label label = subscript.getOperandLabels(op_pos)[operand.shardPos()];
+				if (not shard_label) {
+					shard_label = label;
+					shard_count = operand.shards().size();
+				} else if (label != *shard_label or operand.shards().size() != shard_count) {
+					throw std::invalid_argument{"the sharded operands of a ShardedEinsum must be co-partitioned: "
+												"sharded into the same number of shards by the same label."};
+				}
+			}
+
+			std::vector<Operands> combinations;
+			combinations.reserve(shard_count);
+			for (size_t shard_index = 0; shard_index < shard_count; ++shard_index) {
+				Operands combined;
+				combined.reserve(operands.size());
+				bool empty = false;
+				for (const auto &operand : operands) {
+					const auto &shard = (operand.sharded()) ? operand.shards()[shard_index] : operand.shards().front();
+					if (shard.empty()) {
+						empty = true;
+						break;
+					}
+					combined.push_back(shard);
+				}
+				if (not empty)
+					combinations.emplace_back(std::move(combined));
+			}
+			return combinations;
+		}
+
+		[[nodiscard]] const std::shared_ptr<Subscript> &getSubscript() const {
+			return subscript;
+		}
+
+		[[nodiscard]] const std::vector<Operands> &getCombinations() const {
+			return combinations;
+		}
+
+		struct iterator {
+		private:
+			ShardedEinsum *einsum;
+
+		public:
+			iterator() = default;
+
+			explicit iterator(ShardedEinsum &einsum) : einsum(&einsum) {}
+
+			iterator &operator++() {
+				einsum->forward();
+				return *this;
+			}
+
+			inline const Entry_t &operator*() {
+				return *einsum->current_iter;
+			}
+
+			inline const Entry_t &value() {
+				return *einsum->current_iter;
+			}
+
+			operator bool() const {
+				return not einsum->ended_;
+			}
+
+			[[nodiscard]] inline bool ended() const { return einsum->ended_; }
+		};
+
+		iterator begin() {
+			next_combination = 0;
+			current_einsum.reset();
+			found_entries.clear();
+			ended_ = false;
+			seek();
+			return iterator{*this};
+		}
+
+		[[nodiscard]] bool end() const {
+			return false;
+		}
+
+	private:
+		void forward() {
+			++current_iter;
+			seek();
+		}
+
+		/**
+		 * Moves to the next entry that is to be yielded, starting at the current one.
+		 */
+		void seek() {
+			while (true) {
+				while (current_einsum and current_iter) {
+					if (isNew(*current_iter))
+						return;
+					++current_iter;
+				}
+				if (next_combination == combinations.size()) {
+					ended_ = true;
+					current_einsum.reset();
+					return;
+				}
+				current_einsum = std::make_unique<Einsum_t>(subscript, combinations[next_combination++], timeout);
+				current_iter = current_einsum->begin();
+			}
+		}
+
+		/**
+		 * Einsum<bool> yields every key once per combination, keys yielded by earlier combinations are skipped.
+		 */
+		bool isNew(const Entry_t &entry) {
+			if constexpr (std::is_same_v<value_type, bool>) {
+				if (combinations.size() == 1)
+					return true;
+				return found_entries.insert(Dice::hash::dice_hash(entry.key)).second;
+			} else {
+				return true;
+			}
+		}
+	};
+
+}// namespace einsum::internal
+
+#endif//HYPERTRIE_SHARDEDEINSUM_HPP
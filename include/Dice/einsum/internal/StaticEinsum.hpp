@@ -0,0 +1,366 @@
+#ifndef HYPERTRIE_STATICEINSUM_HPP
+#define HYPERTRIE_STATICEINSUM_HPP
+
+#include <array>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <tsl/sparse_set.h>
+
+#include "Dice/einsum/internal/Entry.hpp"
+#include <Dice/hypertrie/internal/HashDiagonal.hpp>
+
+namespace einsum::internal {
+
+	/**
+	 * A subscript string that is passed as template argument, e.g. StaticEinsum<"ab,bc->ac">.
+	 */
+	template<std::size_t N>
+	struct SubscriptLiteral {
+		std::array<char, N> chars{};
+
+		constexpr SubscriptLiteral(const char (&str)[N]) {
+			for (std::size_t i = 0; i < N; ++i)
+				chars[i] = str[i];
+		}
+	};
+
+	/**
+	 * The evaluation plan of a subscript that is known at compile time. Every label that must be joined or is in the
+	 * result is bound by a level. Labels that occur only once and not in the result are not bound; the operands that
+	 * hold them contribute their size to the value instead.
+	 *
+	 * The order of the levels is chosen without cardinalities: labels that occur in most operands come first, and labels
+	 * that share an operand with a bound label are preferred.
+	 * @tparam capacity upper bound for the number of operands, labels and levels
+	 */
+	template<std::size_t capacity>
+	struct StaticEinsumPlan {
+		static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+		std::size_t operand_count = 0;
+		std::array<std::array<char, capacity>, capacity> operand_labels{};
+		std::array<std::size_t, capacity> operand_depths{};
+		std::array<char, capacity> result{};
+		std::size_t result_depth = 0;
+
+		std::array<char, capacity> levels{};
+		std::size_t level_count = 0;
+		// [level][operand]: positions of the level's label in the operand's key that is left when the level is reached
+		std::array<std::array<std::array<hypertrie::pos_type, capacity>, capacity>, capacity> label_poss{};
+		// [level][operand]: number of label_poss. 0 if the operand does not hold the label.
+		std::array<std::array<std::size_t, capacity>, capacity> label_pos_counts{};
+		// [level][operand]: depth of the operand after the level
+		std::array<std::array<std::size_t, capacity>, capacity> remaining_depths{};
+		// [level]: position of the level's label in the result or npos
+		std::array<std::size_t, capacity> result_poss{};
+		// [operand]: if the operand has unbound labels left after the last level, its size is a factor of the value
+		std::array<bool, capacity> counted{};
+		// no level at or after this one binds a result label
+		std::size_t result_bound_level = 0;
+		// for value_type bool, the same result key may be produced by different bindings of non-result labels
+		bool needs_deduplication = false;
+
+		[[nodiscard]] constexpr std::size_t occurrences(std::size_t operand, char label) const {
+			std::size_t count = 0;
+			for (std::size_t pos = 0; pos < operand_depths[operand]; ++pos)
+				count += operand_labels[operand][pos] == label;
+			return count;
+		}
+
+		[[nodiscard]] constexpr std::size_t operandsWith(char label) const {
+			std::size_t count = 0;
+			for (std::size_t operand = 0; operand < operand_count; ++operand)
+				count += occurrences(operand, label) > 0;
+			return count;
+		}
+
+		[[nodiscard]] constexpr bool isResultLabel(char label) const {
+			for (std::size_t pos = 0; pos < result_depth; ++pos)
+				if (result[pos] == label)
+					return true;
+			return false;
+		}
+
+		[[nodiscard]] constexpr bool isBound(char label) const {
+			for (std::size_t level = 0; level < level_count; ++level)
+				if (levels[level] == label)
+					return true;
+			return false;
+		}
+
+		[[nodiscard]] constexpr bool isConnectedToBound(char label) const {
+			for (std::size_t operand = 0; operand < operand_count; ++operand) {
+				if (occurrences(operand, label) == 0)
+					continue;
+				for (std::size_t level = 0; level < level_count; ++level)
+					if (occurrences(operand, levels[level]) > 0)
+						return true;
+			}
+			return false;
+		}
+
+		/**
+		 * @return if a label must be bound by a level
+		 */
+		[[nodiscard]] constexpr bool needsLevel(char label) const {
+			if (isResultLabel(label) or operandsWith(label) > 1)
+				return true;
+			for (std::size_t operand = 0; operand < operand_count; ++operand)
+				if (occurrences(operand, label) > 1)
+					return true;
+			return false;
+		}
+
+		/**
+		 * @return the label that is bound next or 0 if no label is left
+		 */
+		[[nodiscard]] constexpr char nextLabel() const {
+			char best = 0;
+			bool best_connected = false;
+			std::size_t best_score = 0;
+			for (std::size_t operand = 0; operand < operand_count; ++operand) {
+				for (std::size_t pos = 0; pos < operand_depths[operand]; ++pos) {
+					const char label = operand_labels[operand][pos];
+					if (isBound(label) or not needsLevel(label))
+						continue;
+					const bool connected = isConnectedToBound(label);
+					const std::size_t score = operandsWith(label);
+					if (best == 0 or (connected and not best_connected) or
+						(connected == best_connected and score > best_score)) {
+						best = label;
+						best_connected = connected;
+						best_score = score;
+					}
+				}
+			}
+			return best;
+		}
+
+		template<std::size_t N>
+		static constexpr StaticEinsumPlan parse(const SubscriptLiteral<N> &literal) {
+			StaticEinsumPlan plan;
+			std::size_t i = 0;
+			for (; literal.chars[i] != '-'; ++i) {
+				if (literal.chars[i] == ',') {
+					++plan.operand_count;
+					continue;
+				}
+				auto &depth = plan.operand_depths[plan.operand_count];
+				plan.operand_labels[plan.operand_count][depth++] = literal.chars[i];
+			}
+			++plan.operand_count;
+			for (i += 2; literal.chars[i] != '\0'; ++i)
+				plan.result[plan.result_depth++] = literal.chars[i];
+
+			// the remaining labels of each operand while the levels are bound
+			auto remaining = plan.operand_labels;
+			auto remaining_depths = plan.operand_depths;
+			for (char label = plan.nextLabel(); label != 0; label = plan.nextLabel()) {
+				const std::size_t level = plan.level_count++;
+				plan.levels[level] = label;
+				plan.result_poss[level] = npos;
+				for (std::size_t pos = 0; pos < plan.result_depth; ++pos)
+					if (plan.result[pos] == label)
+						plan.result_poss[level] = pos;
+				for (std::size_t operand = 0; operand < plan.operand_count; ++operand) {
+					std::size_t kept = 0;
+					for (std::size_t pos = 0; pos < remaining_depths[operand]; ++pos) {
+						if (remaining[operand][pos] == label)
+							plan.label_poss[level][operand][plan.label_pos_counts[level][operand]++] = hypertrie::pos_type(pos);
+						else
+							remaining[operand][kept++] = remaining[operand][pos];
+					}
+					remaining_depths[operand] = kept;
+					plan.remaining_depths[level][operand] = kept;
+				}
+			}
+			for (std::size_t operand = 0; operand < plan.operand_count; ++operand)
+				plan.counted[operand] = remaining_depths[operand] > 0;
+
+			plan.result_bound_level = 0;
+			for (std::size_t level = 0; level < plan.level_count; ++level)
+				if (plan.result_poss[level] != npos)
+					plan.result_bound_level = level + 1;
+			for (std::size_t level = 0; level < plan.result_bound_level; ++level)
+				if (plan.result_poss[level] == npos)
+					plan.needs_deduplication = true;
+			return plan;
+		}
+	};
+
+	/**
+	 * Einsum for a subscript that is known at compile time. The plan, i.e. the label order and the positions of the labels
+	 * in the operands, is computed by the compiler. Every level is a loop over the HashDiagonals of the operands that
+	 * hold its label, driven by the smallest one. The loops are nested by template recursion and the probing of the other
+	 * diagonals is unrolled, so no Subscript, Operator or cardinality estimation is involved at runtime.
+	 *
+	 * The values are computed as by Einsum: for value_type bool every key is produced once; otherwise, the values of
+	 * entries with equal keys must be summed.
+	 * @tparam subscript the subscript, e.g. "ab,bc->ac"
+	 * @tparam value_type the value type of the result, size_t or bool
+	 * @tparam tr the hypertrie trait of the operands
+	 */
+	template<SubscriptLiteral subscript, typename value_type, HypertrieTrait tr>
+	class StaticEinsum {
+		using key_part_type = typename tr::key_part_type;
+		using Key_t = typename tr::Key;
+		using Plan = StaticEinsumPlan<subscript.chars.size()>;
+
+	public:
+		static constexpr Plan plan = Plan::parse(subscript);
+		static constexpr std::size_t operand_count = plan.operand_count;
+
+	private:
+		static constexpr bool bool_value_type = std::is_same_v<value_type, bool>;
+
+		using OperandPtrs = std::array<const const_Hypertrie<tr> *, operand_count>;
+
+		template<std::size_t level>
+		static constexpr std::size_t joined_count = []() {
+			std::size_t count = 0;
+			for (std::size_t operand = 0; operand < operand_count; ++operand)
+				count += plan.label_pos_counts[level][operand] > 0;
+			return count;
+		}();
+
+		/**
+		 * The operands that hold the label of the level.
+		 */
+		template<std::size_t level>
+		static constexpr std::array<std::size_t, joined_count<level>> joined_operands = []() {
+			std::array<std::size_t, joined_count<level>> operands{};
+			std::size_t i = 0;
+			for (std::size_t operand = 0; operand < operand_count; ++operand)
+				if (plan.label_pos_counts[level][operand] > 0)
+					operands[i++] = operand;
+			return operands;
+		}();
+
+		template<std::size_t level, std::size_t operand>
+		static constexpr std::array<hypertrie::pos_type, plan.label_pos_counts[level][operand]> diagonal_poss = []() {
+			std::array<hypertrie::pos_type, plan.label_pos_counts[level][operand]> poss{};
+			for (std::size_t i = 0; i < poss.size(); ++i)
+				poss[i] = plan.label_poss[level][operand][i];
+			return poss;
+		}();
+
+		template<typename Consumer>
+		struct Sink {
+			Consumer &consumer;
+			Key_t key;
+			tsl::sparse_set<size_t, std::identity> found_keys{};
+		};
+
+	public:
+		/**
+		 * Evaluates the einsum and passes each entry to consumer.
+		 * @param operands the operands. Their depths must match the subscript.
+		 * @param consumer called with (const Key &, value_type) for every entry
+		 */
+		template<typename Consumer>
+		static void run(std::span<const const_Hypertrie<tr>> operands, Consumer &&consumer) {
+			if (operands.size() != operand_count)
+				throw std::invalid_argument{"number of operands does not match the subscript."};
+			OperandPtrs operand_ptrs;
+			for (std::size_t operand = 0; operand < operand_count; ++operand) {
+				if (operands[operand].depth() != plan.operand_depths[operand])
+					throw std::invalid_argument{"operand depth does not match the subscript."};
+				if (operands[operand].empty())
+					return;
+				operand_ptrs[operand] = &operands[operand];
+			}
+			Sink<std::remove_reference_t<Consumer>> sink{consumer, Key_t(plan.result_depth)};
+			bind<0>(operand_ptrs, sink);
+		}
+
+	private:
+		/**
+		 * Binds the label of level to each of its key parts and continues with the next level.
+		 * @return if an entry was produced
+		 */
+		template<std::size_t level, typename Sink_t>
+		static bool bind(const OperandPtrs &operands, Sink_t &sink) {
+			if constexpr (level == plan.level_count) {
+				return emit(operands, sink);
+			} else {
+				return [&]<std::size_t... I>(std::index_sequence<I...>) -> bool {
+					constexpr auto &joined = joined_operands<level>;
+					std::array<hypertrie::HashDiagonal<tr>, joined.size()> diagonals{
+							hypertrie::HashDiagonal<tr>{*operands[joined[I]], std::span<const hypertrie::pos_type>{diagonal_poss<level, joined[I]>}}...};
+					// the smallest diagonal drives the iteration
+					std::size_t driver = 0;
+					for (std::size_t i = 1; i < joined.size(); ++i)
+						if (diagonals[i].size() < diagonals[driver].size())
+							driver = i;
+					bool found = false;
+					((driver == I and (found = iterate<level, I>(diagonals, operands, sink), true)) or ...);
+					return found;
+				}(std::make_index_sequence<joined_count<level>>{});
+			}
+		}
+
+		/**
+		 * Iterates the key parts of the diagonal at position driver that are in all other diagonals of the level.
+		 */
+		template<std::size_t level, std::size_t driver, typename Diagonals, typename Sink_t>
+		static bool iterate(Diagonals &diagonals, const OperandPtrs &operands, Sink_t &sink) {
+			constexpr auto &joined = joined_operands<level>;
+			constexpr bool stop_after_first = bool_value_type and level >= plan.result_bound_level;
+			bool found = false;
+			auto &driving = diagonals[driver];
+			for (driving.begin(); not driving.ended(); ++driving) {
+				const key_part_type key_part = driving.currentKeyPart();
+				const bool joined_all = [&]<std::size_t... I>(std::index_sequence<I...>) {
+					return ((I == driver or diagonals[I].find(key_part)) and ...);
+				}(std::make_index_sequence<joined.size()>{});
+				if (not joined_all)
+					continue;
+
+				OperandPtrs next_operands = operands;
+				std::array<std::optional<const_Hypertrie<tr>>, joined.size()> slices;
+				[&]<std::size_t... I>(std::index_sequence<I...>) {
+					([&]() {
+						if constexpr (plan.remaining_depths[level][joined[I]] > 0)
+							next_operands[joined[I]] = &slices[I].emplace(diagonals[I].currentHypertrie());
+					}(), ...);
+				}(std::make_index_sequence<joined.size()>{});
+				if constexpr (plan.result_poss[level] != Plan::npos)
+					sink.key[plan.result_poss[level]] = key_part;
+
+				if (bind<level + 1>(next_operands, sink)) {
+					found = true;
+					if constexpr (stop_after_first)
+						return true;
+				}
+			}
+			return found;
+		}
+
+		template<typename Sink_t>
+		static bool emit(const OperandPtrs &operands, Sink_t &sink) {
+			if constexpr (bool_value_type) {
+				if constexpr (plan.needs_deduplication) {
+					if (not sink.found_keys.insert(Dice::hash::dice_hash(sink.key)).second)
+						return true;
+				}
+				sink.consumer(std::as_const(sink.key), true);
+			} else {
+				value_type value = 1;
+				for (std::size_t operand = 0; operand < operand_count; ++operand)
+					if (plan.counted[operand])
+						value *= operands[operand]->size();
+				sink.consumer(std::as_const(sink.key), value);
+			}
+			return true;
+		}
+	};
+
+}// namespace einsum::internal
+
+#endif//HYPERTRIE_STATICEINSUM_HPP
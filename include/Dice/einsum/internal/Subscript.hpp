@@ -231,6 +231,50 @@ namespace einsum::internal {
 			return raw_subscript.operands[label_pos];
 		}
 
+		/**
+		 * Checks if the operands form a cyclic hypergraph, e.g. "ab,bc,ca->", using the GYO reduction: labels that
+		 * occur in only one operand and operands whose labels are a subset of the labels of another operand are
+		 * removed until nothing changes. The subscript is acyclic if no operand is left.
+		 * @return if the hypergraph of the operands is cyclic
+		 */
+		[[nodiscard]] bool isCyclic() const {
+			std::vector<std::vector<Label>> edges;
+			edges.reserve(raw_subscript.operands.size());
+			for (const auto &operand : raw_subscript.operands) {
+				auto &edge = edges.emplace_back(operand.begin(), operand.end());
+				std::sort(edge.begin(), edge.end());
+				edge.erase(std::unique(edge.begin(), edge.end()), edge.end());
+			}
+			bool changed = true;
+			while (changed) {
+				changed = false;
+				// remove labels that occur in a single operand
+				tsl::hopscotch_map<Label, size_t> occurrences;
+				for (const auto &edge : edges)
+					for (auto label : edge)
+						++occurrences[label];
+				for (auto &edge : edges) {
+					const auto removed = std::remove_if(edge.begin(), edge.end(), [&](auto label) { return occurrences[label] == 1; });
+					if (removed != edge.end()) {
+						edge.erase(removed, edge.end());
+						changed = true;
+					}
+				}
+				// remove operands that are contained in another operand
+				for (size_t i = 0; i < edges.size(); ++i) {
+					bool contained = edges[i].empty();
+					for (size_t j = 0; j < edges.size() and not contained; ++j)
+						contained = i != j and std::includes(edges[j].begin(), edges[j].end(), edges[i].begin(), edges[i].end());
+					if (contained) {
+						edges.erase(edges.begin() + i);
+						changed = true;
+						break;
+					}
+				}
+			}
+			return not edges.empty();
+		}
+
 		auto operand2resultMapping_ResolveType() const noexcept {
 			assert(type == Type::Resolve);
 			return operand2result_mapping_resolveType;
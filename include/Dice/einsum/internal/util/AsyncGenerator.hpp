@@ -0,0 +1,186 @@
+#ifndef HYPERTRIE_ASYNCGENERATOR_HPP
+#define HYPERTRIE_ASYNCGENERATOR_HPP
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace einsum::internal::util {
+
+	/**
+	 * A coroutine that produces a sequence of values asynchronously. The coroutine body uses co_yield to produce a value
+	 * and may co_await other awaitables in between, e.g. Executor::schedule() to continue on another thread.
+	 *
+	 * A consumer coroutine awaits next(). The generator runs on the thread that resumes it until it produces the next
+	 * value or finishes; then the consumer is resumed on that thread. Non-coroutine code uses waitNext() instead.
+	 *
+	 * The generator must not be destroyed while a next() is pending.
+	 * @tparam T type of the produced values
+	 */
+	template<typename T>
+	class AsyncGenerator {
+	public:
+		struct promise_type;
+		using handle_type = std::coroutine_handle<promise_type>;
+
+	private:
+		/**
+		 * Suspends the generator and resumes the consumer that awaits next().
+		 */
+		struct ResumeConsumer {
+			bool await_ready() const noexcept { return false; }
+
+			std::coroutine_handle<> await_suspend(handle_type generator) noexcept {
+				return generator.promise().consumer;
+			}
+
+			void await_resume() const noexcept {}
+		};
+
+	public:
+		struct promise_type {
+			std::optional<T> value;
+			std::exception_ptr exception;
+			std::coroutine_handle<> consumer = std::noop_coroutine();
+
+			AsyncGenerator get_return_object() noexcept {
+				return AsyncGenerator{handle_type::from_promise(*this)};
+			}
+
+			std::suspend_always initial_suspend() const noexcept { return {}; }
+
+			ResumeConsumer final_suspend() const noexcept { return {}; }
+
+			ResumeConsumer yield_value(T produced) {
+				value.emplace(std::move(produced));
+				return {};
+			}
+
+			void return_void() const noexcept {}
+
+			void unhandled_exception() noexcept {
+				exception = std::current_exception();
+			}
+		};
+
+		/**
+		 * Awaitable returned by next(). Resumes the generator and yields the produced value or std::nullopt if the
+		 * generator finished.
+		 */
+		class NextAwaiter {
+			handle_type generator_;
+
+		public:
+			explicit NextAwaiter(handle_type generator) noexcept : generator_(generator) {}
+
+			bool await_ready() const noexcept { return generator_.done(); }
+
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) noexcept {
+				generator_.promise().consumer = consumer;
+				generator_.promise().value.reset();
+				return generator_;
+			}
+
+			std::optional<T> await_resume() {
+				auto &promise = generator_.promise();
+				if (promise.exception)
+					std::rethrow_exception(std::exchange(promise.exception, nullptr));
+				if (generator_.done())
+					return std::nullopt;
+				return std::exchange(promise.value, std::nullopt);
+			}
+		};
+
+	private:
+		handle_type handle_;
+
+		explicit AsyncGenerator(handle_type handle) noexcept : handle_(handle) {}
+
+		/**
+		 * Awaits a NextAwaiter and signals a waiting thread when done. Used by waitNext().
+		 */
+		struct SignalingTask {
+			struct promise_type {
+				SignalingTask get_return_object() noexcept { return {}; }
+
+				std::suspend_never initial_suspend() const noexcept { return {}; }
+
+				std::suspend_never final_suspend() const noexcept { return {}; }
+
+				void return_void() const noexcept {}
+
+				void unhandled_exception() const noexcept { std::terminate(); }
+			};
+		};
+
+		struct WaitState {
+			std::mutex mutex;
+			std::condition_variable condition;
+			bool done = false;
+			std::optional<T> value;
+			std::exception_ptr exception;
+		};
+
+		static SignalingTask awaitNext(NextAwaiter awaiter, WaitState &state) {
+			std::optional<T> value;
+			std::exception_ptr exception;
+			try {
+				value = co_await awaiter;
+			} catch (...) {
+				exception = std::current_exception();
+			}
+			std::lock_guard lock{state.mutex};
+			state.value = std::move(value);
+			state.exception = exception;
+			state.done = true;
+			state.condition.notify_one();
+		}
+
+	public:
+		AsyncGenerator(AsyncGenerator &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+		AsyncGenerator &operator=(AsyncGenerator &&other) noexcept {
+			if (this != &other) {
+				if (handle_)
+					handle_.destroy();
+				handle_ = std::exchange(other.handle_, nullptr);
+			}
+			return *this;
+		}
+
+		AsyncGenerator(const AsyncGenerator &) = delete;
+		AsyncGenerator &operator=(const AsyncGenerator &) = delete;
+
+		~AsyncGenerator() {
+			if (handle_)
+				handle_.destroy();
+		}
+
+		/**
+		 * @return an awaitable that yields the next value or std::nullopt if the generator finished
+		 */
+		[[nodiscard]] NextAwaiter next() noexcept {
+			return NextAwaiter{handle_};
+		}
+
+		/**
+		 * Blocks the calling thread until the next value is produced.
+		 * @return the next value or std::nullopt if the generator finished
+		 */
+		std::optional<T> waitNext() {
+			WaitState state;
+			awaitNext(next(), state);
+			std::unique_lock lock{state.mutex};
+			state.condition.wait(lock, [&]() { return state.done; });
+			if (state.exception)
+				std::rethrow_exception(state.exception);
+			return std::move(state.value);
+		}
+	};
+
+}// namespace einsum::internal::util
+
+#endif//HYPERTRIE_ASYNCGENERATOR_HPP
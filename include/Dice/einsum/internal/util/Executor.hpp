@@ -0,0 +1,111 @@
+#ifndef HYPERTRIE_EXECUTOR_HPP
+#define HYPERTRIE_EXECUTOR_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Dice/hypertrie/internal/SliceCache.hpp"
+
+namespace einsum::internal::util {
+
+	/**
+	 * A fixed pool of threads that resume coroutines in FIFO order. A coroutine moves itself to the pool by
+	 * co_await executor.schedule().
+	 *
+	 * All scheduled coroutines must have finished or be suspended elsewhere before the executor is destroyed.
+	 * Slice caches are bypassed on the threads of the executor (see hypertrie::SliceCacheBypass).
+	 */
+	class Executor {
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		std::deque<std::coroutine_handle<>> queue_;
+		std::vector<std::thread> threads_;
+		bool stopping_ = false;
+
+		void work() {
+			// coroutines of several threads may slice hypertries of the same context
+			hypertrie::SliceCacheBypass bypass;
+			while (true) {
+				std::coroutine_handle<> handle;
+				{
+					std::unique_lock lock{mutex_};
+					condition_.wait(lock, [&]() { return stopping_ or not queue_.empty(); });
+					if (queue_.empty())
+						return;
+					handle = queue_.front();
+					queue_.pop_front();
+				}
+				handle.resume();
+			}
+		}
+
+	public:
+		/**
+		 * @param thread_count number of threads. 0 uses std::thread::hardware_concurrency().
+		 */
+		explicit Executor(size_t thread_count = 0) {
+			if (thread_count == 0)
+				thread_count = std::max(1U, std::thread::hardware_concurrency());
+			threads_.reserve(thread_count);
+			for (size_t i = 0; i < thread_count; ++i)
+				threads_.emplace_back([this]() { work(); });
+		}
+
+		Executor(const Executor &) = delete;
+		Executor &operator=(const Executor &) = delete;
+
+		/**
+		 * Resumes the coroutines that are still queued and joins the threads.
+		 */
+		~Executor() {
+			{
+				std::lock_guard lock{mutex_};
+				stopping_ = true;
+			}
+			condition_.notify_all();
+			for (auto &thread : threads_)
+				thread.join();
+		}
+
+		[[nodiscard]] size_t threadCount() const noexcept { return threads_.size(); }
+
+		/**
+		 * Queues a coroutine to be resumed by one of the threads.
+		 */
+		void post(std::coroutine_handle<> handle) {
+			{
+				std::lock_guard lock{mutex_};
+				queue_.push_back(handle);
+			}
+			condition_.notify_one();
+		}
+
+		struct ScheduleAwaiter {
+			Executor *executor;
+
+			bool await_ready() const noexcept { return false; }
+
+			void await_suspend(std::coroutine_handle<> handle) const {
+				executor->post(handle);
+			}
+
+			void await_resume() const noexcept {}
+		};
+
+		/**
+		 * @return an awaitable that suspends the awaiting coroutine and resumes it on one of the threads after the
+		 * coroutines that were queued before
+		 */
+		[[nodiscard]] ScheduleAwaiter schedule() noexcept {
+			return {this};
+		}
+	};
+
+}// namespace einsum::internal::util
+
+#endif//HYPERTRIE_EXECUTOR_HPP
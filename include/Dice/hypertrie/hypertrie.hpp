@@ -4,7 +4,22 @@
 #include "Dice/hypertrie/internal/Hypertrie.hpp"
 #include "Dice/hypertrie/internal/HashJoin.hpp"
 #include "Dice/hypertrie/internal/BulkInserter.hpp"
+#include "Dice/hypertrie/internal/WriteAheadLog.hpp"
+#include "Dice/hypertrie/internal/Checkpoint.hpp"
+#include "Dice/hypertrie/internal/Diff.hpp"
+#include "Dice/hypertrie/internal/ParallelIteration.hpp"
+#include "Dice/hypertrie/internal/StaticHypertrie.hpp"
+#include "Dice/hypertrie/internal/SetOperations.hpp"
+#include "Dice/hypertrie/internal/OrderedIterator.hpp"
+#include "Dice/hypertrie/internal/ShardedHypertrie.hpp"
 #include "Dice/einsum/internal/Einsum.hpp"
+#include "Dice/einsum/internal/ShardedEinsum.hpp"
+#include "Dice/einsum/internal/AsyncEinsum.hpp"
+#include "Dice/einsum/internal/StaticEinsum.hpp"
+
+#include <atomic>
+#include <exception>
+#include <thread>
 
 namespace hypertrie {
 	using Subscript =  einsum::internal::Subscript;
@@ -13,9 +28,25 @@ namespace hypertrie {
 	template<typename value_type, HypertrieTrait tr =default_bool_Hypertrie_t>
 	using Einsum = typename ::einsum::internal::Einsum<value_type, tr>;
 
+	template<typename value_type, HypertrieTrait tr =default_bool_Hypertrie_t>
+	using ShardedEinsum = typename ::einsum::internal::ShardedEinsum<value_type, tr>;
+
+	template<::einsum::internal::SubscriptLiteral subscript, typename value_type = size_t, HypertrieTrait tr =default_bool_Hypertrie_t>
+	using StaticEinsum = ::einsum::internal::StaticEinsum<subscript, value_type, tr>;
+
+	template<HypertrieTrait tr =default_bool_Hypertrie_t>
+	using ShardedOperand = ::einsum::internal::ShardedOperand<tr>;
+
+	using Executor = ::einsum::internal::util::Executor;
+	template<typename T>
+	using AsyncGenerator = ::einsum::internal::util::AsyncGenerator<T>;
+	using AsyncEinsumConfig = ::einsum::internal::AsyncEinsumConfig;
+	using ::einsum::internal::asyncEinsum;
+
 	template <typename key_part_type>
 	using KeyHash = ::einsum::internal::KeyHash<key_part_type>;
 	using TimePoint = ::einsum::internal::TimePoint;
+	using JoinStrategy = ::einsum::internal::JoinStrategy;
 
 	template<typename value_type = size_t, HypertrieTrait tr =default_bool_Hypertrie_t>
 	using EinsumEntry = ::einsum::internal::Entry<value_type, tr>;
@@ -25,7 +56,8 @@ namespace hypertrie {
 	static auto
 	einsum2map(const std::shared_ptr<Subscript> &subscript,
 			   const std::vector<const_Hypertrie<tr>> &operands,
-			   const TimePoint &time_point = TimePoint::max()) {
+			   const TimePoint &time_point = TimePoint::max(),
+			   JoinStrategy join_strategy = JoinStrategy::label_at_a_time) {
 		using Key = typename tr::Key;
 		using key_part_type = typename tr::key_part_type;
 
@@ -34,12 +66,91 @@ namespace hypertrie {
 			if (operand.size() == 0)
 				return results;
 
-		Einsum<value_type, tr> einsum{subscript, operands, time_point};
+		Einsum<value_type, tr> einsum{subscript, operands, time_point, join_strategy};
 		for (auto &&entry : einsum) {
 			results[entry.key] += entry.value;
 		}
 		return results;
 	}
+
+	/**
+	 * Like einsum2map but for a subscript that is known at compile time, e.g. static_einsum2map<"ab,bc->ac">(operands).
+	 */
+	template<::einsum::internal::SubscriptLiteral subscript, typename value_type = std::size_t, HypertrieTrait tr =default_bool_Hypertrie_t>
+	static auto
+	static_einsum2map(const std::vector<const_Hypertrie<tr>> &operands) {
+		using Key = typename tr::Key;
+		using key_part_type = typename tr::key_part_type;
+
+		tsl::hopscotch_map<Key, value_type, KeyHash<key_part_type>> results{};
+		StaticEinsum<subscript, value_type, tr>::run(operands, [&](const Key &key, value_type value) {
+			results[key] += value;
+		});
+		return results;
+	}
+
+	/**
+	 * Like einsum2map but with ShardedHypertries among the operands. The shard combinations of the ShardedEinsum are
+	 * evaluated by up to thread_count threads in parallel. The sharded operands must be co-partitioned, see ShardedEinsum.
+	 * Slice caches are bypassed during the evaluation (see SliceCacheBypass).
+	 * @param thread_count number of threads. 0 uses std::thread::hardware_concurrency().
+	 * @throws std::invalid_argument if the sharded operands are not co-partitioned
+	 */
+	template<typename value_type = std::size_t, HypertrieTrait tr =default_bool_Hypertrie_t>
+	static auto
+	sharded_einsum2map(const std::shared_ptr<Subscript> &subscript,
+					   const std::vector<ShardedOperand<tr>> &operands,
+					   const TimePoint &time_point = TimePoint::max(),
+					   size_t thread_count = 0) {
+		using Key = typename tr::Key;
+		using key_part_type = typename tr::key_part_type;
+		using Results = tsl::hopscotch_map<Key, value_type, KeyHash<key_part_type>>;
+
+		const auto combinations = ShardedEinsum<value_type, tr>::combine(*subscript, operands);
+		if (thread_count == 0)
+			thread_count = std::max(1U, std::thread::hardware_concurrency());
+		thread_count = std::min(thread_count, combinations.size());
+
+		std::vector<Results> thread_results(thread_count);
+		std::vector<std::exception_ptr> exceptions(thread_count);
+		std::atomic<size_t> next_combination = 0;
+		auto evaluate = [&](size_t thread) {
+			SliceCacheBypass bypass;// the threads may share contexts of unsharded operands
+			try {
+				// subscripts cache derived subscripts, so every thread needs its own
+				auto thread_subscript = std::make_shared<Subscript>(subscript->getRawSubscript());
+				for (size_t i = next_combination++; i < combinations.size(); i = next_combination++) {
+					Einsum<value_type, tr> einsum{thread_subscript, combinations[i], time_point};
+					for (auto &&entry : einsum)
+						thread_results[thread][entry.key] += entry.value;
+				}
+			} catch (...) {
+				exceptions[thread] = std::current_exception();
+			}
+		};
+		std::vector<std::thread> threads;
+		threads.reserve(thread_count);
+		for (size_t thread = 1; thread < thread_count; ++thread)
+			threads.emplace_back(evaluate, thread);
+		if (thread_count > 0)
+			evaluate(0);
+		for (auto &thread : threads)
+			thread.join();
+		for (const auto &exception : exceptions)
+			if (exception)
+				std::rethrow_exception(exception);
+
+		Results results{};
+		for (auto &partial_results : thread_results) {
+			if (results.empty()) {
+				results = std::move(partial_results);
+				continue;
+			}
+			for (const auto &[key, value] : partial_results)
+				results[key] += value;
+		}
+		return results;
+	}
 }
 
 
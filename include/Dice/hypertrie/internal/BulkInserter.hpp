@@ -4,6 +4,7 @@
 #include <thread>
 
 #include "Dice/hypertrie/internal/Hypertrie.hpp"
+#include "Dice/hypertrie/internal/WriteAheadLog.hpp"
 
 namespace hypertrie {
 
@@ -28,9 +29,14 @@ namespace hypertrie {
 		collection_type load_entries;
 		size_t threshold = 1'000'000;
 		std::thread insertion_thread;
+		WriteAheadLog<tr> *log = nullptr;
 
 	public:
-		BulkInserter(Hypertrie<tr> &hypertrie, size_t threshold = 1'000'000) : hypertrie(&hypertrie), threshold(threshold) {
+		/**
+		 * @param log if given, every flushed batch is logged and committed as one record before it is inserted
+		 */
+		BulkInserter(Hypertrie<tr> &hypertrie, size_t threshold = 1'000'000, WriteAheadLog<tr> *log = nullptr)
+			: hypertrie(&hypertrie), threshold(threshold), log(log) {
 			if constexpr (not tr::is_bool_valued) {
 				throw std::logic_error("Bulk loading is only supported for bool-valued Hypertries yet.");
 			}
@@ -68,6 +74,8 @@ namespace hypertrie {
 					[&](auto depth_arg) {
 						this->load_entries = std::move(this->new_entries);
 						this->new_entries = {};
+						if (log != nullptr)
+							log->appendBatch(depth_arg, load_entries);
 						if (load_entries.size() > 0)
 							insertion_thread = std::thread([&]() {
 								// todo: add support for non-boolean
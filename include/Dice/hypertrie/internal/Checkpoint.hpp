@@ -0,0 +1,92 @@
+#ifndef HYPERTRIE_CHECKPOINT_HPP
+#define HYPERTRIE_CHECKPOINT_HPP
+
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+#include "Dice/hypertrie/internal/Hypertrie.hpp"
+#include "Dice/hypertrie/internal/raw/storage/NodeStorageCheckpoint.hpp"
+
+namespace hypertrie {
+
+	/**
+	 * Checkpoints of all hypertries of a HypertrieContext.
+	 *
+	 * The first checkpoint of a context is full, every further one only contains the nodes that changed since the
+	 * checkpoint before (see internal::raw::NodeStorageCheckpoint). A context is restored from its full checkpoint and
+	 * the incremental checkpoints written after it. Combined with a WriteAheadLog that is reset after each checkpoint,
+	 * recovery replays only the mutations since the last checkpoint.
+	 */
+	template<HypertrieTrait tr_t>
+	class HypertrieCheckpoint {
+	public:
+		using tr = tr_t;
+		using tri = internal::raw::Hypertrie_internal_t<tr>;
+
+	private:
+		using NodeStorageCheckpoint = internal::raw::NodeStorageCheckpoint<hypertrie_depth_limit - 1, tri>;
+
+	public:
+		/**
+		 * Writes a checkpoint of context. The slice cache of context is cleared before, so that the references it holds on
+		 * nodes are not restored.
+		 * @param context the context
+		 * @param hypertries the hypertries to restore. To not leak nodes on restore, these must be all hypertries
+		 * (including snapshots) that hold references on nodes of context.
+		 * @param path the checkpoint file, an existing file is replaced
+		 * @return true if the checkpoint is incremental
+		 */
+		static bool write(HypertrieContext<tr> &context, const std::vector<const_Hypertrie<tr>> &hypertries, const std::filesystem::path &path) {
+			std::vector<internal::raw::CheckpointRoot> roots;
+			roots.reserve(hypertries.size());
+			for (const auto &hypertrie : hypertries) {
+				if (hypertrie.context_ != &context)
+					throw std::invalid_argument{"only hypertries of the checkpointed context can be restored"};
+				roots.push_back({hypertrie.depth_, hypertrie.node_container_.hash_sized.hash()});
+			}
+			if (auto *slice_cache = context.sliceCache(); slice_cache != nullptr)
+				slice_cache->clear();
+			return NodeStorageCheckpoint::write(context.rawContext().storage, roots, path);
+		}
+
+		/**
+		 * Restores hypertries from a chain of checkpoints into an empty context.
+		 * @param context an empty context
+		 * @param layers a full checkpoint followed by the incremental checkpoints written after it, in order
+		 * @return the hypertries passed to write() for the last checkpoint, in the same order
+		 */
+		static std::vector<Hypertrie<tr>> restore(HypertrieContext<tr> &context, const std::vector<std::filesystem::path> &layers) {
+			auto &storage = context.rawContext().storage;
+			auto roots = NodeStorageCheckpoint::restore(storage, layers);
+			std::vector<Hypertrie<tr>> hypertries;
+			hypertries.reserve(roots.size());
+			for (const auto &root : roots) {
+				internal::raw::RawNodeContainer node_container{root.hash, nullptr};
+				const internal::raw::TensorHash hash{root.hash};
+				if (not hash.empty())
+					internal::compiled_switch<hypertrie_depth_limit, 1>::switch_void(
+							root.depth,
+							[&](auto depth_arg) {
+								if constexpr (depth_arg == 1 and tri::is_bool_valued and tri::is_lsb_unused)
+									if (hash.isCompressed())
+										return;// the key part is stored in the hash
+								node_container.pointer_sized = storage.template getNode<depth_arg>(hash).node();
+							},
+							[]() { throw std::invalid_argument{"checkpoint contains a hypertrie of unsupported depth"}; });
+				// the reference of the checkpointed hypertrie is included in the restored ref_count. The Hypertrie takes over
+				// the reference that the copy of the pinned const_Hypertrie acquires, the pinned one releases it again.
+				const_Hypertrie<tr> pinned{root.depth, &context, node_container};
+				pinned.pinned_ = true;
+				pinned.holdRoot();
+				hypertries.emplace_back(pinned);
+			}
+			// acquiring and releasing the roots did not change the storage
+			storage.clearJournals();
+			return hypertries;
+		}
+	};
+
+}// namespace hypertrie
+
+#endif//HYPERTRIE_CHECKPOINT_HPP
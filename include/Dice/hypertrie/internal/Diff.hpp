@@ -0,0 +1,221 @@
+#ifndef HYPERTRIE_DIFF_HPP
+#define HYPERTRIE_DIFF_HPP
+
+#include "Dice/hypertrie/internal/Hypertrie.hpp"
+#include "Dice/hypertrie/internal/raw/iterator/Diff.hpp"
+
+#include <cassert>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace hypertrie {
+
+	namespace internal {
+
+		/**
+		 * The HypertrieContext in which two hypertries can be compared.
+		 * @throws std::invalid_argument if the depths or the contexts of a and b differ
+		 */
+		template<HypertrieTrait tr>
+		HypertrieContext<tr> &commonContext(const const_Hypertrie<tr> &a, const const_Hypertrie<tr> &b) {
+			if (a.depth() != b.depth())
+				throw std::invalid_argument{"The hypertries must have the same depth."};
+			if (a.context() != nullptr and b.context() != nullptr and a.context() != b.context())
+				throw std::invalid_argument{"The hypertries must be stored in the same HypertrieContext."};
+			if (a.context() != nullptr)
+				return *a.context();
+			else if (b.context() != nullptr)
+				return *b.context();
+			else
+				return DefaultHypertrieContext<tr>::instance();
+		}
+
+		template<size_t depth, HypertrieTrait tr, typename F>
+		void rawDiff(HypertrieContext<tr> &context, const const_Hypertrie<tr> &a, const const_Hypertrie<tr> &b, F &&consumer) {
+			using tri = raw::Hypertrie_internal_t<tr>;
+			raw::RawDiff<depth, tri>::diff(context.rawContext(),
+										   *reinterpret_cast<const raw::NodeContainer<depth, tri> *>(a.rawNodeContainer()),
+										   *reinterpret_cast<const raw::NodeContainer<depth, tri> *>(b.rawNodeContainer()),
+										   std::forward<F>(consumer));
+		}
+	}// namespace internal
+
+	/**
+	 * An entry that differs between two hypertries.
+	 */
+	template<HypertrieTrait tr>
+	struct DiffEntry {
+		using Key = typename tr::Key;
+		using value_type = typename tr::value_type;
+
+		Key key;
+		value_type value;
+		/**
+		 * true if the entry was added, i.e. it is only in the second hypertrie.
+		 * false if the entry was removed, i.e. it is only in the first hypertrie.
+		 */
+		bool added;
+	};
+
+	/**
+	 * The entries that were added and removed going from hypertrie a to hypertrie b.
+	 * Both hypertries are walked in lockstep and child pairs with equal TensorHash are skipped.
+	 * So, computing a Diff costs time in the order of the changed entries, not of the size of a and b.
+	 * The walk is lazy: iterating yields one differing entry at a time without materializing the others. collect()
+	 * materializes all of them.
+	 *
+	 * If a key is mapped to different values in a and b, it is reported as removed with the old value and as added with the new value.
+	 * The Diff pins a and b like snapshots: modifying them after the Diff was created does not change or invalidate it.
+	 */
+	template<HypertrieTrait tr_t = default_bool_Hypertrie_t>
+	class Diff {
+	public:
+		using tr = tr_t;
+		using tri = internal::raw::Hypertrie_internal_t<tr>;
+		using Entry = DiffEntry<tr>;
+
+	private:
+		template<size_t depth>
+		using RawDiff = internal::raw::RawDiff<depth, tri>;
+
+		struct RawMethods {
+			std::shared_ptr<void> (*begin)(HypertrieContext<tr> &context, const const_Hypertrie<tr> &a, const const_Hypertrie<tr> &b) = nullptr;
+
+			void (*inc)(void *) = nullptr;
+
+			bool (*ended)(void const *) = nullptr;
+
+			void (*entry)(void const *, Entry &) = nullptr;
+		};
+
+		template<size_t depth>
+		inline static RawMethods generateRawMethods() {
+			return RawMethods{
+					[](HypertrieContext<tr> &context, const const_Hypertrie<tr> &a, const const_Hypertrie<tr> &b) -> std::shared_ptr<void> {
+						return std::make_shared<RawDiff<depth>>(context.rawContext(),
+																*reinterpret_cast<const internal::raw::NodeContainer<depth, tri> *>(a.rawNodeContainer()),
+																*reinterpret_cast<const internal::raw::NodeContainer<depth, tri> *>(b.rawNodeContainer()));
+					},
+					[](void *raw_diff) { ++*static_cast<RawDiff<depth> *>(raw_diff); },
+					[](void const *raw_diff) { return not *static_cast<RawDiff<depth> const *>(raw_diff); },
+					[](void const *raw_diff_ptr, Entry &entry) {
+						const auto &raw_diff = *static_cast<RawDiff<depth> const *>(raw_diff_ptr);
+						const auto &raw_key = raw_diff.key();
+						entry.key.assign(raw_key.begin(), raw_key.end());
+						entry.value = raw_diff.value();
+						entry.added = not raw_diff.inA();
+					}};
+		}
+
+		static RawMethods const &getRawMethods(pos_type depth) {
+			static const std::vector<RawMethods> raw_method_cache = []() {
+				std::vector<RawMethods> raw_methods;
+				for (size_t depth : iter::range(1UL, hypertrie_depth_limit))
+					raw_methods.push_back(internal::compiled_switch<hypertrie_depth_limit, 1>::switch_(
+							depth,
+							[](auto depth_arg) -> RawMethods {
+								return generateRawMethods<depth_arg>();
+							},
+							[]() -> RawMethods { assert(false); throw std::logic_error{"Something is really wrong."}; }));
+				return raw_methods;
+			}();
+			return raw_method_cache[depth - 1];
+		}
+
+		HypertrieContext<tr> *context_ = nullptr;
+		// pinned copies, so the compared versions stay alive when a or b are modified afterwards
+		std::optional<const_Hypertrie<tr>> a_;
+		std::optional<const_Hypertrie<tr>> b_;
+
+	public:
+		/**
+		 * Yields the differing entries one at a time. Copies of an iterator share the position of the walk.
+		 */
+		class iterator {
+			RawMethods const *raw_methods_ = nullptr;
+			std::shared_ptr<void> raw_diff_;
+			Entry entry_;
+
+			void load() {
+				if (not raw_methods_->ended(raw_diff_.get()))
+					raw_methods_->entry(raw_diff_.get(), entry_);
+			}
+
+		public:
+			using self_type = iterator;
+			using value_type = Entry;
+
+			/**
+			 * An ended iterator.
+			 */
+			iterator() = default;
+
+			explicit iterator(const Diff &diff) {
+				if (not diff.a_ or *diff.a_ == *diff.b_)
+					return;
+				raw_methods_ = &getRawMethods(diff.a_->depth());
+				raw_diff_ = raw_methods_->begin(*diff.context_, *diff.a_, *diff.b_);
+				load();
+			}
+
+			self_type &operator++() {
+				raw_methods_->inc(raw_diff_.get());
+				load();
+				return *this;
+			}
+
+			const value_type &operator*() const noexcept { return entry_; }
+
+			const value_type *operator->() const noexcept { return &entry_; }
+
+			operator bool() const { return raw_diff_ and not raw_methods_->ended(raw_diff_.get()); }
+		};
+
+		using const_iterator = iterator;
+
+		Diff() = default;
+
+		/**
+		 * @param a the old hypertrie
+		 * @param b the new hypertrie
+		 * @throws std::invalid_argument if the depths or the contexts of a and b differ
+		 */
+		Diff(const const_Hypertrie<tr> &a, const const_Hypertrie<tr> &b) : context_(&internal::commonContext(a, b)), a_(a.pinnedCopy()), b_(b.pinnedCopy()) {}
+
+		/**
+		 * @return true if a and b have the same entries
+		 */
+		[[nodiscard]] bool empty() const noexcept { return not a_ or *a_ == *b_; }
+
+		[[nodiscard]] iterator begin() const { return iterator{*this}; }
+
+		[[nodiscard]] bool end() const noexcept { return false; }
+
+		[[nodiscard]] const_iterator cbegin() const { return iterator{*this}; }
+
+		[[nodiscard]] bool cend() const noexcept { return false; }
+
+		/**
+		 * Materializes all differing entries.
+		 */
+		[[nodiscard]] std::vector<Entry> collect() const {
+			std::vector<Entry> entries;
+			for (auto it = begin(); it; ++it)
+				entries.push_back(*it);
+			return entries;
+		}
+	};
+
+	/**
+	 * Entries added and removed going from a to b. See Diff.
+	 */
+	template<HypertrieTrait tr>
+	Diff<tr> diff(const const_Hypertrie<tr> &a, const const_Hypertrie<tr> &b) {
+		return Diff<tr>{a, b};
+	}
+
+}// namespace hypertrie
+
+#endif//HYPERTRIE_DIFF_HPP
@@ -1,6 +1,8 @@
 #ifndef HYPERTRIE_HASHDIAGONAL_HPP
 #define HYPERTRIE_HASHDIAGONAL_HPP
 
+#include <span>
+
 #include "Dice/hypertrie/internal/raw/iterator/Diagonal.hpp"
 #include "Dice/hypertrie/internal/HypertrieContext.hpp"
 #include "Dice/hypertrie/internal/Hypertrie_predeclare.hpp"
@@ -13,6 +15,7 @@ namespace hypertrie {
 		using tri = internal::raw::Hypertrie_internal_t<tr>;
 		typedef typename internal::raw::RawNodeContainer NodeContainer;
 		using KeyPositions = typename tr::KeyPositions;
+		using KeyPositionsView = std::span<const pos_type>;
 		template <size_t depth>
 		using RawKeyPositions = typename  tri::template DiagonalPositions<depth>;
 		using key_part_type = typename tr::key_part_type;
@@ -24,7 +27,7 @@ namespace hypertrie {
 		using Key = typename tr::Key;
 
 		struct RawMethods {
-			void *(*construct)(const const_Hypertrie<tr> &hypertrie, const KeyPositions &diagonal_poss);
+			void *(*construct)(const const_Hypertrie<tr> &hypertrie, KeyPositionsView diagonal_poss);
 
 			void (*destruct)(void *);
 
@@ -43,7 +46,7 @@ namespace hypertrie {
 			bool (*ended)(void const *);
 
 			size_t (*size)(void const *);
-			RawMethods(void *(*construct)(const const_Hypertrie<tr> &, const KeyPositions &), void (*destruct)(void *), void (*begin)(void *), key_part_type (*currentKeyPart)(const void *), const_Hypertrie<tr> (*currentHypertrie)(const void *, HypertrieContext<tr> *), value_type (*currentScalar)(const void *), bool (*find)(void *, key_part_type), void (*inc)(void *), bool (*ended)(const void *), size_t (*size)(const void *)) : construct(construct), destruct(destruct), begin(begin), currentKeyPart(currentKeyPart), currentHypertrie(currentHypertrie), currentScalar(currentScalar), find(find), inc(inc), ended(ended), size(size) {}
+			RawMethods(void *(*construct)(const const_Hypertrie<tr> &, KeyPositionsView), void (*destruct)(void *), void (*begin)(void *), key_part_type (*currentKeyPart)(const void *), const_Hypertrie<tr> (*currentHypertrie)(const void *, HypertrieContext<tr> *), value_type (*currentScalar)(const void *), bool (*find)(void *, key_part_type), void (*inc)(void *), bool (*ended)(const void *), size_t (*size)(const void *)) : construct(construct), destruct(destruct), begin(begin), currentKeyPart(currentKeyPart), currentHypertrie(currentHypertrie), currentScalar(currentScalar), find(find), inc(inc), ended(ended), size(size) {}
 		};
 
 		template <size_t diag_depth, size_t depth, NodeCompression compression>
@@ -52,7 +55,7 @@ namespace hypertrie {
 			using RawDiagonalHash_t = RawHashDiagonal<diag_depth, depth, compression>;
 			return RawMethods(
 					// construct
-					[](const const_Hypertrie<tr> &hypertrie, const KeyPositions &diagonal_poss) -> void * {
+					[](const const_Hypertrie<tr> &hypertrie, KeyPositionsView diagonal_poss) -> void * {
 						using NodecType = typename internal::raw::template SpecificNodeContainer<depth, compression, tri>;
 
 						RawKeyPositions<depth> raw_diag_poss;
@@ -91,7 +94,7 @@ namespace hypertrie {
 							if (value.is_managed) {
 								return const_Hypertrie<tr>(result_depth, context, {value.nodec.hash().hash(), value.nodec.node()});
 							} else {
-								return const_Hypertrie<tr>(result_depth, nullptr, {value.nodec.hash().hash(), new internal::raw::CompressedNode<result_depth, tri>(*value.nodec.compressed_node())});
+								return const_Hypertrie<tr>(result_depth, nullptr, {value.nodec.hash().hash(), internal::raw::ContextlessNodePool<result_depth, tri>::acquire(*value.nodec.compressed_node())});
 							}
 						} else {
 							assert(false);
@@ -163,6 +166,13 @@ namespace hypertrie {
 
 	public:
 		HashDiagonal(const const_Hypertrie<tr> &hypertrie, const KeyPositions &diag_poss)
+			: HashDiagonal(hypertrie, KeyPositionsView{diag_poss}) {}
+
+		/**
+		 * @param hypertrie the hypertrie to iterate the diagonal of
+		 * @param diag_poss the diagonal positions, e.g. a std::array, no KeyPositions vector is required
+		 */
+		HashDiagonal(const const_Hypertrie<tr> &hypertrie, KeyPositionsView diag_poss)
 			: raw_methods(&getRawMethods(hypertrie.depth(), diag_poss.size(), hypertrie.size() == 1)),
 			  raw_hash_diagonal(raw_methods->construct(hypertrie, diag_poss)), context_(hypertrie.context()) {}
 
@@ -1,11 +1,15 @@
 #ifndef HYPERTRIE_HASHJOIN_IMPL_HPP
 #define HYPERTRIE_HASHJOIN_IMPL_HPP
 
+#include <algorithm>
+#include <limits>
+#include <memory_resource>
+#include <span>
 #include <utility>
 
 #include "Dice/hypertrie/internal/util/CONSTANTS.hpp"
 #include "Dice/hypertrie/internal/util/FrontSkipIterator.hpp"
-#include "Dice/hypertrie/internal/util/PermutationSort.hpp"
+#include "Dice/hypertrie/internal/util/SortedIntersection.hpp"
 #include "Dice/hypertrie/internal/Hypertrie.hpp"
 
 
@@ -13,8 +17,10 @@ namespace hypertrie {
 
 	template<HypertrieTrait tr =default_bool_Hypertrie_t>
 	class HashJoin {
+		using tri = internal::raw::Hypertrie_internal_t<tr>;
 		using key_part_type = typename tr::key_part_type;
 		using value_type = typename tr::value_type;
+		using bitmap_type = typename tr::template edges_set_type<1, key_part_type>;
 
 	public:
 		using poss_type = std::vector<pos_type>;
@@ -39,30 +45,109 @@ namespace hypertrie {
 
 		public:
 			using iterator_category = std::forward_iterator_tag;
-			using value_type = std::pair<std::vector<const_Hypertrie<tr>>, key_part_type>;
+			/**
+			 * The operands that remain for a join key part. They are allocated from the memory resource of the iterator.
+			 */
+			using operands_type = std::pmr::vector<const_Hypertrie<tr>>;
+			using value_type = std::pair<operands_type, key_part_type>;
 			using difference_type = ptrdiff_t;
 			using pointer = value_type *;
 			using reference = value_type &;
 		private:
-			poss_type pos_in_out{};
-			std::vector<pos_type> result_depths{};
-			std::vector<HashDiagonal<tr>> ops{};
+			std::pmr::vector<pos_type> pos_in_out;
+			std::pmr::vector<pos_type> result_depths;
+			std::pmr::vector<HashDiagonal<tr>> ops;
+
+			bool ended = true;
+
+			value_type value;
+
+			/**
+			 * How the join key parts are found. The state of the intersections is kept after the iteration, so that its
+			 * buffers are reused when the iterator is loaded again.
+			 */
+			enum struct Strategy {
+				diagonals,
+				bitmap_intersection,
+				sorted_intersection
+			};
+			Strategy strategy = Strategy::diagonals;
+
+			/**
+			 * The intersection of the operands' key parts if all joined operands are depth 1 bitmap-backed nodes.
+			 */
+			struct BitmapIntersection {
+				// ordered by size, the smallest first
+				std::pmr::vector<const bitmap_type *> bitmaps;
+				std::pmr::vector<key_part_type> key_parts;
+				size_t pos = 0;
+
+				explicit BitmapIntersection(std::pmr::memory_resource *memory) : bitmaps(memory), key_parts(memory) {}
+			};
+			BitmapIntersection bitmap_intersection;
+
+			/**
+			 * The sorted key parts of the operands if all joined operands are depth 1 nodes. They are intersected batch-wise.
+			 */
+			struct SortedIntersection {
+				/**
+				 * Number of key parts of the smallest operand that are intersected at once.
+				 */
+				static constexpr const size_t batch_size = 1024;
+				// ordered by size, the smallest first. The inner vectors use the memory resource of the outer one.
+				std::pmr::vector<std::pmr::vector<key_part_type>> key_parts;
+				std::pmr::vector<size_t> cursors;
+				std::pmr::vector<key_part_type> batch;
+				size_t batch_pos = 0;
+
+				explicit SortedIntersection(std::pmr::memory_resource *memory) : key_parts(memory), cursors(memory), batch(memory) {}
+			};
+			SortedIntersection sorted_intersection;
+			/**
+			 * The sorted intersection is only used if the largest joined operand is at most this many times larger than the
+			 * smallest one.
+			 */
+			static constexpr const size_t sorted_intersection_max_ratio = 4;
 
-			bool ended = false;
-
-			value_type value{};
 		public:
-			iterator() = default;
+			iterator() : iterator(std::pmr::get_default_resource()) {}
+
+			/**
+			 * Constructs an ended iterator. It is started with load().
+			 * @param memory the memory resource that the buffers of the iterator, including the operands, are allocated from
+			 */
+			explicit iterator(std::pmr::memory_resource *memory)
+				: pos_in_out(memory), result_depths(memory), ops(memory), value{operands_type(memory), {}},
+				  bitmap_intersection(memory), sorted_intersection(memory) {}
+
+			iterator(const HashJoin &join, std::pmr::memory_resource *memory = std::pmr::get_default_resource())
+				: iterator(memory) {
+				load(join.hypertries, join.positions);
+			}
 
-			iterator(const HashJoin &join) {
-				auto max_op_count = join.hypertries.size();
+			/**
+			 * Starts the iteration of a join. Buffers of a previous iteration are reused, so loading an iterator
+			 * repeatedly does not allocate once their capacity suffices.
+			 * @param hypertries the joined hypertries. They are only read while loading.
+			 * @param positions the join positions in each of the hypertries
+			 */
+			void load(std::span<const const_Hypertrie<tr>> hypertries, const std::vector<poss_type> &positions) {
+				clear();
+				ended = false;
+				if constexpr (tr::has_bitmap_leaves) {
+					if (intersectBitmaps(hypertries, positions))
+						return;
+				}
+				if (intersectSorted(hypertries, positions))
+					return;
+				auto max_op_count = hypertries.size();
 				pos_in_out.reserve(max_op_count);
 				result_depths.reserve(max_op_count);
 				ops.reserve(max_op_count);
+				value.first.reserve(max_op_count);
 
 				pos_type out_pos = 0;
-				for (const auto &[pos, join_poss, hypertrie] : iter::zip(iter::range(join.hypertries.size()), join.positions,
-				                                                   join.hypertries)) {
+				for (const auto &[join_poss, hypertrie] : iter::zip(positions, hypertries)) {
 					if (size(join_poss) > 0) {
 						ops.emplace_back(HashDiagonal<tr>{hypertrie, join_poss});
 						auto result_depth = result_depths.emplace_back(hypertrie.depth() - size(join_poss));
@@ -83,10 +168,49 @@ namespace hypertrie {
 				next(true);
 			}
 
+			/**
+			 * Ends the iteration and releases the operands and diagonals. The buffers are kept.
+			 */
+			void clear() {
+				pos_in_out.clear();
+				result_depths.clear();
+				ops.clear();
+				value.first.clear();
+				strategy = Strategy::diagonals;
+				ended = true;
+			}
+
 			inline void next(bool init = false) {
 
-				// check if the end was reached
-				static bool found;
+				if constexpr (tr::has_bitmap_leaves) {
+					if (strategy == Strategy::bitmap_intersection) {
+						const auto &key_parts = bitmap_intersection.key_parts;
+						auto &pos = bitmap_intersection.pos;
+						if (not init)
+							++pos;
+						if (pos != key_parts.size())
+							value.second = key_parts[pos];
+						else
+							ended = true;
+						return;
+					}
+				}
+
+				if (strategy == Strategy::sorted_intersection) {
+					auto &batch = sorted_intersection.batch;
+					auto &batch_pos = sorted_intersection.batch_pos;
+					if (not init)
+						++batch_pos;
+					while (batch_pos == batch.size()) {
+						if (not nextBatch()) {
+							ended = true;
+							return;
+						}
+					}
+					value.second = batch[batch_pos];
+					return;
+				}
+
 				// _current_key_part is increased if containsAndUpdateLower returns false
 				HashDiagonal<tr> &smallest_operand = ops.front();
 				if (not init and not smallest_operand.ended())
@@ -96,7 +220,7 @@ namespace hypertrie {
 
 					value.second = smallest_operand.currentKeyPart();
 
-					found = true;
+					bool found = true;
 					// iterate all but the first Diagonal
 					for (auto &operand: internal::util::skip<1>(ops)) {
 						if (not operand.find(value.second)) {
@@ -130,13 +254,155 @@ namespace hypertrie {
 				return value;
 			}
 
+			/**
+			 * Accesses the operands of the current key part without copying them.
+			 * @return the operands that remain for the current key part. They are changed when the iterator is forwarded.
+			 */
+			[[nodiscard]] const operands_type &operands() const noexcept {
+				return value.first;
+			}
+
+			[[nodiscard]] key_part_type keyPart() const noexcept {
+				return value.second;
+			}
+
 		private:
+			/**
+			 * If all joined operands are uncompressed depth 1 nodes, their bitmaps are intersected word-parallel up front
+			 * instead of probing every key part of the smallest operand in all other operands. The key parts of the
+			 * intersection are written to a buffer of the iterator, the bitmaps are not copied.
+			 * @return if the bitmap intersection is used
+			 */
+			bool intersectBitmaps(std::span<const const_Hypertrie<tr>> hypertries, const std::vector<poss_type> &positions) {
+				auto &[bitmaps, key_parts, pos] = bitmap_intersection;
+				bitmaps.clear();
+				for (const auto &[join_poss, hypertrie] : iter::zip(positions, hypertries)) {
+					if (size(join_poss) == 0)
+						continue;
+					if (hypertrie.depth() != 1 or hypertrie.size() < 2)
+						return false;
+					const auto &nodec = *reinterpret_cast<const internal::raw::NodeContainer<1, tri> *>(hypertrie.rawNodeContainer());
+					bitmaps.push_back(&nodec.uncompressed().uncompressed_node()->edges(0));
+				}
+				if (bitmaps.empty())
+					return false;
+				std::sort(bitmaps.begin(), bitmaps.end(), [](const auto *left, const auto *right) { return left->size() < right->size(); });
+
+				strategy = Strategy::bitmap_intersection;
+				key_parts.clear();
+				pos = 0;
+				if (bitmaps.size() == 1) {
+					key_parts.insert(key_parts.end(), bitmaps.front()->begin(), bitmaps.front()->end());
+				} else {
+					bitmaps[0]->intersect_into(*bitmaps[1], key_parts);
+					// the intersection is at most as large as the smallest bitmap, so the remaining ones are probed
+					for (const auto *bitmap : internal::util::skip<2>(bitmaps))
+						std::erase_if(key_parts, [&](key_part_type key_part) { return not bitmap->contains(key_part); });
+				}
+				// the operands without join positions stay unchanged during the iteration
+				for (const auto &[join_poss, hypertrie] : iter::zip(positions, hypertries))
+					if (size(join_poss) == 0)
+						value.first.push_back(hypertrie);
+				next(true);
+				return true;
+			}
+
+			/**
+			 * If at least two operands are joined, all of them are uncompressed depth 1 nodes and their sizes differ by at
+			 * most sorted_intersection_max_ratio, their key parts are extracted once into sorted buffers. The join key parts
+			 * are then produced batch-wise by intersecting a batch of the smallest buffer with the others, instead of one
+			 * HashDiagonal::find per candidate and operand.
+			 * Extracting and sorting costs O(n log n) in the size of every operand, while probing costs O(1) per key part of
+			 * the smallest one. So skewed joins, e.g. a small operand with a large slice, are left to the diagonals.
+			 * @return if the sorted intersection is used
+			 */
+			bool intersectSorted(std::span<const const_Hypertrie<tr>> hypertries, const std::vector<poss_type> &positions) {
+				size_t joined_operands = 0;
+				size_t min_size = std::numeric_limits<size_t>::max();
+				size_t max_size = 0;
+				for (const auto &[join_poss, hypertrie] : iter::zip(positions, hypertries)) {
+					if (size(join_poss) == 0)
+						continue;
+					if (hypertrie.depth() != 1 or hypertrie.size() < 2)
+						return false;
+					min_size = std::min(min_size, hypertrie.size());
+					max_size = std::max(max_size, hypertrie.size());
+					++joined_operands;
+				}
+				if (joined_operands < 2 or max_size > min_size * sorted_intersection_max_ratio)
+					return false;
+
+				strategy = Strategy::sorted_intersection;
+				auto &key_parts = sorted_intersection.key_parts;
+				key_parts.resize(joined_operands);
+				size_t joined_operand = 0;
+				for (const auto &[join_poss, hypertrie] : iter::zip(positions, hypertries)) {
+					if (size(join_poss) == 0) {
+						// the operands without join positions stay unchanged during the iteration
+						value.first.push_back(hypertrie);
+						continue;
+					}
+					const auto &nodec = *reinterpret_cast<const internal::raw::NodeContainer<1, tri> *>(hypertrie.rawNodeContainer());
+					const auto &edges = nodec.uncompressed().uncompressed_node()->edges(0);
+					auto &operand_key_parts = key_parts[joined_operand++];
+					operand_key_parts.clear();
+					operand_key_parts.reserve(edges.size());
+					for (const auto &edge : edges) {
+						if constexpr (tr::is_bool_valued)
+							operand_key_parts.push_back(edge);
+						else
+							operand_key_parts.push_back(edge.first);
+					}
+					std::sort(operand_key_parts.begin(), operand_key_parts.end());
+				}
+				std::sort(key_parts.begin(), key_parts.end(), [](const auto &left, const auto &right) { return left.size() < right.size(); });
+				sorted_intersection.cursors.assign(key_parts.size(), 0);
+				sorted_intersection.batch.clear();
+				sorted_intersection.batch.reserve(SortedIntersection::batch_size);
+				sorted_intersection.batch_pos = 0;
+				next(true);
+				return true;
+			}
+
+			/**
+			 * Intersects the next batch of the smallest operand's key parts with the other operands.
+			 * @return false if the smallest operand is exhausted
+			 */
+			bool nextBatch() {
+				using namespace internal::util::sorted_intersection;
+				auto &[key_parts, cursors, batch, batch_pos] = sorted_intersection;
+				const auto &smallest = key_parts.front();
+				if (cursors.front() == smallest.size())
+					return false;
+				const size_t batch_end = std::min(cursors.front() + SortedIntersection::batch_size, smallest.size());
+				batch.assign(smallest.begin() + cursors.front(), smallest.begin() + batch_end);
+				cursors.front() = batch_end;
+				batch_pos = 0;
+				for (size_t op = 1; op < key_parts.size() and not batch.empty(); ++op) {
+					const key_part_type *first = key_parts[op].data() + cursors[op];
+					const key_part_type *last = key_parts[op].data() + key_parts[op].size();
+					// only the key parts up to the last candidate of the batch are relevant for it
+					const key_part_type *bound = gallop(first, last, batch.back());
+					if (bound != last and *bound == batch.back())
+						++bound;
+					batch.resize(intersect<key_part_type>(batch, {first, bound}, batch.data()));
+					cursors[op] = size_t(bound - key_parts[op].data());
+				}
+				return true;
+			}
+
+			/**
+			 * Orders the operands by their diagonal size, the smallest first. Insertion sort is used, as there are only few
+			 * operands and it sorts in place.
+			 */
 			void optimizeOperandOrder() {
-				using namespace internal::util;
-				const auto permutation = sort_permutation::get<HashDiagonal<tr>>(ops);
-				sort_permutation::apply(ops, permutation);
-				sort_permutation::apply(pos_in_out, permutation);
-				sort_permutation::apply(result_depths, permutation);
+				for (size_t i = 1; i < ops.size(); ++i) {
+					for (size_t j = i; j > 0 and ops[j] < ops[j - 1]; --j) {
+						std::swap(ops[j], ops[j - 1]);
+						std::swap(pos_in_out[j], pos_in_out[j - 1]);
+						std::swap(result_depths[j], result_depths[j - 1]);
+					}
+				}
 			}
 
 		};
@@ -10,6 +10,7 @@
 
 #include "Dice/hypertrie/internal/util/CONSTANTS.hpp"
 #include <optional>
+#include <span>
 #include <variant>
 #include <vector>
 #include <itertools.hpp>
@@ -37,6 +38,11 @@ namespace hypertrie {
 
 		size_t depth_ = 0;
 
+		/**
+		 * If true, this const_Hypertrie holds a reference on its root node (see Hypertrie::snapshot()).
+		 */
+		bool pinned_ = false;
+
 		const_Hypertrie(size_t depth, HypertrieContext<tr> *context, NodeContainer node_container = {}) : node_container_(std::move(node_container)), context_(context), depth_(depth) {}
 
 		constexpr bool contextless() const noexcept {
@@ -45,6 +51,14 @@ namespace hypertrie {
 
 		friend class HashDiagonal<tr>;
 
+		friend class SliceCache<tr>;
+
+		friend class HypertrieCheckpoint<tr>;
+
+		friend class Hypertrie<tr>;
+
+		template<size_t, HypertrieTrait>
+		friend class const_StaticHypertrie;
 
 		void destruct_contextless_node() noexcept {
 			if (contextless() and node_container_.hash_sized != 0) {
@@ -57,7 +71,7 @@ namespace hypertrie {
 						[&](auto depth_arg) {
 						  using CND = typename internal::raw::template CompressedNodeContainer<depth_arg, tri>;
 						  if constexpr (not(depth_arg == 1 and tri::is_bool_valued and tri::is_lsb_unused))
-							  delete reinterpret_cast<CND *>(&this->node_container_)->compressed_node();
+							  internal::raw::ContextlessNodePool<depth_arg, tri>::release(reinterpret_cast<CND *>(&this->node_container_)->compressed_node());
 						},
 						[]() { assert(false); });
 			}
@@ -73,47 +87,122 @@ namespace hypertrie {
 						  if constexpr (not(depth_arg == 1 and tri::is_bool_valued and tri::is_lsb_unused)) {
 							  // create a copy of the contextless compressed node
 							  CNodec &cnodec = *reinterpret_cast<CNodec *>(&this->node_container_);
-							  cnodec.compressed_node() = new internal::raw::CompressedNode<depth_arg, tri>{*cnodec.compressed_node()};;
+							  cnodec.compressed_node() = internal::raw::ContextlessNodePool<depth_arg, tri>::acquire(*cnodec.compressed_node());
 						  }
 						},
 						[]() { assert(false); });
 			}
 		}
+
+		void incRefCount() {
+			if (not contextless() and not empty())
+				internal::compiled_switch<hypertrie_depth_limit, 1>::switch_void(
+						this->depth_,
+						[&](auto depth_arg) {
+							auto &typed_nodec = *reinterpret_cast<internal::raw::NodeContainer<depth_arg, tri> *>(&this->node_container_);
+							this->context_->rawContext().template incRefCount<depth_arg>(typed_nodec);
+						});
+		}
+
+		void decrRefCount() {
+			if (not contextless() and not empty())
+				internal::compiled_switch<hypertrie_depth_limit, 1>::switch_void(
+						this->depth_,
+						[&](auto depth_arg) {
+							auto &typed_nodec = *reinterpret_cast<internal::raw::NodeContainer<depth_arg, tri> *>(&this->node_container_);
+							this->context_->rawContext().template decrRefCount<depth_arg>(typed_nodec);
+						});
+		}
+
+		/**
+		 * Keeps the root node in memory when nodes are evicted (see HypertrieContext::evictNodes()). A pinned
+		 * const_Hypertrie holds its root node by pointer, so the root must not be paged out while it is pinned.
+		 */
+		void holdRoot() {
+			if (not contextless() and not empty())
+				this->context_->rawContext().storage.holdRoot(this->depth_, this->node_container_.hash_sized);
+		}
+
+		void releaseRoot() {
+			if (not contextless() and not empty())
+				this->context_->rawContext().storage.releaseRoot(this->depth_, this->node_container_.hash_sized);
+		}
+
+		/**
+		 * Makes this const_Hypertrie hold a reference on its root node (see Hypertrie::snapshot()).
+		 */
+		void pin() {
+			pinned_ = true;
+			incRefCount();
+			holdRoot();
+		}
+
+		/**
+		 * Releases the node of this const_Hypertrie. A pinned node is unreferenced, a contextless node is deleted.
+		 */
+		void release_node() {
+			if (pinned_) {
+				releaseRoot();
+				decrRefCount();
+			} else
+				destruct_contextless_node();
+		}
+
+		/**
+		 * Acquires the node after this const_Hypertrie was copied from another one. A pinned node is referenced once more, a contextless node is copied.
+		 */
+		void acquire_node() {
+			if (pinned_) {
+				incRefCount();
+				holdRoot();
+			} else
+				copy_contextless_node();
+		}
+
 	public:
 		~const_Hypertrie() {
-			destruct_contextless_node();
+			release_node();
 		}
 
 		const_Hypertrie(const_Hypertrie &&const_hypertrie)
-				: node_container_(const_hypertrie.node_container_), context_(const_hypertrie.context_), depth_(const_hypertrie.depth_) {
+				: node_container_(const_hypertrie.node_container_), context_(const_hypertrie.context_), depth_(const_hypertrie.depth_), pinned_(const_hypertrie.pinned_) {
 			const_hypertrie.node_container_ = {};
 			const_hypertrie.context_ = nullptr;
+			const_hypertrie.pinned_ = false;
 		}
 
 		const_Hypertrie &operator=(const const_Hypertrie &const_hypertrie) noexcept {
-			destruct_contextless_node();
+			if (this == &const_hypertrie)
+				return *this;
+			release_node();
 			this->node_container_ = const_hypertrie.node_container_;
 			this->context_ = const_hypertrie.context_;
 			this->depth_ = const_hypertrie.depth_;
-			copy_contextless_node();
+			this->pinned_ = const_hypertrie.pinned_;
+			acquire_node();
 
 			return *this;
 		}
 
 
 		const_Hypertrie &operator=(const_Hypertrie &&const_hypertrie) noexcept {
+			if (this == &const_hypertrie)
+				return *this;
+			release_node();
 			this->node_container_ = const_hypertrie.node_container_;
 			this->context_ = const_hypertrie.context_;
 			this->depth_ = const_hypertrie.depth_;
+			this->pinned_ = const_hypertrie.pinned_;
 			const_hypertrie.context_ = nullptr;
 			const_hypertrie.node_container_.hash_sized = 0;
 			const_hypertrie.node_container_.pointer_sized = nullptr;
+			const_hypertrie.pinned_ = false;
 			return *this;
 		}
 
 		const_Hypertrie(const const_Hypertrie &const_hypertrie)
-			: node_container_(const_hypertrie.node_container_), context_(const_hypertrie.context_), depth_(const_hypertrie.depth_) {
-			copy_contextless_node();
+			: node_container_(const_hypertrie.node_container_), context_(const_hypertrie.context_), depth_(const_hypertrie.depth_), pinned_(const_hypertrie.pinned_) {
+			acquire_node();
 		}
 
 		const_Hypertrie() = default;
@@ -135,6 +224,25 @@ namespace hypertrie {
 			return depth_;
 		}
 
+		/**
+		 * @return true if this const_Hypertrie keeps its nodes alive via reference counting, i.e. it is a snapshot.
+		 */
+		bool pinned() const noexcept {
+			return pinned_;
+		}
+
+		/**
+		 * @return a copy that holds a reference on the root node like a snapshot (see Hypertrie::snapshot()), so its nodes
+		 * stay alive while the hypertrie it was taken from is modified. Contextless and pinned hypertries are copied as they are.
+		 */
+		[[nodiscard]] const_Hypertrie pinnedCopy() const {
+			if (pinned_ or contextless())
+				return *this;
+			const_Hypertrie copy{this->depth_, this->context_, this->node_container_};
+			copy.pin();
+			return copy;
+		}
+
 		size_t hash() const {
 			return node_container_.hash_sized.hash();
 		}
@@ -144,6 +252,8 @@ namespace hypertrie {
 
 		using Key = typename tr::Key;
 		using SliceKey = typename tr::SliceKey;
+		using CompactSliceKey = typename tr::CompactSliceKey;
+		using key_part_type = typename tr::key_part_type;
 		using value_type = typename tr::value_type;
 
 		[[nodiscard]] size_t size() const{
@@ -167,9 +277,18 @@ namespace hypertrie {
 		}
 
 		[[nodiscard]] value_type operator[](const Key &key) const {
+			return this->operator[](std::span<const key_part_type>{key});
+		}
+
+		/**
+		 * Looks up a key without requiring a Key vector, e.g. from a std::array or a part of a larger buffer.
+		 * @param key a key of size depth()
+		 */
+		[[nodiscard]] value_type operator[](std::span<const key_part_type> key) const {
+			assert(key.size() == depth());
 			return internal::compiled_switch<hypertrie_depth_limit, 1>::switch_(
 					this->depth_,
-					[&](auto depth_arg) mutable -> bool {
+					[&](auto depth_arg) mutable -> value_type {
 						RawKey<depth_arg> raw_key;
 						std::copy_n(key.begin(), depth_arg, raw_key.begin());
 						const auto &node_container = *reinterpret_cast<const internal::raw::NodeContainer<depth_arg, tri> *>(&this->node_container_);
@@ -177,45 +296,62 @@ namespace hypertrie {
 								node_container,
 								raw_key);
 					},
-					[]() -> bool { assert(false); return {}; });
+					[]() -> value_type { assert(false); return {}; });
 		}
 
-
 		[[nodiscard]] std::variant<const_Hypertrie, value_type> operator[](const SliceKey &slice_key) const {
-			assert(slice_key.size() == depth());
-			const size_t fixed_depth = tri::sliceKeyFixedDepth(slice_key);
+			return this->operator[](CompactSliceKey{slice_key});
+		}
+
+		/**
+		 * Slices without allocating a slice key. The fixed depth is taken from the bitmask of the compact slice key.
+		 * If the context has a slice cache and it is not bypassed on this thread (see SliceCacheBypass), the result is looked up there first.
+		 */
+		[[nodiscard]] std::variant<const_Hypertrie, value_type> operator[](const CompactSliceKey &slice_key) const {
+			assert(slice_key.depth() == depth());
+			const size_t fixed_depth = slice_key.fixedDepth();
 
 			if (fixed_depth == depth()) {
-				Key key(slice_key.size());
-				for (auto [key_part, slice_key_part] : iter::zip(key, slice_key))
-					key_part = slice_key_part.value();
-				return this->operator[](key);
+				return this->operator[](slice_key.fixedKeyParts());
 			} else if (fixed_depth == 0) {
 				return const_Hypertrie(*this);
-			} else {
-				const_Hypertrie<tr> result{depth_ - fixed_depth};
-				internal::compiled_switch<hypertrie_depth_limit, 1>::switch_void(
-						this->depth_,
-						[&](auto depth_arg) {
-						  internal::compiled_switch<depth_arg, 1>::switch_void(
-									fixed_depth,
-									[&](auto slice_key_depth_arg) {
-										RawSliceKey<slice_key_depth_arg> raw_slice_key(slice_key);
-
-										const auto &node_container = *reinterpret_cast<const internal::raw::NodeContainer<depth_arg, tri> *>(&this->node_container_);
-
-										auto [node_cont, is_managed] = this->context()->rawContext().template slice<depth_arg, slice_key_depth_arg>(node_container, raw_slice_key);
-										if (not node_cont.empty())
-											result = const_Hypertrie<tr>(
-													depth_arg - slice_key_depth_arg,
-													(is_managed) ? this->context() : nullptr,
-													{node_cont.hash().hash(), node_cont.node()});
-									});
-						});
+			} else if (SliceCache<tr> *cache = (contextless() or SliceCacheBypass::active()) ? nullptr : this->context()->sliceCache(); cache != nullptr) {
+				if (auto cached = cache->get(*this, slice_key); cached.has_value())
+					return std::move(cached.value());
+				const_Hypertrie<tr> result = slice(slice_key);
+				cache->put(*this, slice_key, result);
 				return result;
+			} else {
+				return slice(slice_key);
 			}
 		}
 
+	private:
+		const_Hypertrie slice(const CompactSliceKey &slice_key) const {
+			const size_t fixed_depth = slice_key.fixedDepth();
+			const_Hypertrie<tr> result{depth_ - fixed_depth};
+			internal::compiled_switch<hypertrie_depth_limit, 1>::switch_void(
+					this->depth_,
+					[&](auto depth_arg) {
+					  internal::compiled_switch<depth_arg, 1>::switch_void(
+								fixed_depth,
+								[&](auto slice_key_depth_arg) {
+									RawSliceKey<slice_key_depth_arg> raw_slice_key(slice_key);
+
+									const auto &node_container = *reinterpret_cast<const internal::raw::NodeContainer<depth_arg, tri> *>(&this->node_container_);
+
+									auto [node_cont, is_managed] = this->context()->rawContext().template slice<depth_arg, slice_key_depth_arg>(node_container, raw_slice_key);
+									if (not node_cont.empty())
+										result = const_Hypertrie<tr>(
+												depth_arg - slice_key_depth_arg,
+												(is_managed) ? this->context() : nullptr,
+												{node_cont.hash().hash(), node_cont.node()});
+								});
+					});
+			return result;
+		}
+
+	public:
 		[[nodiscard]]
 		std::vector<size_t> getCards(const std::vector<pos_type> &positions) const {
 			assert(positions.size() <= depth());
@@ -284,6 +420,7 @@ namespace hypertrie {
 		using traits = tr;
 		using tri = internal::raw::Hypertrie_internal_t<tr>;
 		using Key = typename tr::Key;
+		using key_part_type = typename tr::key_part_type;
 		using value_type = typename tr::value_type;
 
 	private:
@@ -295,6 +432,15 @@ namespace hypertrie {
 
 	public:
 		value_type set(const Key &key, value_type value) {
+			return this->set(std::span<const key_part_type>{key}, value);
+		}
+
+		/**
+		 * Sets a key without requiring a Key vector, e.g. from a std::array.
+		 * @param key a key of size depth()
+		 */
+		value_type set(std::span<const key_part_type> key, value_type value) {
+			assert(key.size() == this->depth());
 			return internal::compiled_switch<hypertrie_depth_limit, 1>::switch_(
 					this->depth_,
 					[&](auto depth_arg) -> value_type {
@@ -307,26 +453,18 @@ namespace hypertrie {
 		}
 
 		Hypertrie(const Hypertrie<tr> &hypertrie) : const_Hypertrie<tr>(hypertrie) {
-			if (not this->empty())
-				internal::compiled_switch<hypertrie_depth_limit, 1>::switch_void(
-						this->depth_,
-						[&](auto depth_arg){
-						  auto &typed_nodec = *reinterpret_cast<internal::raw::NodeContainer<depth_arg, tri> *>(&this->node_container_);
-						  this->context_->rawContext().template incRefCount<depth_arg>(typed_nodec);
-						}
-				);
+			this->incRefCount();
 		}
 
 		Hypertrie(const const_Hypertrie<tr> &hypertrie) : const_Hypertrie<tr>(hypertrie) {
 			if (hypertrie.contextless()) // TODO: add copying contextless hypertries
 				throw std::logic_error{"Copying contextless const_Hypertries is not yet supported."};
+			else if (this->pinned_) { // the reference acquired by copying a snapshot is taken over, the root may be evicted again
+				this->releaseRoot();
+				this->pinned_ = false;
+			}
 			else
-				internal::compiled_switch<hypertrie_depth_limit, 1>::switch_void(
-						this->depth_,
-						[&](auto depth_arg){
-							auto &typed_nodec = *reinterpret_cast<internal::raw::NodeContainer<depth_arg, tri> *>(&this->node_container_);
-							this->context_->rawContext().template incRefCount<depth_arg>(typed_nodec);}
-						);
+				this->incRefCount();
 		}
 
 		Hypertrie(Hypertrie<tr> &&other) : const_Hypertrie<tr>(other) {
@@ -336,18 +474,23 @@ namespace hypertrie {
 
 
 		~Hypertrie() {
-			if (not this->empty())
-				internal::compiled_switch<hypertrie_depth_limit, 1>::switch_void(
-						this->depth_,
-						[&](auto depth_arg){
-							auto &typed_nodec = *reinterpret_cast<internal::raw::NodeContainer<depth_arg, tri> *>(&this->node_container_);
-							this->context_->rawContext().template decrRefCount<depth_arg>(typed_nodec);
-						}
-				);
+			this->decrRefCount();
 		}
 
 		Hypertrie(size_t depth = 1, HypertrieContext<tr> &context = DefaultHypertrieContext<tr>::instance())
 			: const_Hypertrie<tr>(depth, &context) {}
+
+		/**
+		 * Creates an immutable snapshot of the current version of this Hypertrie.
+		 * Nodes are stored hash-addressed and reference counted. The snapshot holds a reference on the current root node,
+		 * so all nodes reachable from it are kept alive while this Hypertrie is modified. No data is copied.
+		 * @return a pinned const_Hypertrie
+		 */
+		[[nodiscard]] const_Hypertrie<tr> snapshot() const {
+			const_Hypertrie<tr> snapshot{this->depth_, this->context_, this->node_container_};
+			snapshot.pin();
+			return snapshot;
+		}
 	};
 
 }
@@ -3,6 +3,7 @@
 
 
 #include "Dice/hypertrie/internal/ConfigHypertrieDepthLimit.hpp"
+#include "Dice/hypertrie/internal/SliceCache.hpp"
 #include "Dice/hypertrie/internal/raw/storage/NodeContext.hpp"
 #include "Dice/hypertrie/internal/util/SwitchTemplateFunctions.hpp"
 #include <fmt/format.h>
@@ -11,6 +12,9 @@
 
 namespace hypertrie {
 
+	using NodePagingConfig = internal::raw::NodePagingConfig;
+	using NumaPlacement = internal::util::NumaPlacement;
+
 	template<HypertrieTrait tr = default_bool_Hypertrie_t>
 	class HypertrieContext {
 	private:
@@ -21,16 +25,83 @@ namespace hypertrie {
 	public:
 		NodeContext raw_context{};
 
+	private:
+		/**
+		 * Declared after raw_context, so cached nodes are released before the storage is destroyed.
+		 */
+		std::unique_ptr<SliceCache<tr>> slice_cache_;
+
 	public:
 
 		HypertrieContext(){}
 
+		/**
+		 * @param slice_cache_capacity capacity of the slice cache, see enableSliceCache()
+		 */
+		explicit HypertrieContext(size_t slice_cache_capacity) {
+			enableSliceCache(slice_cache_capacity);
+		}
+
 		constexpr size_t depth() const {
 			return depth_;
 		}
 		NodeContext &rawContext() {
 			return raw_context;
 		}
+
+		/**
+		 * Caches up to capacity results of slicing hypertries of this context. A previously enabled cache is dropped.
+		 * While the cache is enabled, the hypertries of this context must only be sliced by a single thread unless the other
+		 * threads bypass the cache (see SliceCache).
+		 */
+		void enableSliceCache(size_t capacity) {
+			slice_cache_ = std::make_unique<SliceCache<tr>>(capacity);
+		}
+
+		void disableSliceCache() {
+			slice_cache_.reset();
+		}
+
+		/**
+		 * @return the slice cache or nullptr if it is not enabled
+		 */
+		SliceCache<tr> *sliceCache() noexcept {
+			return slice_cache_.get();
+		}
+
+		/**
+		 * Keeps the nodes of depths below config.pinned_depth in a page file on disk, so hypertries may be larger than
+		 * memory. Nodes are evicted by evictNodes() and read back when they are accessed.
+		 */
+		void enableNodePaging(const NodePagingConfig &config) {
+			raw_context.storage.enablePaging(config);
+		}
+
+		/**
+		 * Sets on which NUMA nodes the nodes created by later bulk loads (BulkInserter, bulk_insert) of hypertries of this
+		 * context are allocated. With NumaPlacement::partitioned, the nodes of the entries with the same first key part are
+		 * allocated on the same NUMA node, which parallel_for_each() can exploit with pin_to_numa_nodes. The placement is
+		 * best-effort, see internal::util::ScopedMemoryPolicy.
+		 */
+		void setNumaPlacement(NumaPlacement placement) noexcept {
+			raw_context.storage.setNumaPlacement(placement);
+		}
+
+		/**
+		 * Evicts the least recently used nodes of depths below NodePagingConfig::pinned_depth until at most
+		 * NodePagingConfig::max_resident_nodes of them are in memory. The slice cache is cleared before.
+		 *
+		 * Must not be called concurrently with any other operation on the context. Pinned const_Hypertries, i.e. snapshots,
+		 * const_StaticHypertries and the operands of a Diff, stay valid: their root nodes are not evicted and the nodes below
+		 * are read back by hash. Iterators and unpinned slices of hypertries of the context are invalidated, as they are by
+		 * modifying a hypertrie.
+		 * @return number of evicted nodes
+		 */
+		size_t evictNodes() {
+			if (slice_cache_)
+				slice_cache_->clear();
+			return raw_context.storage.evict();
+		}
 	};
 
 	template<HypertrieTrait tr>
@@ -11,6 +11,18 @@ namespace hypertrie {
 	template<HypertrieTrait tr = default_bool_Hypertrie_t>
 	class Hypertrie;
 
+	template<size_t depth, HypertrieTrait tr = default_bool_Hypertrie_t>
+	class const_StaticHypertrie;
+
+	template<size_t depth, HypertrieTrait tr = default_bool_Hypertrie_t>
+	class StaticHypertrie;
+
+	template<HypertrieTrait tr>
+	class SliceCache;
+
+	template<HypertrieTrait tr>
+	class HypertrieCheckpoint;
+
 }
 
 
@@ -9,15 +9,70 @@
 #include <boost/type_index.hpp>
 
 #include "Dice/hypertrie/internal/container/AllContainer.hpp"
+#include "Dice/hypertrie/internal/util/CompactSliceKey.hpp"
 #include "Dice/hypertrie/internal/util/Key.hpp"
 
 namespace hypertrie {
 
+	/**
+	 * Selects the containers of a hypertrie per depth. The edges of a node of depth `depth` are stored in
+	 * edges_map_type<depth, key_part_type, child> (edges_set_type<depth, key_part_type> for boolean depth 1 nodes).
+	 * The nodes of depth `depth` are stored in storage_map_type<depth, TensorHash, node pointer>.
+	 *
+	 * uniform_containers uses the same map and set type for every depth, for node edges and node storage alike.
+	 */
+	template<template<typename, typename> class map_type_t, template<typename> class set_type_t>
+	struct uniform_containers {
+		template<size_t depth, typename key, typename value>
+		using edges_map_type = map_type_t<key, value>;
+		template<size_t depth, typename key>
+		using edges_set_type = set_type_t<key>;
+		template<size_t depth, typename key, typename value>
+		using storage_map_type = map_type_t<key, value>;
+	};
+
+	/**
+	 * Uses the containers of lower_containers for depths up to max_lower_depth and those of upper_containers above.
+	 */
+	template<size_t max_lower_depth, typename lower_containers, typename upper_containers>
+	struct depth_split_containers {
+	private:
+		template<size_t depth>
+		using containers = std::conditional_t<(depth <= max_lower_depth), lower_containers, upper_containers>;
+
+	public:
+		template<size_t depth, typename key, typename value>
+		using edges_map_type = typename containers<depth>::template edges_map_type<depth, key, value>;
+		template<size_t depth, typename key>
+		using edges_set_type = typename containers<depth>::template edges_set_type<depth, key>;
+		template<size_t depth, typename key, typename value>
+		using storage_map_type = typename containers<depth>::template storage_map_type<depth, key, value>;
+	};
+
+	/**
+	 * Uses the edge containers of edges_containers and the storage containers of storage_containers.
+	 */
+	template<typename edges_containers, typename storage_containers>
+	struct edges_storage_containers {
+		template<size_t depth, typename key, typename value>
+		using edges_map_type = typename edges_containers::template edges_map_type<depth, key, value>;
+		template<size_t depth, typename key>
+		using edges_set_type = typename edges_containers::template edges_set_type<depth, key>;
+		template<size_t depth, typename key, typename value>
+		using storage_map_type = typename storage_containers::template storage_map_type<depth, key, value>;
+	};
+
+	/**
+	 * @tparam map_type_t map used by default, i.e. on all depths unless containers_t says otherwise
+	 * @tparam set_type_t set used by default, i.e. on all depths unless containers_t says otherwise
+	 * @tparam containers_t per-depth selection of the containers for node edges and node storage, see uniform_containers
+	 */
 	template<typename key_part_type_t = unsigned long,
 			 typename value_type_t = bool,
 			 template<typename, typename> class map_type_t = hypertrie::internal::container::tsl_sparse_map,
 			 template<typename> class set_type_t = hypertrie::internal::container::tsl_sparse_set,
-			 bool lsb_unused_v = false>
+			 bool lsb_unused_v = false,
+			 typename containers_t = uniform_containers<map_type_t, set_type_t>>
 	struct Hypertrie_t {
 		using key_part_type = key_part_type_t;
 		using value_type = value_type_t;
@@ -26,11 +81,24 @@ namespace hypertrie {
 		template<typename key>
 		using set_type = set_type_t<key>;
 
+		using containers = containers_t;
+		template<size_t depth, typename key, typename value>
+		using edges_map_type = typename containers::template edges_map_type<depth, key, value>;
+		template<size_t depth, typename key>
+		using edges_set_type = typename containers::template edges_set_type<depth, key>;
+		template<size_t depth, typename key, typename value>
+		using storage_map_type = typename containers::template storage_map_type<depth, key, value>;
+
 		using SliceKey = ::hypertrie::SliceKey<key_part_type>;
+		using CompactSliceKey = ::hypertrie::CompactSliceKey<key_part_type>;
 		using Key = ::hypertrie::Key<key_part_type>;
 
 		static constexpr const bool is_bool_valued = std::is_same_v<value_type, bool>;
 		static constexpr const bool lsb_unused = lsb_unused_v;
+		/**
+		 * The edges of depth 1 nodes are stored in roaring bitmaps. Joins on such nodes intersect the bitmaps.
+		 */
+		static constexpr const bool has_bitmap_leaves = is_bool_valued and internal::container::is_roaring_bitmap_set_v<edges_set_type<1, key_part_type>>;
 
 		using IteratorEntry = std::conditional_t<(is_bool_valued), Key, std::pair<Key, value_type>>;
 
@@ -62,12 +130,13 @@ namespace hypertrie {
 	public:
 		static auto to_string() {
 			return std::string{fmt::format(
-					"< key_part = {}, value = {}, map = {}, set = {}, lsb_unused = {} >",
+					"< key_part = {}, value = {}, map = {}, set = {}, lsb_unused = {}, containers = {} >",
 					nameOfType<key_part_type>(),
 					nameOfType<value_type>(),
 					nameOfType<map_type<key_part_type, value_type>>(),
 					nameOfType<set_type<key_part_type>>(),
-					lsb_unused)};
+					lsb_unused,
+					nameOfType<containers>())};
 		}
 	};
 
@@ -76,7 +145,8 @@ namespace hypertrie {
 									  typename,
 									  template<typename, typename> class,
 									  template<typename> class,
-									  bool>
+									  bool,
+									  typename>
 							 typename U>
 		struct is_instance_impl : public std::false_type {
 		};
@@ -85,21 +155,24 @@ namespace hypertrie {
 						  typename,
 						  template<typename, typename> class,
 						  template<typename> class,
-						  bool>
+						  bool,
+						  typename>
 				 typename U,
 				 typename key_part_type_t,
 				 typename value_type_t,
 				 template<typename, typename> class map_type_t,
 				 template<typename> class set_type_t,
-				bool lsb_unused_v>
-		struct is_instance_impl<U<key_part_type_t, value_type_t, map_type_t, set_type_t, lsb_unused_v>, U> : public std::true_type {
+				 bool lsb_unused_v,
+				 typename containers_t>
+		struct is_instance_impl<U<key_part_type_t, value_type_t, map_type_t, set_type_t, lsb_unused_v, containers_t>, U> : public std::true_type {
 		};
 
 		template<typename T, template<typename,
 									  typename,
 									  template<typename, typename> class,
 									  template<typename> class,
-									  bool>
+									  bool,
+									  typename>
 							 typename U>
 		using is_instance = is_instance_impl<std::decay_t<T>, U>;
 	}// namespace internal::hypertrie_trait
@@ -118,6 +191,34 @@ namespace hypertrie {
 												   hypertrie::internal::container::tsl_sparse_set,
 												   true>;
 
+	using bitmap_bool_Hypertrie_t = Hypertrie_t<unsigned long,
+												bool,
+												hypertrie::internal::container::tsl_sparse_map,
+												hypertrie::internal::container::roaring_bitmap_set>;
+
+	using swiss_bool_Hypertrie_t = Hypertrie_t<unsigned long,
+											   bool,
+											   hypertrie::internal::container::swiss_map,
+											   hypertrie::internal::container::swiss_set>;
+
+	/**
+	 * Root-level edge maps are large and probed randomly, so depths above 1 and the node storage use Swiss tables.
+	 * The edges of depth 1 nodes are small and numerous, they stay in memory-optimized sparse sets.
+	 */
+	using depth_tuned_bool_Hypertrie_t = Hypertrie_t<unsigned long,
+													 bool,
+													 hypertrie::internal::container::tsl_sparse_map,
+													 hypertrie::internal::container::tsl_sparse_set,
+													 false,
+													 edges_storage_containers<
+															 depth_split_containers<1,
+																					uniform_containers<hypertrie::internal::container::tsl_sparse_map,
+																									   hypertrie::internal::container::tsl_sparse_set>,
+																					uniform_containers<hypertrie::internal::container::swiss_map,
+																									   hypertrie::internal::container::swiss_set>>,
+															 uniform_containers<hypertrie::internal::container::swiss_map,
+																				hypertrie::internal::container::swiss_set>>>;
+
 	using default_long_Hypertrie_t = Hypertrie_t<unsigned long,
 												 long,
 												 hypertrie::internal::container::tsl_sparse_map,
@@ -0,0 +1,149 @@
+#ifndef HYPERTRIE_ORDEREDITERATOR_HPP
+#define HYPERTRIE_ORDEREDITERATOR_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "Dice/hypertrie/internal/HashDiagonal.hpp"
+#include "Dice/hypertrie/internal/Hypertrie.hpp"
+
+namespace hypertrie {
+
+	/**
+	 * Iterates the entries of a hypertrie in lexicographic order of their keys, where the key positions are compared in the
+	 * order given by a permutation. E.g. for a depth 3 hypertrie of (s, p, o) triples, the permutation {1, 2, 0} yields the
+	 * entries sorted by (p, o, s). The yielded keys keep their original position order.
+	 *
+	 * The hypertrie is traversed depth-first. At each visited node, the key parts of the edges at the next position of the
+	 * permutation are sorted when the node is entered. So the memory is bounded by depth × max fan-out and not by the number of entries.
+	 * @tparam tr_t HypertrieTrait
+	 */
+	template<HypertrieTrait tr_t = default_bool_Hypertrie_t>
+	class OrderedIterator {
+	public:
+		using tr = tr_t;
+		using key_part_type = typename tr::key_part_type;
+		using Key = typename tr::Key;
+		using KeyPositions = typename tr::KeyPositions;
+		using self_type = OrderedIterator;
+		using value_type = typename tr::IteratorEntry;
+
+	private:
+		/**
+		 * A visited node with the sorted key parts at its position of the permutation.
+		 * Frames are heap allocated and never moved, because diagonal refers to node.
+		 */
+		struct Frame {
+			const_Hypertrie<tr> node;
+			HashDiagonal<tr> diagonal;
+			std::vector<key_part_type> key_parts;
+			size_t next = 0;
+
+			Frame(const_Hypertrie<tr> node, pos_type pos)
+				: node(std::move(node)), diagonal(this->node, std::array<pos_type, 1>{pos}) {
+				key_parts.reserve(diagonal.size());
+				for (diagonal.begin(); not diagonal.ended(); ++diagonal)
+					key_parts.push_back(diagonal.currentKeyPart());
+				std::sort(key_parts.begin(), key_parts.end());
+			}
+		};
+
+		KeyPositions permutation_;
+		/**
+		 * node_positions_[level] is the position within the node at level that corresponds to permutation_[level].
+		 */
+		KeyPositions node_positions_;
+		std::vector<std::unique_ptr<Frame>> frames_;
+		value_type entry_;
+		bool ended_ = true;
+
+		Key &key() noexcept {
+			if constexpr (tr::is_bool_valued) return entry_;
+			else
+				return entry_.first;
+		}
+
+		static KeyPositions nodePositions(const KeyPositions &permutation) {
+			KeyPositions node_positions(permutation.size());
+			for (size_t level = 0; level < permutation.size(); ++level) {
+				// positions that were resolved before and precede this position are not part of the node anymore
+				const auto removed_before = std::count_if(permutation.begin(), permutation.begin() + level,
+														  [&](pos_type pos) { return pos < permutation[level]; });
+				node_positions[level] = pos_type(permutation[level] - removed_before);
+			}
+			return node_positions;
+		}
+
+		/**
+		 * Moves to the next entry in depth-first order.
+		 */
+		void advance() {
+			while (not frames_.empty()) {
+				Frame &frame = *frames_.back();
+				if (frame.next == frame.key_parts.size()) {
+					frames_.pop_back();
+					continue;
+				}
+				const size_t level = frames_.size() - 1;
+				const key_part_type key_part = frame.key_parts[frame.next++];
+				key()[permutation_[level]] = key_part;
+				[[maybe_unused]] const bool found = frame.diagonal.find(key_part);
+				assert(found);
+				if (level + 1 == permutation_.size()) {
+					if constexpr (not tr::is_bool_valued)
+						entry_.second = frame.diagonal.currentScalar();
+					return;
+				}
+				frames_.push_back(std::make_unique<Frame>(frame.diagonal.currentHypertrie(), node_positions_[level + 1]));
+			}
+			ended_ = true;
+		}
+
+	public:
+		OrderedIterator() = default;
+
+		/**
+		 * @param hypertrie the hypertrie to iterate
+		 * @param permutation the order in which the key positions are compared, e.g. {1, 2, 0}
+		 * @throws std::invalid_argument if permutation is not a permutation of the positions of hypertrie
+		 */
+		OrderedIterator(const const_Hypertrie<tr> &hypertrie, KeyPositions permutation)
+			: permutation_(std::move(permutation)) {
+			KeyPositions sorted = permutation_;
+			std::sort(sorted.begin(), sorted.end());
+			for (size_t pos = 0; pos < sorted.size(); ++pos)
+				if (sorted[pos] != pos)
+					throw std::invalid_argument{"The positions are not a permutation of the hypertrie's positions."};
+			if (permutation_.size() != hypertrie.depth())
+				throw std::invalid_argument{"The positions are not a permutation of the hypertrie's positions."};
+
+			if (hypertrie.empty())
+				return;
+			node_positions_ = nodePositions(permutation_);
+			frames_.reserve(hypertrie.depth());
+			key().resize(hypertrie.depth());
+			ended_ = false;
+			frames_.push_back(std::make_unique<Frame>(hypertrie, node_positions_[0]));
+			advance();
+		}
+
+		self_type &operator++() {
+			advance();
+			return *this;
+		}
+
+		const value_type &operator*() const { return entry_; }
+
+		const value_type *operator->() const { return &entry_; }
+
+		operator bool() const { return not ended_; }
+
+		[[nodiscard]] bool ended() const { return ended_; }
+	};
+
+}// namespace hypertrie
+
+#endif//HYPERTRIE_ORDEREDITERATOR_HPP
@@ -0,0 +1,302 @@
+#ifndef HYPERTRIE_PARALLELITERATION_HPP
+#define HYPERTRIE_PARALLELITERATION_HPP
+
+#include <algorithm>
+#include <exception>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "Dice/hypertrie/internal/Hypertrie.hpp"
+#include "Dice/hypertrie/internal/raw/iterator/Iterator.hpp"
+#include "Dice/hypertrie/internal/util/Numa.hpp"
+
+namespace hypertrie {
+
+	/**
+	 * A part of the entries of a hypertrie. It consists of all entries that have one of key_parts() at position pos().
+	 * IterationRanges created by split() are disjoint and can be iterated concurrently by independent threads
+	 * as long as the hypertrie is not modified.
+	 */
+	template<HypertrieTrait tr_t = default_bool_Hypertrie_t>
+	class IterationRange {
+	public:
+		using tr = tr_t;
+		using tri = internal::raw::Hypertrie_internal_t<tr>;
+		using key_part_type = typename tr::key_part_type;
+		using Entry = typename tr::IteratorEntry;
+		using Key = typename tr::Key;
+
+	private:
+		const_Hypertrie<tr> hypertrie_;
+		pos_type pos_ = 0;
+		std::vector<key_part_type> key_parts_;
+		/**
+		 * the range covers all entries of the hypertrie, key_parts_ is ignored.
+		 */
+		bool complete_ = false;
+
+	public:
+		IterationRange() = default;
+
+		IterationRange(const_Hypertrie<tr> hypertrie, pos_type pos, std::vector<key_part_type> key_parts, bool complete = false)
+			: hypertrie_(std::move(hypertrie)), pos_(pos), key_parts_(std::move(key_parts)), complete_(complete) {}
+
+		[[nodiscard]] pos_type pos() const noexcept { return pos_; }
+
+		[[nodiscard]] const std::vector<key_part_type> &key_parts() const noexcept { return key_parts_; }
+
+		[[nodiscard]] bool empty() const noexcept { return hypertrie_.empty() or (not complete_ and key_parts_.empty()); }
+
+		/**
+		 * Calls f(const Entry &entry) for each entry in the range.
+		 * Entry is a Key for bool-valued hypertries and a pair of Key and value otherwise.
+		 */
+		template<typename F>
+		void for_each(F &&f) const {
+			if (empty())
+				return;
+			internal::compiled_switch<hypertrie_depth_limit, 1>::switch_void(
+					hypertrie_.depth(),
+					[&](auto depth_arg) {
+						for_each_impl<depth_arg>(f);
+					});
+		}
+
+	private:
+		template<size_t depth, typename F>
+		void for_each_impl(F &f) const {
+			using namespace internal::raw;
+			auto &context = ((hypertrie_.context() != nullptr) ? *hypertrie_.context() : DefaultHypertrieContext<tr>::instance()).rawContext();
+			auto nodec = *reinterpret_cast<const NodeContainer<depth, tri> *>(hypertrie_.rawNodeContainer());
+			if (complete_) {
+				for (iterator<depth, tri> it{nodec, context}; it; ++it)
+					f(std::as_const(*it));
+				return;
+			}
+			auto uc_nodec = nodec.uncompressed();
+			if constexpr (depth == 1) {
+				Entry entry{};
+				auto &key = tr::iterator_entry::key(entry);
+				key.resize(1);
+				for (const auto &key_part : key_parts_) {
+					key[0] = key_part;
+					if constexpr (not tr::is_bool_valued)
+						entry.second = context.template getChild<1>(uc_nodec, 0, key_part);
+					f(std::as_const(entry));
+				}
+			} else {
+				Entry entry{};
+				auto &key = tr::iterator_entry::key(entry);
+				key.resize(depth);
+				for (const auto &key_part : key_parts_) {
+					NodeContainer<depth - 1, tri> child = context.template getChild<depth>(uc_nodec, pos_, key_part);
+					if (child.empty())
+						continue;
+					key[pos_] = key_part;
+					for (iterator<depth - 1, tri> it{child, context}; it; ++it) {
+						const auto &sub_entry = *it;
+						const Key &sub_key = [&]() -> const Key & {
+							if constexpr (tr::is_bool_valued) return sub_entry;
+							else
+								return sub_entry.first;
+						}();
+						std::copy_n(sub_key.begin(), pos_, key.begin());
+						std::copy(sub_key.begin() + pos_, sub_key.end(), key.begin() + pos_ + 1);
+						if constexpr (not tr::is_bool_valued)
+							entry.second = sub_entry.second;
+						f(std::as_const(entry));
+					}
+				}
+			}
+		}
+	};
+
+	namespace internal {
+		/**
+		 * @return the key parts at position pos of a hypertrie with more than one entry, each with the number of entries it has
+		 */
+		template<HypertrieTrait tr>
+		std::vector<std::pair<size_t, typename tr::key_part_type>> weightedKeyParts(const const_Hypertrie<tr> &hypertrie, pos_type pos) {
+			using tri = raw::Hypertrie_internal_t<tr>;
+			using key_part_type = typename tr::key_part_type;
+			std::vector<std::pair<size_t, key_part_type>> weighted_key_parts;
+			compiled_switch<hypertrie_depth_limit, 1>::switch_void(
+					hypertrie.depth(),
+					[&](auto depth_arg) {
+						using namespace raw;
+						auto uc_nodec = reinterpret_cast<const NodeContainer<depth_arg, tri> *>(hypertrie.rawNodeContainer())->uncompressed();
+						const auto &edges = uc_nodec.uncompressed_node()->edges(pos);
+						weighted_key_parts.reserve(edges.size());
+						for (const auto &edge : edges) {
+							if constexpr (depth_arg == 1) {
+								if constexpr (tr::is_bool_valued)
+									weighted_key_parts.emplace_back(1, edge);
+								else
+									weighted_key_parts.emplace_back(1, edge.first);
+							} else {
+								auto child = hypertrie.context()->rawContext().template getChild<depth_arg>(uc_nodec, pos, edge.first);
+								weighted_key_parts.emplace_back((child.isCompressed()) ? 1 : child.uncompressed().uncompressed_node()->size(), edge.first);
+							}
+						}
+					});
+			return weighted_key_parts;
+		}
+
+		/**
+		 * Distributes weighted key parts over at most k groups with balanced total weight.
+		 * @return non-empty groups of key parts
+		 */
+		template<typename key_part_type>
+		std::vector<std::vector<key_part_type>> balanceKeyParts(std::vector<std::pair<size_t, key_part_type>> weighted_key_parts, size_t k) {
+			// longest processing time first: assign the heaviest key part to the lightest range
+			std::sort(weighted_key_parts.begin(), weighted_key_parts.end(), std::greater{});
+			const size_t range_count = std::min(k, weighted_key_parts.size());
+			std::vector<std::vector<key_part_type>> key_parts(range_count);
+			using load_and_range = std::pair<size_t, size_t>;
+			std::priority_queue<load_and_range, std::vector<load_and_range>, std::greater<>> loads;
+			for (size_t i = 0; i < range_count; ++i)
+				loads.emplace(0, i);
+			for (const auto &[weight, key_part] : weighted_key_parts) {
+				auto [load, range] = loads.top();
+				loads.pop();
+				key_parts[range].push_back(key_part);
+				loads.emplace(load + weight, range);
+			}
+			return key_parts;
+		}
+	}// namespace internal
+
+	/**
+	 * Splits hypertrie into at most k disjoint IterationRanges that together cover all its entries.
+	 * The key parts at position pos are distributed so that the number of entries per range is balanced.
+	 * A hypertrie with a single entry is not split.
+	 * @param hypertrie the hypertrie to split. It must not be modified while the ranges are in use.
+	 * @param k maximal number of ranges
+	 * @param pos the position by which the entries are partitioned
+	 * @return non-empty IterationRanges
+	 */
+	template<HypertrieTrait tr>
+	std::vector<IterationRange<tr>> split(const const_Hypertrie<tr> &hypertrie, size_t k, pos_type pos = 0) {
+		using key_part_type = typename tr::key_part_type;
+		assert(pos < hypertrie.depth());
+		std::vector<IterationRange<tr>> ranges;
+		if (hypertrie.empty() or k == 0)
+			return ranges;
+		if (hypertrie.size() == 1 or k == 1) {
+			ranges.emplace_back(hypertrie, pos, std::vector<key_part_type>{}, true);
+			return ranges;
+		}
+		auto key_parts = internal::balanceKeyParts(internal::weightedKeyParts(hypertrie, pos), k);
+		ranges.reserve(key_parts.size());
+		for (auto &range_key_parts : key_parts)
+			ranges.emplace_back(hypertrie, pos, std::move(range_key_parts));
+		return ranges;
+	}
+
+	/**
+	 * Splits hypertrie like split() but keeps the key parts owned by different NUMA nodes (see
+	 * internal::util::NumaTopology::nodeOf()) in different ranges. Each NUMA node gets a share of the k ranges that is
+	 * proportional to its number of entries, but at least one range.
+	 *
+	 * If the hypertrie's context uses NumaPlacement::partitioned and pos is 0, the nodes below the key parts of a range
+	 * are allocated on the range's NUMA node.
+	 * @param hypertrie the hypertrie to split. It must not be modified while the ranges are in use.
+	 * @param k maximal number of ranges. It is exceeded if there are more NUMA nodes with entries than k.
+	 * @param pos the position by which the entries are partitioned
+	 * @return pairs of NUMA node and non-empty IterationRange
+	 */
+	template<HypertrieTrait tr>
+	std::vector<std::pair<size_t, IterationRange<tr>>> split_by_numa_node(const const_Hypertrie<tr> &hypertrie, size_t k, pos_type pos = 0) {
+		using key_part_type = typename tr::key_part_type;
+		const auto &topology = internal::util::NumaTopology::instance();
+		std::vector<std::pair<size_t, IterationRange<tr>>> ranges;
+		if (topology.nodes() == 1 or hypertrie.size() <= 1) {
+			for (auto &range : split(hypertrie, k, pos))
+				ranges.emplace_back(0, std::move(range));
+			return ranges;
+		}
+		if (hypertrie.empty() or k == 0)
+			return ranges;
+		std::vector<std::vector<std::pair<size_t, key_part_type>>> weighted_key_parts_per_node(topology.nodes());
+		for (const auto &weighted_key_part : internal::weightedKeyParts(hypertrie, pos))
+			weighted_key_parts_per_node[topology.nodeOf(weighted_key_part.second)].push_back(weighted_key_part);
+		const size_t total_weight = hypertrie.size();
+		for (size_t node = 0; node < topology.nodes(); ++node) {
+			auto &weighted_key_parts = weighted_key_parts_per_node[node];
+			if (weighted_key_parts.empty())
+				continue;
+			size_t node_weight = 0;
+			for (const auto &[weight, key_part] : weighted_key_parts)
+				node_weight += weight;
+			const size_t node_k = std::max(size_t(1), (k * node_weight) / total_weight);
+			for (auto &range_key_parts : internal::balanceKeyParts(std::move(weighted_key_parts), node_k))
+				ranges.emplace_back(node, IterationRange<tr>{hypertrie, pos, std::move(range_key_parts)});
+		}
+		return ranges;
+	}
+
+	/**
+	 * Calls f(const Entry &entry) for each entry of hypertrie. The entries are split into IterationRanges (see split())
+	 * that are processed by up to thread_count threads in parallel. f must be safe to call concurrently. Slice caches
+	 * are bypassed while f is called (see SliceCacheBypass).
+	 * If f throws, the first exception is rethrown after all threads finished.
+	 *
+	 * With pin_to_numa_nodes, the entries are split by split_by_numa_node() and each range is processed by a new thread
+	 * that is pinned to the CPUs of the range's NUMA node. Combined with NumaPlacement::partitioned and pos 0, threads
+	 * traverse only nodes allocated on their own NUMA node. The calling thread only waits.
+	 * @param hypertrie the hypertrie. It must not be modified during the call.
+	 * @param f callback
+	 * @param thread_count number of threads. 0 uses std::thread::hardware_concurrency().
+	 * @param pos the position by which the entries are partitioned
+	 * @param pin_to_numa_nodes pin the threads to the NUMA nodes owning the entries they process
+	 */
+	template<HypertrieTrait tr, typename F>
+	void parallel_for_each(const const_Hypertrie<tr> &hypertrie, F &&f, size_t thread_count = 0, pos_type pos = 0, bool pin_to_numa_nodes = false) {
+		if (thread_count == 0)
+			thread_count = std::max(1U, std::thread::hardware_concurrency());
+		std::vector<IterationRange<tr>> ranges;
+		std::vector<size_t> numa_nodes;
+		if (pin_to_numa_nodes) {
+			for (auto &[numa_node, range] : split_by_numa_node(hypertrie, thread_count, pos)) {
+				numa_nodes.push_back(numa_node);
+				ranges.push_back(std::move(range));
+			}
+		} else {
+			ranges = split(hypertrie, thread_count, pos);
+		}
+		if (ranges.empty())
+			return;
+		std::vector<std::exception_ptr> exceptions(ranges.size());
+		auto process = [&](size_t i) {
+			SliceCacheBypass bypass;
+			try {
+				ranges[i].for_each(f);
+			} catch (...) {
+				exceptions[i] = std::current_exception();
+			}
+		};
+		std::vector<std::thread> threads;
+		threads.reserve(ranges.size());
+		if (pin_to_numa_nodes) {
+			// the calling thread is not pinned, its affinity would outlive the call
+			for (size_t i = 0; i < ranges.size(); ++i)
+				threads.emplace_back([&, i]() {
+					internal::util::pinThreadToNumaNode(numa_nodes[i]);
+					process(i);
+				});
+		} else {
+			for (size_t i = 1; i < ranges.size(); ++i)
+				threads.emplace_back(process, i);
+			process(0);
+		}
+		for (auto &thread : threads)
+			thread.join();
+		for (const auto &exception : exceptions)
+			if (exception)
+				std::rethrow_exception(exception);
+	}
+
+}// namespace hypertrie
+
+#endif//HYPERTRIE_PARALLELITERATION_HPP
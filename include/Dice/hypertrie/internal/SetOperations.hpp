@@ -0,0 +1,169 @@
+#ifndef HYPERTRIE_SETOPERATIONS_HPP
+#define HYPERTRIE_SETOPERATIONS_HPP
+
+#include "Dice/hypertrie/internal/Diff.hpp"
+#include "Dice/hypertrie/internal/Hypertrie.hpp"
+
+#include <algorithm>
+#include <optional>
+
+namespace hypertrie {
+
+	namespace internal {
+
+		template<HypertrieTrait tr>
+		HypertrieContext<tr> &setOperationContext(const const_Hypertrie<tr> &a, const const_Hypertrie<tr> &b) {
+			static_assert(tr::is_bool_valued, "Set operations are only supported for bool-valued Hypertries.");
+			return commonContext(a, b);
+		}
+
+		/**
+		 * Creates a Hypertrie with the entries of hypertrie. If hypertrie is managed by a context, the nodes are shared.
+		 */
+		template<HypertrieTrait tr>
+		Hypertrie<tr> shareOrCopy(const const_Hypertrie<tr> &hypertrie, HypertrieContext<tr> &context) {
+			if (hypertrie.context() != nullptr)
+				return Hypertrie<tr>{hypertrie};
+			Hypertrie<tr> result{hypertrie.depth(), context};
+			for (const auto &key : hypertrie)
+				result.set(key, true);
+			return result;
+		}
+
+		/**
+		 * Inserts keys that are not yet in hypertrie. Bulk insertion is only used for empty hypertries because
+		 * it does not copy nodes that are shared with other hypertries. Otherwise, the keys are set one by one.
+		 */
+		template<size_t depth, HypertrieTrait tr>
+		void insertNewKeys(Hypertrie<tr> &hypertrie, std::vector<typename raw::Hypertrie_internal_t<tr>::template RawKey<depth>> keys) {
+			using tri = raw::Hypertrie_internal_t<tr>;
+			if (keys.empty())
+				return;
+			auto &typed_nodec = *reinterpret_cast<raw::NodeContainer<depth, tri> *>(const_cast<raw::RawNodeContainer *>(hypertrie.rawNodeContainer()));
+			auto &raw_context = hypertrie.context()->rawContext();
+			if (typed_nodec.empty() and keys.size() > 1)
+				raw_context.template bulk_insert<depth>(typed_nodec, std::move(keys));
+			else
+				for (const auto &key : keys)
+					raw_context.template set<depth>(typed_nodec, key, true);
+		}
+
+		/**
+		 * Removes keys that are in hypertrie. Nodes that hypertrie shares with other hypertries are copied on write, so
+		 * only the paths to the removed keys are rebuilt.
+		 */
+		template<size_t depth, HypertrieTrait tr>
+		void removeKeys(Hypertrie<tr> &hypertrie, const std::vector<typename raw::Hypertrie_internal_t<tr>::template RawKey<depth>> &keys) {
+			using tri = raw::Hypertrie_internal_t<tr>;
+			auto &typed_nodec = *reinterpret_cast<raw::NodeContainer<depth, tri> *>(const_cast<raw::RawNodeContainer *>(hypertrie.rawNodeContainer()));
+			auto &raw_context = hypertrie.context()->rawContext();
+			for (const auto &key : keys)
+				raw_context.template set<depth>(typed_nodec, key, false);
+		}
+	}// namespace internal
+
+	/**
+	 * Union of two bool-valued hypertries. The result shares all nodes with a (or b, if a is contextless).
+	 * Only the entries missing in the shared operand are inserted, and subtrees with equal TensorHash are not visited.
+	 * @return a new Hypertrie in the context of the operands
+	 */
+	template<HypertrieTrait tr>
+	Hypertrie<tr> set_union(const const_Hypertrie<tr> &a, const const_Hypertrie<tr> &b) {
+		using tri = internal::raw::Hypertrie_internal_t<tr>;
+		auto &context = internal::setOperationContext(a, b);
+		const bool share_a = a.context() != nullptr or b.context() == nullptr;
+		const const_Hypertrie<tr> &base = (share_a) ? a : b;
+		const const_Hypertrie<tr> &other = (share_a) ? b : a;
+		Hypertrie<tr> result = internal::shareOrCopy(base, context);
+		if (base == other)
+			return result;
+		internal::compiled_switch<hypertrie_depth_limit, 1>::switch_void(
+				a.depth(),
+				[&](auto depth_arg) {
+					using RawKey = typename tri::template RawKey<depth_arg>;
+					std::vector<RawKey> missing;
+					internal::rawDiff<depth_arg>(context, base, other, [&](const RawKey &key, bool, bool in_base) {
+						if (not in_base)
+							missing.push_back(key);
+					});
+					internal::insertNewKeys<depth_arg>(result, std::move(missing));
+				});
+		return result;
+	}
+
+	/**
+	 * Difference a \ b of two bool-valued hypertries. Subtrees with equal TensorHash are not visited.
+	 * If a and b are disjoint, the result shares all nodes with a.
+	 * @return a new Hypertrie in the context of the operands
+	 */
+	template<HypertrieTrait tr>
+	Hypertrie<tr> set_difference(const const_Hypertrie<tr> &a, const const_Hypertrie<tr> &b) {
+		using tri = internal::raw::Hypertrie_internal_t<tr>;
+		auto &context = internal::setOperationContext(a, b);
+		std::optional<Hypertrie<tr>> result;
+		if (a == b)
+			return Hypertrie<tr>{a.depth(), context};
+		internal::compiled_switch<hypertrie_depth_limit, 1>::switch_void(
+				a.depth(),
+				[&](auto depth_arg) {
+					using RawKey = typename tri::template RawKey<depth_arg>;
+					std::vector<RawKey> only_in_a;
+					internal::rawDiff<depth_arg>(context, a, b, [&](const RawKey &key, bool, bool in_a) {
+						if (in_a)
+							only_in_a.push_back(key);
+					});
+					if (only_in_a.size() == a.size()) {
+						result.emplace(internal::shareOrCopy(a, context));
+					} else {
+						result.emplace(a.depth(), context);
+						internal::insertNewKeys<depth_arg>(*result, std::move(only_in_a));
+					}
+				});
+		return std::move(*result);
+	}
+
+	/**
+	 * Intersection of two bool-valued hypertries. Subtrees with equal TensorHash are not visited while computing the difference of a and b.
+	 * If one operand contains the other, the result shares all nodes with the contained operand.
+	 * Otherwise, the result starts as the operand with the smaller share of the difference and the keys of the difference
+	 * are removed from it. So the work is proportional to the difference and all subtries that are not on the path to a
+	 * removed key are shared.
+	 * @return a new Hypertrie in the context of the operands
+	 */
+	template<HypertrieTrait tr>
+	Hypertrie<tr> set_intersection(const const_Hypertrie<tr> &a, const const_Hypertrie<tr> &b) {
+		using tri = internal::raw::Hypertrie_internal_t<tr>;
+		auto &context = internal::setOperationContext(a, b);
+		if (a == b)
+			return internal::shareOrCopy(a, context);
+		std::optional<Hypertrie<tr>> result;
+		internal::compiled_switch<hypertrie_depth_limit, 1>::switch_void(
+				a.depth(),
+				[&](auto depth_arg) {
+					using RawKey = typename tri::template RawKey<depth_arg>;
+					std::vector<RawKey> only_in_a;
+					std::vector<RawKey> only_in_b;
+					internal::rawDiff<depth_arg>(context, a, b, [&](const RawKey &key, bool, bool in_a) {
+						if (in_a)
+							only_in_a.push_back(key);
+						else
+							only_in_b.push_back(key);
+					});
+					// prefer sharing the nodes of an operand with a context, see shareOrCopy
+					const bool remove_from_a = (a.context() != nullptr) == (b.context() != nullptr)
+													   ? only_in_a.size() <= only_in_b.size()
+													   : a.context() != nullptr;
+					if (remove_from_a) {
+						result.emplace(internal::shareOrCopy(a, context));
+						internal::removeKeys<depth_arg>(*result, only_in_a);
+					} else {
+						result.emplace(internal::shareOrCopy(b, context));
+						internal::removeKeys<depth_arg>(*result, only_in_b);
+					}
+				});
+		return std::move(*result);
+	}
+
+}// namespace hypertrie
+
+#endif//HYPERTRIE_SETOPERATIONS_HPP
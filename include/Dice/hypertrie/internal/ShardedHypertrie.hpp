@@ -0,0 +1,217 @@
+#ifndef HYPERTRIE_SHARDEDHYPERTRIE_HPP
+#define HYPERTRIE_SHARDEDHYPERTRIE_HPP
+
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <Dice/hash/DiceHash.hpp>
+
+#include "Dice/hypertrie/internal/BulkInserter.hpp"
+#include "Dice/hypertrie/internal/Hypertrie.hpp"
+#include "Dice/hypertrie/internal/HypertrieContext.hpp"
+
+namespace hypertrie {
+
+	/**
+	 * A hypertrie that is hash-partitioned into shards by the key part at shard position. Every shard is a Hypertrie
+	 * in its own HypertrieContext, so shards are modified independently and can be written concurrently, one thread
+	 * per shard (see ShardedBulkInserter).
+	 *
+	 * Entries with the same key part at the shard position are in the same shard. Two ShardedHypertries with the same
+	 * number of shards are co-partitioned: a key part is in the shard with the same index in both.
+	 * Use ShardedEinsum to evaluate einsum with ShardedHypertries as operands.
+	 */
+	template<HypertrieTrait tr_t = default_bool_Hypertrie_t>
+	class ShardedHypertrie {
+	public:
+		using tr = tr_t;
+		using Key = typename tr::Key;
+		using key_part_type = typename tr::key_part_type;
+		using value_type = typename tr::value_type;
+
+	private:
+		pos_type depth_;
+		pos_type shard_pos_;
+		// declared before shards_, so the shards are destroyed before their contexts
+		std::vector<std::unique_ptr<HypertrieContext<tr>>> contexts_;
+		std::vector<std::unique_ptr<Hypertrie<tr>>> shards_;
+
+	public:
+		/**
+		 * @param depth depth of the hypertrie
+		 * @param shard_count number of shards
+		 * @param shard_pos position of the key part that determines the shard of an entry
+		 */
+		ShardedHypertrie(pos_type depth, size_t shard_count, pos_type shard_pos = 0)
+			: depth_(depth), shard_pos_(shard_pos) {
+			if (shard_count == 0)
+				throw std::invalid_argument{"a ShardedHypertrie requires at least one shard."};
+			if (shard_pos >= depth)
+				throw std::invalid_argument{"the shard position must be smaller than the depth."};
+			contexts_.reserve(shard_count);
+			shards_.reserve(shard_count);
+			for (size_t i = 0; i < shard_count; ++i) {
+				auto &context = *contexts_.emplace_back(std::make_unique<HypertrieContext<tr>>());
+				shards_.emplace_back(std::make_unique<Hypertrie<tr>>(depth, context));
+			}
+		}
+
+		ShardedHypertrie(const ShardedHypertrie &) = delete;
+		ShardedHypertrie &operator=(const ShardedHypertrie &) = delete;
+
+		[[nodiscard]] pos_type depth() const noexcept { return depth_; }
+
+		[[nodiscard]] pos_type shardPos() const noexcept { return shard_pos_; }
+
+		[[nodiscard]] size_t shardCount() const noexcept { return shards_.size(); }
+
+		/**
+		 * @return index of the shard that holds the entries with key_part at the shard position
+		 */
+		[[nodiscard]] size_t shardOf(const key_part_type &key_part) const noexcept {
+			return Dice::hash::dice_hash(key_part) % shards_.size();
+		}
+
+		[[nodiscard]] size_t shardOf(const Key &key) const noexcept {
+			return shardOf(key[shard_pos_]);
+		}
+
+		Hypertrie<tr> &shard(size_t i) noexcept { return *shards_[i]; }
+
+		[[nodiscard]] const Hypertrie<tr> &shard(size_t i) const noexcept { return *shards_[i]; }
+
+		HypertrieContext<tr> &context(size_t i) noexcept { return *contexts_[i]; }
+
+		/**
+		 * @return the shards as const_Hypertries, e.g. to be used as operands
+		 */
+		[[nodiscard]] std::vector<const_Hypertrie<tr>> shards() const {
+			std::vector<const_Hypertrie<tr>> shards;
+			shards.reserve(shards_.size());
+			for (const auto &shard : shards_)
+				shards.emplace_back(*shard);
+			return shards;
+		}
+
+		[[nodiscard]] size_t size() const noexcept {
+			size_t size = 0;
+			for (const auto &shard : shards_)
+				size += shard->size();
+			return size;
+		}
+
+		[[nodiscard]] bool empty() const noexcept {
+			return size() == 0;
+		}
+
+		[[nodiscard]] value_type operator[](const Key &key) const {
+			return (*shards_[shardOf(key)])[key];
+		}
+
+		value_type set(const Key &key, value_type value) {
+			return shards_[shardOf(key)]->set(key, value);
+		}
+
+		/**
+		 * The cardinalities of the positions summed over the shards. The sum is exact for the shard position, as the
+		 * shards are disjoint in it, and an upper bound for all other positions.
+		 * @param positions the positions
+		 * @return the cardinality of each position
+		 */
+		[[nodiscard]] std::vector<size_t> getCards(const std::vector<pos_type> &positions) const {
+			std::vector<size_t> cards(positions.size(), 0);
+			for (const auto &shard : shards_)
+				for (auto [card, shard_card] : iter::zip(cards, shard->getCards(positions)))
+					card += shard_card;
+			return cards;
+		}
+
+		/**
+		 * Inserts keys that are not yet contained. The keys are partitioned by shard and every shard is filled by its
+		 * own thread with a BulkInserter. Only supported for bool-valued hypertries.
+		 * @param keys the keys
+		 */
+		void bulk_insert(const std::vector<Key> &keys) {
+			std::vector<std::vector<const Key *>> partitions(shards_.size());
+			for (const auto &key : keys)
+				partitions[shardOf(key)].push_back(&key);
+			std::vector<std::exception_ptr> exceptions(shards_.size());
+			std::vector<std::thread> threads;
+			threads.reserve(shards_.size());
+			for (size_t i = 0; i < shards_.size(); ++i) {
+				if (partitions[i].empty())
+					continue;
+				threads.emplace_back([&, i]() {
+					try {
+						BulkInserter<tr> inserter{*shards_[i], 0};
+						for (const Key *key : partitions[i])
+							inserter.add(*key);
+					} catch (...) {
+						exceptions[i] = std::current_exception();
+					}
+				});
+			}
+			for (auto &thread : threads)
+				thread.join();
+			for (const auto &exception : exceptions)
+				if (exception)
+					std::rethrow_exception(exception);
+		}
+	};
+
+	/**
+	 * Collects keys for a ShardedHypertrie with one BulkInserter per shard. The shards are flushed independently, so
+	 * the insertions into different shards run in parallel.
+	 */
+	template<HypertrieTrait tr_t = default_bool_Hypertrie_t>
+	class ShardedBulkInserter {
+	public:
+		using tr = tr_t;
+		using Key = typename tr::Key;
+
+	private:
+		ShardedHypertrie<tr> *hypertrie;
+		std::vector<std::unique_ptr<BulkInserter<tr>>> inserters;
+
+	public:
+		/**
+		 * @param hypertrie the sharded hypertrie
+		 * @param threshold number of keys per shard that are collected before they are inserted
+		 */
+		explicit ShardedBulkInserter(ShardedHypertrie<tr> &hypertrie, size_t threshold = 1'000'000)
+			: hypertrie(&hypertrie) {
+			inserters.reserve(hypertrie.shardCount());
+			for (size_t i = 0; i < hypertrie.shardCount(); ++i)
+				inserters.emplace_back(std::make_unique<BulkInserter<tr>>(hypertrie.shard(i), threshold));
+		}
+
+		void add(const Key &key) {
+			inserters[hypertrie->shardOf(key)]->add(key);
+		}
+
+		/**
+		 * Inserts the collected keys of all shards.
+		 * @param blocking wait until all shards are written
+		 */
+		void flush(const bool blocking = false) {
+			for (auto &inserter : inserters)
+				inserter->flush();
+			if (blocking)
+				for (auto &inserter : inserters)
+					inserter->flush(true);
+		}
+
+		[[nodiscard]] size_t size() const {
+			size_t size = 0;
+			for (const auto &inserter : inserters)
+				size += inserter->size();
+			return size;
+		}
+	};
+
+}// namespace hypertrie
+
+#endif//HYPERTRIE_SHARDEDHYPERTRIE_HPP
@@ -0,0 +1,175 @@
+#ifndef HYPERTRIE_SLICECACHE_HPP
+#define HYPERTRIE_SLICECACHE_HPP
+
+#include <array>
+#include <list>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+
+#include "Dice/hypertrie/internal/ConfigHypertrieDepthLimit.hpp"
+#include "Dice/hypertrie/internal/Hypertrie_predeclare.hpp"
+
+#include <Dice/hash/DiceHash.hpp>
+
+namespace hypertrie {
+
+	/**
+	 * Bounded cache of slice results of a HypertrieContext. Entries are evicted in least recently used order.
+	 *
+	 * An entry is keyed by the hash of the sliced root node and the slice key. As the hash identifies the content of a node,
+	 * modifying a hypertrie changes the hash of its root. So outdated entries are never hit, they are evicted eventually.
+	 * The cache holds a reference on every managed result node. So a cached result stays valid even if the sliced hypertrie is modified.
+	 * Contextless compressed results are owned by the cache and copied on a hit.
+	 *
+	 * The cache is not thread-safe and must only be used while the context is accessed by a single thread. A lookup that
+	 * misses inserts the result, which may evict an entry. Releasing the evicted entry's reference can delete nodes from
+	 * the context's node storage, which would race with other threads that read those nodes. Threads that slice
+	 * concurrently therefore bypass the cache (see SliceCacheBypass). parallel_for_each(), sharded_einsum2map() and the
+	 * threads of an Executor do so; other threads must disable the cache or create a SliceCacheBypass themselves.
+	 * @tparam tr HypertrieTrait
+	 */
+	/**
+	 * While a SliceCacheBypass exists, slicing on the current thread does not use slice caches.
+	 */
+	class SliceCacheBypass {
+		static inline thread_local size_t active_ = 0;
+
+	public:
+		SliceCacheBypass() noexcept { ++active_; }
+
+		~SliceCacheBypass() { --active_; }
+
+		SliceCacheBypass(const SliceCacheBypass &) = delete;
+		SliceCacheBypass &operator=(const SliceCacheBypass &) = delete;
+
+		/**
+		 * @return true if slice caches are bypassed on the current thread
+		 */
+		[[nodiscard]] static bool active() noexcept { return active_ != 0; }
+	};
+
+	template<HypertrieTrait tr>
+	class SliceCache {
+	public:
+		using key_part_type = typename tr::key_part_type;
+		using CompactSliceKey = typename tr::CompactSliceKey;
+
+	private:
+		struct CacheKey {
+			size_t root_hash;
+			CompactSliceKey slice_key;
+
+			bool operator==(const CacheKey &other) const noexcept {
+				return root_hash == other.root_hash and slice_key == other.slice_key;
+			}
+		};
+
+		struct CacheKeyHash {
+			size_t operator()(const CacheKey &key) const noexcept {
+				std::array<key_part_type, hypertrie_depth_limit> fixed_key_parts{};
+				std::copy(key.slice_key.fixedKeyParts().begin(), key.slice_key.fixedKeyParts().end(), fixed_key_parts.begin());
+				return Dice::hash::dice_hash(std::make_tuple(key.root_hash, key.slice_key.depth(), key.slice_key.fixedPositions(), fixed_key_parts));
+			}
+		};
+
+		using Entries = std::list<std::pair<CacheKey, const_Hypertrie<tr>>>;
+
+		/**
+		 * Cached results, the most recently used first.
+		 */
+		Entries entries_;
+		std::unordered_map<CacheKey, typename Entries::iterator, CacheKeyHash> index_;
+		size_t capacity_;
+		size_t hits_ = 0;
+		size_t misses_ = 0;
+
+		/**
+		 * The result returned for a cached entry. It has the same form as an uncached slice result.
+		 */
+		static const_Hypertrie<tr> result(const const_Hypertrie<tr> &cached) {
+			if (cached.pinned_)
+				return const_Hypertrie<tr>{cached.depth_, cached.context_, cached.node_container_};
+			else
+				return cached;// contextless nodes are copied
+		}
+
+	public:
+		/**
+		 * @param capacity maximal number of cached slice results
+		 */
+		explicit SliceCache(size_t capacity) : capacity_(capacity) {}
+
+		SliceCache(const SliceCache &) = delete;
+		SliceCache &operator=(const SliceCache &) = delete;
+
+		/**
+		 * Looks up the result of slicing root with slice_key.
+		 * @return the cached result or std::nullopt
+		 */
+		std::optional<const_Hypertrie<tr>> get(const const_Hypertrie<tr> &root, const CompactSliceKey &slice_key) {
+			auto found = index_.find(CacheKey{root.hash(), slice_key});
+			if (found == index_.end()) {
+				++misses_;
+				return std::nullopt;
+			}
+			++hits_;
+			entries_.splice(entries_.begin(), entries_, found->second);
+			return result(found->second->second);
+		}
+
+		/**
+		 * Caches the result of slicing root with slice_key. If the cache is full, the least recently used entry is evicted.
+		 * @param sliced the result of the slice as returned by const_Hypertrie::operator[]
+		 */
+		void put(const const_Hypertrie<tr> &root, const CompactSliceKey &slice_key, const const_Hypertrie<tr> &sliced) {
+			if (capacity_ == 0)
+				return;
+			CacheKey key{root.hash(), slice_key};
+			if (index_.count(key))
+				return;
+			if (entries_.size() == capacity_) {
+				index_.erase(entries_.back().first);
+				entries_.pop_back();
+			}
+			entries_.emplace_front(key, sliced);
+			const_Hypertrie<tr> &cached = entries_.front().second;
+			if (not cached.contextless()) {
+				// managed nodes are kept alive by the cache
+				cached.pin();
+			}
+			index_.emplace(std::move(key), entries_.begin());
+		}
+
+		/**
+		 * Removes all entries. References on cached nodes are released.
+		 */
+		void clear() {
+			index_.clear();
+			entries_.clear();
+		}
+
+		[[nodiscard]] size_t size() const {
+			return entries_.size();
+		}
+
+		[[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+		/**
+		 * Number of lookups that returned a cached result.
+		 */
+		[[nodiscard]] size_t hits() const {
+			return hits_;
+		}
+
+		/**
+		 * Number of lookups that did not find a cached result.
+		 */
+		[[nodiscard]] size_t misses() const {
+			return misses_;
+		}
+	};
+
+}// namespace hypertrie
+
+#endif//HYPERTRIE_SLICECACHE_HPP
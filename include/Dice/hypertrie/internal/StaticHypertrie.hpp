@@ -0,0 +1,258 @@
+#ifndef HYPERTRIE_STATICHYPERTRIE_HPP
+#define HYPERTRIE_STATICHYPERTRIE_HPP
+
+#include <stdexcept>
+#include <variant>
+
+#include "Dice/hypertrie/internal/Hypertrie.hpp"
+#include "Dice/hypertrie/internal/raw/iterator/Iterator.hpp"
+
+namespace hypertrie {
+
+	/**
+	 * A const_Hypertrie with a depth that is known at compile time.
+	 * Keys are std::arrays and all operations work directly on the typed node container,
+	 * i.e. there is no dispatch over the depth at runtime.
+	 * A const_StaticHypertrie converts implicitly to a const_Hypertrie, e.g. to be used as einsum operand or in a HashDiagonal.
+	 * @tparam depth_t depth of the hypertrie
+	 * @tparam tr_t HypertrieTrait
+	 */
+	template<size_t depth_t, HypertrieTrait tr_t>
+	class const_StaticHypertrie {
+		static_assert(depth_t >= 1 and depth_t < hypertrie_depth_limit);
+
+	public:
+		using tr = tr_t;
+		using tri = internal::raw::Hypertrie_internal_t<tr>;
+		using key_part_type = typename tr::key_part_type;
+		using value_type = typename tr::value_type;
+		using Key = typename tri::template RawKey<depth_t>;
+		using SliceKey = internal::RawSliceKey<depth_t, key_part_type>;
+		template<size_t fixed_depth>
+		using RawSliceKey = typename tri::template RawSliceKey<fixed_depth>;
+		/**
+		 * Positions and key parts of a slice key with fixed_depth fixed key parts, ordered by position.
+		 */
+		template<size_t fixed_depth>
+		using FixedKeyParts = std::array<typename RawSliceKey<fixed_depth>::FixedValue, fixed_depth>;
+		using NodeContainer = internal::raw::NodeContainer<depth_t, tri>;
+		using iterator = internal::raw::iterator<depth_t, tri>;
+		using const_iterator = iterator;
+		using raw_key_iterator = internal::raw::raw_key_iterator<depth_t, tri>;
+
+	protected:
+		const_Hypertrie<tr> hypertrie_;
+
+		NodeContainer &nodec() const noexcept {
+			return *const_cast<NodeContainer *>(reinterpret_cast<const NodeContainer *>(hypertrie_.rawNodeContainer()));
+		}
+
+		auto &rawContext() const noexcept {
+			return ((hypertrie_.context() != nullptr) ? *hypertrie_.context() : DefaultHypertrieContext<tr>::instance()).rawContext();
+		}
+
+		/**
+		 * Creates a const_Hypertrie that holds a reference on the node of node_container (see Hypertrie::snapshot()).
+		 */
+		static const_Hypertrie<tr> referencing(HypertrieContext<tr> *context, internal::raw::RawNodeContainer node_container) {
+			const_Hypertrie<tr> hypertrie{depth_t, context, node_container};
+			hypertrie.pin();
+			return hypertrie;
+		}
+
+	public:
+		const_StaticHypertrie() : hypertrie_(depth_t) {}
+
+		/**
+		 * @param hypertrie a const_Hypertrie of depth depth_t
+		 * @throws std::invalid_argument if hypertrie has a different depth
+		 */
+		explicit const_StaticHypertrie(const_Hypertrie<tr> hypertrie) : hypertrie_(std::move(hypertrie)) {
+			if (hypertrie_.depth() != depth_t)
+				throw std::invalid_argument{"The depth of the hypertrie does not match the depth of the const_StaticHypertrie."};
+		}
+
+		[[nodiscard]] static constexpr size_t depth() noexcept { return depth_t; }
+
+		[[nodiscard]] HypertrieContext<tr> *context() const noexcept { return hypertrie_.context(); }
+
+		[[nodiscard]] size_t hash() const noexcept { return hypertrie_.hash(); }
+
+		[[nodiscard]] bool empty() const noexcept { return hypertrie_.empty(); }
+
+		[[nodiscard]] size_t size() const noexcept {
+			if (empty())
+				return 0;
+			else if (nodec().isCompressed())
+				return 1;
+			else
+				return nodec().uncompressed().uncompressed_node()->size();
+		}
+
+		[[nodiscard]] value_type operator[](const Key &key) const {
+			if (empty())
+				return {};
+			return rawContext().template get<depth_t>(nodec(), key);
+		}
+
+		/**
+		 * Slices with a number of fixed key parts that is known at compile time.
+		 * @tparam fixed_depth number of fixed key parts
+		 * @param fixed_key_parts the fixed positions and key parts, ordered by position, e.g. {{{0, s}}} fixes position 0 to s
+		 * @return the value if all key parts are fixed, otherwise the sliced const_StaticHypertrie
+		 */
+		template<size_t fixed_depth>
+		[[nodiscard]] auto slice(const FixedKeyParts<fixed_depth> &fixed_key_parts) const
+				-> std::conditional_t<(fixed_depth < depth_t), const_StaticHypertrie<depth_t - fixed_depth, tr>, value_type> {
+			static_assert(fixed_depth <= depth_t);
+			if constexpr (fixed_depth == depth_t) {
+				Key key;
+				for (const auto &[pos, key_part] : fixed_key_parts)
+					key[pos] = key_part;
+				return (*this)[key];
+			} else if constexpr (fixed_depth == 0) {
+				return *this;
+			} else {
+				using Result = const_StaticHypertrie<depth_t - fixed_depth, tr>;
+				if (empty())
+					return Result{};
+				auto [node_cont, is_managed] = rawContext().template slice<depth_t, fixed_depth>(nodec(), RawSliceKey<fixed_depth>{fixed_key_parts});
+				if (node_cont.empty())
+					return Result{};
+				return Result{const_Hypertrie<tr>(depth_t - fixed_depth,
+												  (is_managed) ? hypertrie_.context() : nullptr,
+												  {node_cont.hash().hash(), node_cont.node()})};
+			}
+		}
+
+		/**
+		 * Slices with a slice key whose number of fixed key parts is only known at runtime.
+		 * @return the value if all key parts are fixed, otherwise the sliced const_Hypertrie
+		 */
+		[[nodiscard]] std::variant<const_Hypertrie<tr>, value_type> operator[](const SliceKey &slice_key) const {
+			size_t fixed_depth = 0;
+			for (const auto &key_part : slice_key)
+				fixed_depth += key_part.has_value();
+			if (fixed_depth == depth_t) {
+				Key key;
+				for (size_t pos = 0; pos < depth_t; ++pos)
+					key[pos] = slice_key[pos].value();
+				return (*this)[key];
+			} else if (fixed_depth == 0) {
+				return hypertrie_;
+			}
+			std::variant<const_Hypertrie<tr>, value_type> result;
+			internal::compiled_switch<depth_t, 1>::switch_void(
+					fixed_depth,
+					[&](auto fixed_depth_arg) {
+						FixedKeyParts<fixed_depth_arg> fixed_key_parts;
+						size_t i = 0;
+						for (size_t pos = 0; pos < depth_t; ++pos)
+							if (slice_key[pos].has_value())
+								fixed_key_parts[i++] = {pos, slice_key[pos].value()};
+						result = slice<fixed_depth_arg>(fixed_key_parts).dynamic();
+					});
+			return result;
+		}
+
+		[[nodiscard]] std::vector<size_t> getCards(const std::vector<pos_type> &positions) const {
+			assert(positions.size() <= depth_t);
+			if (positions.empty())
+				return {};
+			else if (empty())
+				return std::vector<size_t>(positions.size(), 0);
+			else if (nodec().isCompressed())
+				return std::vector<size_t>(positions.size(), 1);
+			else if constexpr (depth_t == 1)
+				return {size()};
+			else
+				return nodec().uncompressed().uncompressed_node()->getCards(positions);
+		}
+
+		[[nodiscard]] iterator begin() const { return iterator{nodec(), rawContext()}; }
+
+		[[nodiscard]] const_iterator cbegin() const { return begin(); }
+
+		/**
+		 * Iterates the entries with keys of type Key (a std::array) instead of a std::vector.
+		 * Iteration does not allocate and entries can be exported block-wise with raw_key_iterator::fill.
+		 */
+		[[nodiscard]] raw_key_iterator rawKeyBegin() const { return raw_key_iterator{nodec(), rawContext()}; }
+
+		[[nodiscard]] bool end() const noexcept { return false; }
+
+		[[nodiscard]] bool cend() const noexcept { return false; }
+
+		/**
+		 * @return the const_Hypertrie with dynamic depth that shares the nodes of this
+		 */
+		[[nodiscard]] const const_Hypertrie<tr> &dynamic() const noexcept { return hypertrie_; }
+
+		operator const const_Hypertrie<tr> &() const noexcept { return hypertrie_; }
+
+		[[nodiscard]] bool operator==(const const_StaticHypertrie &other) const noexcept {
+			return this->hash() == other.hash();
+		}
+
+		[[nodiscard]] bool operator==(const const_Hypertrie<tr> &other) const noexcept {
+			return hypertrie_ == other;
+		}
+
+		explicit operator std::string() const {
+			return std::string(hypertrie_);
+		}
+	};
+
+	/**
+	 * A Hypertrie with a depth that is known at compile time. See const_StaticHypertrie.
+	 * Like a Hypertrie, it holds a reference on its root node. Copies share all nodes until they are modified.
+	 * @tparam depth_t depth of the hypertrie
+	 * @tparam tr_t HypertrieTrait
+	 */
+	template<size_t depth_t, HypertrieTrait tr_t>
+	class StaticHypertrie : public const_StaticHypertrie<depth_t, tr_t> {
+		using base = const_StaticHypertrie<depth_t, tr_t>;
+
+		static const Hypertrie<tr_t> &checkDepth(const Hypertrie<tr_t> &hypertrie) {
+			if (hypertrie.depth() != depth_t)
+				throw std::invalid_argument{"The depth of the hypertrie does not match the depth of the StaticHypertrie."};
+			return hypertrie;
+		}
+
+	public:
+		using tr = tr_t;
+		using Key = typename base::Key;
+		using value_type = typename base::value_type;
+
+		explicit StaticHypertrie(HypertrieContext<tr> &context = DefaultHypertrieContext<tr>::instance())
+			: base(base::referencing(&context, {})) {}
+
+		/**
+		 * Creates a StaticHypertrie that shares the nodes of hypertrie.
+		 * @throws std::invalid_argument if hypertrie has a different depth
+		 */
+		explicit StaticHypertrie(const Hypertrie<tr> &hypertrie)
+			: base(base::referencing(checkDepth(hypertrie).context(), *hypertrie.rawNodeContainer())) {}
+
+		value_type set(const Key &key, value_type value) {
+			return this->rawContext().template set<depth_t>(this->nodec(), key, value);
+		}
+
+		/**
+		 * Creates an immutable snapshot of the current version. See Hypertrie::snapshot().
+		 */
+		[[nodiscard]] const_StaticHypertrie<depth_t, tr> snapshot() const {
+			return const_StaticHypertrie<depth_t, tr>{this->hypertrie_};
+		}
+
+		/**
+		 * @return a Hypertrie with dynamic depth that shares the nodes of this
+		 */
+		[[nodiscard]] Hypertrie<tr> toHypertrie() const {
+			return Hypertrie<tr>{this->hypertrie_};
+		}
+	};
+
+}// namespace hypertrie
+
+#endif//HYPERTRIE_STATICHYPERTRIE_HPP
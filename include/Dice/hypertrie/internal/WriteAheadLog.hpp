@@ -0,0 +1,391 @@
+#ifndef HYPERTRIE_WRITEAHEADLOG_HPP
+#define HYPERTRIE_WRITEAHEADLOG_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <span>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Dice/hypertrie/internal/Hypertrie.hpp"
+
+namespace hypertrie {
+
+	/**
+	 * Append-only log of the mutations of a single Hypertrie. Hypertries are kept in memory; the log makes ingested updates
+	 * survive a crash.
+	 *
+	 * Mutations are buffered and written as a group: a group is committed when it reaches Config::group_size entries or when
+	 * commit() is called, and synced to disk with a single fsync if Config::sync is set. An entry is durable once the group
+	 * containing it is committed. BulkInserter batches are logged as one record and committed before they are applied.
+	 *
+	 * The log is a sequence of records. A record consists of a header (magic, depth, number of entries), the entries
+	 * (the key parts of the key followed by the value) and a FNV-1a checksum of header and entries. A torn or corrupted
+	 * record at the end of the log, e.g. from a crash during a write, is discarded by replay().
+	 */
+	template<HypertrieTrait tr_t>
+	class WriteAheadLog {
+	public:
+		using tr = tr_t;
+		using tri = internal::raw::Hypertrie_internal_t<tr>;
+		using key_part_type = typename tr::key_part_type;
+		using value_type = typename tr::value_type;
+		using Key = typename tr::Key;
+
+		struct Config {
+			/**
+			 * Number of buffered entries after which a group is committed. 0 means groups are only committed by commit().
+			 */
+			size_t group_size = 4096;
+			/**
+			 * fsync the log after every committed group. Without it, committed groups survive a crash of the process but not of the OS.
+			 */
+			bool sync = true;
+		};
+
+	private:
+		template<size_t depth>
+		using RawKey = typename tri::template RawKey<depth>;
+
+		struct RecordHeader {
+			uint32_t magic;
+			uint32_t depth;
+			uint64_t entries;
+		};
+
+		static constexpr const uint32_t record_magic = 0x4c575448;// "HTWL"
+		static constexpr const size_t checksum_size = sizeof(uint64_t);
+
+		std::filesystem::path path_;
+		Config config_;
+		int fd_ = -1;
+		/**
+		 * End of the last committed group. Groups are written at this offset, so a group that failed to be written is
+		 * cut off again.
+		 */
+		uint64_t size_ = 0;
+
+		static constexpr const size_t npos = std::numeric_limits<size_t>::max();
+
+		/**
+		 * Encoded records of the current group.
+		 */
+		std::vector<std::byte> group_;
+		size_t group_entries_ = 0;
+		/**
+		 * Position of the record in group_ that single entries are appended to, or npos if there is none.
+		 */
+		size_t open_record_ = npos;
+		size_t open_record_depth_ = 0;
+		size_t open_record_entries_ = 0;
+
+		static uint64_t checksum(std::span<const std::byte> bytes) noexcept {
+			uint64_t hash = 0xcbf29ce484222325UL;
+			for (std::byte byte : bytes) {
+				hash ^= uint64_t(byte);
+				hash *= 0x100000001b3UL;
+			}
+			return hash;
+		}
+
+		static size_t entrySize(size_t depth) noexcept {
+			return depth * sizeof(key_part_type) + sizeof(value_type);
+		}
+
+		template<typename T>
+		void write(const T &value) {
+			const auto *bytes = reinterpret_cast<const std::byte *>(&value);
+			group_.insert(group_.end(), bytes, bytes + sizeof(T));
+		}
+
+		void writeEntry(std::span<const key_part_type> key, value_type value) {
+			for (auto key_part : key)
+				write(key_part);
+			write(value);
+		}
+
+		size_t openRecord(size_t depth) {
+			size_t record = group_.size();
+			write(RecordHeader{record_magic, uint32_t(depth), 0});
+			return record;
+		}
+
+		/**
+		 * Fills in the number of entries of the record and appends the checksum. Records are not aligned within group_.
+		 */
+		void closeRecord(size_t record, size_t entries) {
+			const auto count = uint64_t(entries);
+			std::memcpy(group_.data() + record + offsetof(RecordHeader, entries), &count, sizeof(count));
+			write(checksum({group_.data() + record, group_.size() - record}));
+		}
+
+		void closeOpenRecord() {
+			if (open_record_ == npos)
+				return;
+			closeRecord(open_record_, open_record_entries_);
+			open_record_ = npos;
+		}
+
+		[[noreturn]] void fail(const char *what) const {
+			throw std::system_error{errno, std::generic_category(), fmt::format("{} {}", what, path_.string())};
+		}
+
+		/**
+		 * @return false if writing failed, errno is set
+		 */
+		bool writeFully(const std::byte *data, size_t size, uint64_t offset) {
+			while (size > 0) {
+				ssize_t written = ::pwrite(fd_, data, size, off_t(offset));
+				if (written < 0) {
+					if (errno == EINTR)
+						continue;
+					return false;
+				}
+				data += written;
+				size -= size_t(written);
+				offset += uint64_t(written);
+			}
+			return true;
+		}
+
+		/**
+		 * Cuts off the bytes of a group that failed to be committed and throws.
+		 */
+		[[noreturn]] void failCommit(const char *what) const {
+			const int error = errno;
+			(void) ::ftruncate(fd_, off_t(size_));
+			errno = error;
+			fail(what);
+		}
+
+		template<size_t depth>
+		static void bulkInsert(Hypertrie<tr> &hypertrie, std::vector<RawKey<depth>> &keys) {
+			std::sort(keys.begin(), keys.end());
+			keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+			keys.erase(std::remove_if(keys.begin(), keys.end(), [&](const auto &key) { return hypertrie[std::span<const key_part_type>{key}]; }), keys.end());
+			if (keys.empty())
+				return;
+			auto &typed_nodec = *reinterpret_cast<internal::raw::NodeContainer<depth, tri> *>(const_cast<internal::raw::RawNodeContainer *>(hypertrie.rawNodeContainer()));
+			hypertrie.context()->rawContext().template bulk_insert<depth>(typed_nodec, std::move(keys));
+		}
+
+		/**
+		 * Applies the entries of a record. Records that only set boolean entries to true are bulk-inserted.
+		 */
+		template<size_t depth>
+		static void apply(Hypertrie<tr> &hypertrie, const std::byte *entries, size_t count) {
+			std::vector<RawKey<depth>> keys;
+			if constexpr (tr::is_bool_valued)
+				keys.reserve(count);
+			for (size_t i = 0; i < count; ++i, entries += entrySize(depth)) {
+				RawKey<depth> key;
+				std::memcpy(key.data(), entries, depth * sizeof(key_part_type));
+				value_type value;
+				std::memcpy(&value, entries + depth * sizeof(key_part_type), sizeof(value_type));
+				if constexpr (tr::is_bool_valued) {
+					if (value) {
+						keys.push_back(key);
+						continue;
+					}
+					// keep the order of the entries
+					bulkInsert<depth>(hypertrie, keys);
+					keys.clear();
+				}
+				hypertrie.set(std::span<const key_part_type>{key}, value);
+			}
+			if constexpr (tr::is_bool_valued)
+				bulkInsert<depth>(hypertrie, keys);
+		}
+
+	public:
+		/**
+		 * Opens the log at path for appending. The file is created if it does not exist.
+		 * Call replay() before appending to a log that contains entries from a previous run.
+		 */
+		explicit WriteAheadLog(std::filesystem::path path, Config config = {}) : path_(std::move(path)), config_(config) {
+			fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+			if (fd_ < 0)
+				fail("Opening the write-ahead log failed:");
+			struct stat file_stat;
+			if (::fstat(fd_, &file_stat) != 0) {
+				const int error = errno;
+				::close(fd_);
+				errno = error;
+				fail("Opening the write-ahead log failed:");
+			}
+			size_ = uint64_t(file_stat.st_size);
+		}
+
+		WriteAheadLog(const WriteAheadLog &) = delete;
+		WriteAheadLog &operator=(const WriteAheadLog &) = delete;
+
+		/**
+		 * Commits the pending group.
+		 */
+		~WriteAheadLog() {
+			if (fd_ < 0)
+				return;
+			try {
+				commit();
+			} catch (...) {
+			}
+			::close(fd_);
+		}
+
+		[[nodiscard]] const std::filesystem::path &path() const noexcept { return path_; }
+
+		[[nodiscard]] const Config &config() const noexcept { return config_; }
+
+		/**
+		 * @return number of entries that were logged but are not yet committed
+		 */
+		[[nodiscard]] size_t pending() const noexcept { return group_entries_; }
+
+		/**
+		 * Logs setting key to value. Consecutive entries of the same depth share a record.
+		 */
+		void append(std::span<const key_part_type> key, value_type value) {
+			if (open_record_ == npos or open_record_depth_ != key.size()) {
+				closeOpenRecord();
+				open_record_ = openRecord(key.size());
+				open_record_depth_ = key.size();
+				open_record_entries_ = 0;
+			}
+			writeEntry(key, value);
+			++open_record_entries_;
+			if (++group_entries_ >= config_.group_size and config_.group_size != 0)
+				commit();
+		}
+
+		/**
+		 * Logs a batch of keys of the given depth that are set to true, or of (key, value) pairs, as a single record and commits it.
+		 */
+		template<typename Entries>
+		void appendBatch(size_t depth, const Entries &entries) {
+			if (std::empty(entries))
+				return;
+			closeOpenRecord();
+			size_t record = openRecord(depth);
+			size_t count = 0;
+			for (const auto &entry : entries) {
+				if constexpr (tr::is_bool_valued)
+					writeEntry(entry, true);
+				else
+					writeEntry(entry.first, entry.second);
+				++count;
+			}
+			closeRecord(record, count);
+			group_entries_ += count;
+			commit();
+		}
+
+		/**
+		 * Logs setting key to value and sets it in hypertrie.
+		 * @return the value previously stored for key, see Hypertrie::set
+		 */
+		value_type set(Hypertrie<tr> &hypertrie, std::span<const key_part_type> key, value_type value) {
+			assert(key.size() == hypertrie.depth());
+			append(key, value);
+			return hypertrie.set(key, value);
+		}
+
+		value_type set(Hypertrie<tr> &hypertrie, const Key &key, value_type value) {
+			return this->set(hypertrie, std::span<const key_part_type>{key}, value);
+		}
+
+		/**
+		 * Writes the pending group to the log with a single write and, if configured, a single fsync.
+		 * If that fails, the log is truncated to the groups committed before and the group stays pending, so commit() may
+		 * be retried.
+		 */
+		void commit() {
+			closeOpenRecord();
+			if (group_.empty())
+				return;
+			if (not writeFully(group_.data(), group_.size(), size_))
+				failCommit("Writing the write-ahead log failed:");
+			if (config_.sync and ::fsync(fd_) != 0)
+				failCommit("Syncing the write-ahead log failed:");
+			size_ += group_.size();
+			group_.clear();
+			group_entries_ = 0;
+		}
+
+		/**
+		 * Re-applies the log to hypertrie, e.g. to a fresh Hypertrie on startup. A torn record at the end of the log is cut off,
+		 * so that subsequently appended records follow the last valid one.
+		 * @return number of replayed entries
+		 * @throws std::invalid_argument if the log contains records of a different depth than hypertrie
+		 */
+		size_t replay(Hypertrie<tr> &hypertrie) {
+			commit();
+			struct stat file_stat;
+			if (::fstat(fd_, &file_stat) != 0)
+				fail("Reading the write-ahead log failed:");
+			std::vector<std::byte> log(size_t(file_stat.st_size));
+			for (size_t read_bytes = 0; read_bytes < log.size();) {
+				ssize_t read = ::pread(fd_, log.data() + read_bytes, log.size() - read_bytes, off_t(read_bytes));
+				if (read < 0 and errno == EINTR)
+					continue;
+				if (read <= 0)
+					fail("Reading the write-ahead log failed:");
+				read_bytes += size_t(read);
+			}
+
+			size_t replayed = 0;
+			size_t pos = 0;
+			while (log.size() - pos >= sizeof(RecordHeader) + checksum_size) {
+				RecordHeader record_header;
+				std::memcpy(&record_header, log.data() + pos, sizeof(RecordHeader));
+				if (record_header.magic != record_magic or record_header.depth == 0 or record_header.depth > hypertrie_depth_limit)
+					break;
+				const size_t available_entries = (log.size() - pos - sizeof(RecordHeader) - checksum_size) / entrySize(record_header.depth);
+				if (record_header.entries > available_entries)
+					break;
+				const size_t record_size = sizeof(RecordHeader) + record_header.entries * entrySize(record_header.depth);
+				uint64_t stored_checksum;
+				std::memcpy(&stored_checksum, log.data() + pos + record_size, checksum_size);
+				if (stored_checksum != checksum({log.data() + pos, record_size}))
+					break;
+				if (record_header.depth != hypertrie.depth())
+					throw std::invalid_argument{fmt::format("The write-ahead log {} contains entries of depth {}, the hypertrie has depth {}.",
+															path_.string(), record_header.depth, hypertrie.depth())};
+				internal::compiled_switch<hypertrie_depth_limit, 1>::switch_void(
+						hypertrie.depth(),
+						[&](auto depth_arg) {
+							apply<depth_arg>(hypertrie, log.data() + pos + sizeof(RecordHeader), record_header.entries);
+						});
+				replayed += record_header.entries;
+				pos += record_size + checksum_size;
+			}
+			if (pos != log.size() and ::ftruncate(fd_, off_t(pos)) != 0)
+				fail("Truncating the torn tail of the write-ahead log failed:");
+			size_ = pos;
+			return replayed;
+		}
+
+		/**
+		 * Discards all logged entries, including the pending group, e.g. after the hypertrie was persisted otherwise.
+		 */
+		void reset() {
+			group_.clear();
+			group_entries_ = 0;
+			open_record_ = npos;
+			if (::ftruncate(fd_, 0) != 0)
+				fail("Truncating the write-ahead log failed:");
+			size_ = 0;
+			if (config_.sync and ::fsync(fd_) != 0)
+				fail("Syncing the write-ahead log failed:");
+		}
+	};
+}// namespace hypertrie
+
+#endif//HYPERTRIE_WRITEAHEADLOG_HPP
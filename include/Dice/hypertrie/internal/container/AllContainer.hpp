@@ -3,10 +3,13 @@
 
 #include "Dice/hypertrie/internal/container/BoostFlatMap.hpp"
 #include "Dice/hypertrie/internal/container/BoostFlatSet.hpp"
+#include "Dice/hypertrie/internal/container/RoaringBitmapSet.hpp"
 #include "Dice/hypertrie/internal/container/StdMap.hpp"
 #include "Dice/hypertrie/internal/container/StdSet.hpp"
 #include "Dice/hypertrie/internal/container/StdUnorderedMap.hpp"
 #include "Dice/hypertrie/internal/container/StdUnorderedSet.hpp"
+#include "Dice/hypertrie/internal/container/SwissMap.hpp"
+#include "Dice/hypertrie/internal/container/SwissSet.hpp"
 #include "Dice/hypertrie/internal/container/TslMap.hpp"
 #include "Dice/hypertrie/internal/container/TslSet.hpp"
 
@@ -0,0 +1,435 @@
+#ifndef HYPERTRIE_ROARINGBITMAPSET_HPP
+#define HYPERTRIE_ROARINGBITMAPSET_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+namespace hypertrie::internal::container {
+
+	/**
+	 * A compressed bitmap set of unsigned integers in the style of roaring bitmaps.
+	 *
+	 * The keys are partitioned into chunks by their upper bits. The lower 16 bits of the keys of a chunk are stored in
+	 * a sorted array while the chunk is sparse and in a 2^16 bit bitmap once it holds more than max_array_size keys.
+	 * Dense ID ranges thus take about one bit per key and can be intersected word-parallel, see operator&=.
+	 * For sparse keys, every chunk holds only a few keys and tsl_sparse_set is the smaller choice.
+	 *
+	 * The interface is a subset of std::set that is used for the edges of depth 1 nodes with value_type bool.
+	 * Iteration is in ascending key order. Iterators are invalidated by any modification.
+	 * @tparam Key unsigned integral key type
+	 */
+	template<typename Key>
+	class roaring_bitmap_set {
+		static_assert(std::is_integral_v<Key> and std::is_unsigned_v<Key>);
+
+	public:
+		using key_type = Key;
+		using value_type = Key;
+		using size_type = size_t;
+
+	private:
+		using low_type = uint16_t;
+		using word_type = uint64_t;
+
+		static constexpr const size_t low_bits = 16;
+		static constexpr const size_t chunk_capacity = size_t(1) << low_bits;
+		static constexpr const size_t word_bits = 64;
+		static constexpr const size_t words_per_chunk = chunk_capacity / word_bits;
+		/**
+		 * Chunks with up to max_array_size keys are stored as sorted arrays. With more keys, a bitmap is smaller.
+		 */
+		static constexpr const size_t max_array_size = chunk_capacity / low_bits;
+
+		static Key high(Key key) noexcept { return key >> low_bits; }
+
+		static low_type low(Key key) noexcept { return low_type(key); }
+
+		struct Chunk {
+			Key high;
+			uint32_t cardinality = 0;
+			std::vector<low_type> array;
+			std::vector<word_type> words;
+
+			explicit Chunk(Key high) : high(high) {}
+
+			[[nodiscard]] bool isBitmap() const noexcept { return not words.empty(); }
+
+			[[nodiscard]] bool contains(low_type low) const noexcept {
+				if (isBitmap())
+					return (words[low / word_bits] >> (low % word_bits)) & 1;
+				else
+					return std::binary_search(array.begin(), array.end(), low);
+			}
+
+			bool insert(low_type low) {
+				if (isBitmap()) {
+					word_type &word = words[low / word_bits];
+					const word_type mask = word_type(1) << (low % word_bits);
+					if (word & mask)
+						return false;
+					word |= mask;
+				} else {
+					auto pos = std::lower_bound(array.begin(), array.end(), low);
+					if (pos != array.end() and *pos == low)
+						return false;
+					array.insert(pos, low);
+				}
+				++cardinality;
+				if (not isBitmap() and cardinality > max_array_size)
+					toBitmap();
+				return true;
+			}
+
+			bool erase(low_type low) {
+				if (isBitmap()) {
+					word_type &word = words[low / word_bits];
+					const word_type mask = word_type(1) << (low % word_bits);
+					if (not(word & mask))
+						return false;
+					word &= ~mask;
+				} else {
+					auto pos = std::lower_bound(array.begin(), array.end(), low);
+					if (pos == array.end() or *pos != low)
+						return false;
+					array.erase(pos);
+				}
+				--cardinality;
+				if (isBitmap() and cardinality <= max_array_size)
+					toArray();
+				return true;
+			}
+
+			void toBitmap() {
+				words.assign(words_per_chunk, 0);
+				for (low_type low : array)
+					words[low / word_bits] |= word_type(1) << (low % word_bits);
+				array = {};
+			}
+
+			void toArray() {
+				array.clear();
+				array.reserve(cardinality);
+				for (size_t word_pos = 0; word_pos < words_per_chunk; ++word_pos)
+					for (word_type word = words[word_pos]; word != 0; word &= word - 1)
+						array.push_back(low_type(word_pos * word_bits + size_t(std::countr_zero(word))));
+				words = {};
+			}
+
+			/**
+			 * Offset of the first key at or after offset. For arrays, offsets are indices, for bitmaps, they are bit positions.
+			 * @return the offset or end() if there is none
+			 */
+			[[nodiscard]] uint32_t next(uint32_t offset) const noexcept {
+				if (not isBitmap())
+					return offset;
+				size_t word_pos = offset / word_bits;
+				if (word_pos >= words_per_chunk)
+					return end();
+				word_type word = words[word_pos] & (~word_type(0) << (offset % word_bits));
+				while (word == 0) {
+					if (++word_pos == words_per_chunk)
+						return end();
+					word = words[word_pos];
+				}
+				return uint32_t(word_pos * word_bits + size_t(std::countr_zero(word)));
+			}
+
+			[[nodiscard]] uint32_t end() const noexcept {
+				return (isBitmap()) ? uint32_t(chunk_capacity) : uint32_t(array.size());
+			}
+
+			[[nodiscard]] uint32_t offsetOf(low_type low) const noexcept {
+				if (isBitmap())
+					return low;
+				else
+					return uint32_t(std::lower_bound(array.begin(), array.end(), low) - array.begin());
+			}
+
+			[[nodiscard]] low_type lowAt(uint32_t offset) const noexcept {
+				return (isBitmap()) ? low_type(offset) : array[offset];
+			}
+
+			/**
+			 * Keeps only the keys that are also contained in other.
+			 */
+			void intersect(const Chunk &other) {
+				if (isBitmap() and other.isBitmap()) {
+					uint32_t new_cardinality = 0;
+					for (size_t word_pos = 0; word_pos < words_per_chunk; ++word_pos) {
+						words[word_pos] &= other.words[word_pos];
+						new_cardinality += uint32_t(std::popcount(words[word_pos]));
+					}
+					cardinality = new_cardinality;
+					if (cardinality <= max_array_size)
+						toArray();
+				} else {
+					if (isBitmap())
+						toArray();
+					// at least one of both is an array, so the result is an array
+					auto kept = std::remove_if(array.begin(), array.end(), [&](low_type low) { return not other.contains(low); });
+					array.erase(kept, array.end());
+					cardinality = uint32_t(array.size());
+				}
+			}
+
+			bool operator==(const Chunk &other) const noexcept {
+				return high == other.high and cardinality == other.cardinality and array == other.array and words == other.words;
+			}
+		};
+
+		std::vector<Chunk> chunks_;
+		size_t size_ = 0;
+
+		auto chunkLowerBound(Key high) const noexcept {
+			return std::lower_bound(chunks_.begin(), chunks_.end(), high,
+									[](const Chunk &chunk, Key high) { return chunk.high < high; });
+		}
+
+		auto chunkLowerBound(Key high) noexcept {
+			return std::lower_bound(chunks_.begin(), chunks_.end(), high,
+									[](const Chunk &chunk, Key high) { return chunk.high < high; });
+		}
+
+	public:
+		class const_iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = Key;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const Key *;
+			using reference = const Key &;
+
+		private:
+			const roaring_bitmap_set *set_ = nullptr;
+			size_t chunk_ = 0;
+			uint32_t offset_ = 0;
+			Key current_{};
+
+			void settle() noexcept {
+				const auto &chunks = set_->chunks_;
+				while (chunk_ != chunks.size()) {
+					offset_ = chunks[chunk_].next(offset_);
+					if (offset_ != chunks[chunk_].end()) {
+						current_ = Key((chunks[chunk_].high << low_bits) | chunks[chunk_].lowAt(offset_));
+						return;
+					}
+					++chunk_;
+					offset_ = 0;
+				}
+				offset_ = 0;
+			}
+
+			friend class roaring_bitmap_set;
+
+			const_iterator(const roaring_bitmap_set *set, size_t chunk, uint32_t offset) noexcept
+				: set_(set), chunk_(chunk), offset_(offset) {
+				settle();
+			}
+
+		public:
+			const_iterator() = default;
+
+			/**
+			 * The current key. It is stored in the iterator, so the reference is valid as long as the iterator is not changed.
+			 */
+			reference operator*() const noexcept { return current_; }
+
+			pointer operator->() const noexcept { return &current_; }
+
+			const_iterator &operator++() noexcept {
+				++offset_;
+				settle();
+				return *this;
+			}
+
+			const_iterator operator++(int) noexcept {
+				auto copy = *this;
+				++(*this);
+				return copy;
+			}
+
+			bool operator==(const const_iterator &other) const noexcept {
+				return chunk_ == other.chunk_ and offset_ == other.offset_;
+			}
+
+			bool operator!=(const const_iterator &other) const noexcept { return not(*this == other); }
+		};
+
+		using iterator = const_iterator;
+
+		roaring_bitmap_set() = default;
+
+		roaring_bitmap_set(std::initializer_list<Key> keys) {
+			for (Key key : keys)
+				insert(key);
+		}
+
+		template<typename InputIt>
+		roaring_bitmap_set(InputIt first, InputIt last) {
+			for (; first != last; ++first)
+				insert(*first);
+		}
+
+		[[nodiscard]] size_t size() const noexcept { return size_; }
+
+		[[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+		const_iterator begin() const noexcept { return {this, 0, 0}; }
+
+		const_iterator end() const noexcept { return {this, chunks_.size(), 0}; }
+
+		const_iterator cbegin() const noexcept { return begin(); }
+
+		const_iterator cend() const noexcept { return end(); }
+
+		[[nodiscard]] bool contains(Key key) const noexcept {
+			auto chunk = chunkLowerBound(high(key));
+			return chunk != chunks_.end() and chunk->high == high(key) and chunk->contains(low(key));
+		}
+
+		[[nodiscard]] size_t count(Key key) const noexcept { return contains(key); }
+
+		const_iterator find(Key key) const noexcept {
+			auto chunk = chunkLowerBound(high(key));
+			if (chunk == chunks_.end() or chunk->high != high(key) or not chunk->contains(low(key)))
+				return end();
+			return {this, size_t(chunk - chunks_.begin()), chunk->offsetOf(low(key))};
+		}
+
+		std::pair<const_iterator, bool> insert(Key key) {
+			auto chunk = chunkLowerBound(high(key));
+			if (chunk == chunks_.end() or chunk->high != high(key))
+				chunk = chunks_.emplace(chunk, high(key));
+			const bool inserted = chunk->insert(low(key));
+			size_ += inserted;
+			return {{this, size_t(chunk - chunks_.begin()), chunk->offsetOf(low(key))}, inserted};
+		}
+
+		template<typename... Args>
+		std::pair<const_iterator, bool> emplace(Args &&...args) {
+			return insert(Key(std::forward<Args>(args)...));
+		}
+
+		size_t erase(Key key) {
+			auto chunk = chunkLowerBound(high(key));
+			if (chunk == chunks_.end() or chunk->high != high(key) or not chunk->erase(low(key)))
+				return 0;
+			if (chunk->cardinality == 0)
+				chunks_.erase(chunk);
+			--size_;
+			return 1;
+		}
+
+		void clear() noexcept {
+			chunks_.clear();
+			size_ = 0;
+		}
+
+		/**
+		 * Keeps only the keys that are also contained in other. Bitmap chunks are intersected word-parallel.
+		 */
+		roaring_bitmap_set &operator&=(const roaring_bitmap_set &other) {
+			auto kept = chunks_.begin();
+			size_ = 0;
+			for (auto &chunk : chunks_) {
+				auto other_chunk = other.chunkLowerBound(chunk.high);
+				if (other_chunk == other.chunks_.end() or other_chunk->high != chunk.high)
+					continue;
+				chunk.intersect(*other_chunk);
+				if (chunk.cardinality == 0)
+					continue;
+				size_ += chunk.cardinality;
+				if (&*kept != &chunk)
+					*kept = std::move(chunk);
+				++kept;
+			}
+			chunks_.erase(kept, chunks_.end());
+			return *this;
+		}
+
+		/**
+		 * Appends the keys that are contained in this and in other to out, in ascending order. Neither set is copied: chunks
+		 * that are bitmaps in both sets are intersected word-parallel, other chunks by probing the keys of the smaller chunk.
+		 * The chunks of this are iterated, so this should be the smaller set.
+		 * @param out a container with push_back, e.g. a std::pmr::vector<Key>
+		 */
+		template<typename Out>
+		void intersect_into(const roaring_bitmap_set &other, Out &out) const {
+			for (const Chunk &chunk : chunks_) {
+				auto other_chunk = other.chunkLowerBound(chunk.high);
+				if (other_chunk == other.chunks_.end() or other_chunk->high != chunk.high)
+					continue;
+				const Key high_bits = Key(chunk.high << low_bits);
+				if (chunk.isBitmap() and other_chunk->isBitmap()) {
+					for (size_t word_pos = 0; word_pos < words_per_chunk; ++word_pos)
+						for (word_type word = chunk.words[word_pos] & other_chunk->words[word_pos]; word != 0; word &= word - 1)
+							out.push_back(Key(high_bits | Key(word_pos * word_bits + size_t(std::countr_zero(word)))));
+				} else {
+					const bool this_smaller = chunk.cardinality <= other_chunk->cardinality;
+					const Chunk &smaller = (this_smaller) ? chunk : *other_chunk;
+					const Chunk &larger = (this_smaller) ? *other_chunk : chunk;
+					for (uint32_t offset = smaller.next(0); offset != smaller.end(); offset = smaller.next(offset + 1))
+						if (const low_type low = smaller.lowAt(offset); larger.contains(low))
+							out.push_back(Key(high_bits | low));
+				}
+			}
+		}
+
+		friend roaring_bitmap_set operator&(roaring_bitmap_set left, const roaring_bitmap_set &right) {
+			left &= right;
+			return left;
+		}
+
+		bool operator==(const roaring_bitmap_set &other) const noexcept {
+			return size_ == other.size_ and chunks_ == other.chunks_;
+		}
+	};
+
+	template<typename T>
+	struct is_roaring_bitmap_set : std::false_type {};
+
+	template<typename Key>
+	struct is_roaring_bitmap_set<roaring_bitmap_set<Key>> : std::true_type {};
+
+	template<typename T>
+	inline constexpr bool is_roaring_bitmap_set_v = is_roaring_bitmap_set<T>::value;
+
+}// namespace hypertrie::internal::container
+
+template<typename Key>
+std::ostream &operator<<(std::ostream &os, const hypertrie::internal::container::roaring_bitmap_set<Key> &set) {
+	return os << fmt::format("{}", set);
+}
+
+
+template<typename K>
+struct fmt::formatter<hypertrie::internal::container::roaring_bitmap_set<K>> {
+private:
+	using set_type = hypertrie::internal::container::roaring_bitmap_set<K>;
+
+public:
+	auto parse(format_parse_context &ctx) {
+		return ctx.begin();
+	}
+
+	template<typename FormatContext>
+	auto format(const set_type &set, FormatContext &ctx) {
+
+		if (set.size() == 0)
+			return fmt::format_to(ctx.out(), "{{ }}");
+		else {
+			fmt::format_to(ctx.out(), "{{ ");
+			fmt::format_to(ctx.out(), "{}", fmt::join(std::vector<K>{set.begin(), set.end()}, ", "));
+			return fmt::format_to(ctx.out(), " }}");
+		}
+	}
+};
+#endif//HYPERTRIE_ROARINGBITMAPSET_HPP
@@ -0,0 +1,48 @@
+#ifndef HYPERTRIE_SWISSMAP_HPP
+#define HYPERTRIE_SWISSMAP_HPP
+
+#include <fmt/format.h>
+
+#include "Dice/hypertrie/internal/container/SwissTable.hpp"
+
+namespace hypertrie::internal::container {
+
+	template<typename Key, typename T>
+	using swiss_map = swiss_table<Key, T, Dice::hash::DiceHash<Key>>;
+}
+
+template<typename Key, typename T>
+std::ostream &operator<<(std::ostream &os, const hypertrie::internal::container::swiss_map<Key, T> &map) {
+	return os << fmt::format("{}", map);
+}
+
+template<typename K, typename V>
+struct fmt::formatter<hypertrie::internal::container::swiss_map<K, V>> {
+private:
+	using map_type = hypertrie::internal::container::swiss_map<K, V>;
+
+public:
+	auto parse(format_parse_context &ctx) {
+		return ctx.begin();
+	}
+
+	template<typename FormatContext>
+	auto format(const map_type &map, FormatContext &ctx) {
+
+		bool first = true;
+		fmt::format_to(ctx.out(), "{{ ");
+		for (const auto &entry : map) {
+			if (first) {
+				first = false;
+			} else {
+				fmt::format_to(ctx.out(), "\n  ");
+			}
+			if constexpr (std::is_pointer_v<V>)
+				fmt::format_to(ctx.out(), "{} -> {} ", entry.first, *entry.second);
+			else
+				fmt::format_to(ctx.out(), "{} -> {} ", entry.first, entry.second);
+		}
+		return fmt::format_to(ctx.out(), "}}");
+	}
+};
+#endif//HYPERTRIE_SWISSMAP_HPP
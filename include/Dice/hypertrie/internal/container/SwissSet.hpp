@@ -0,0 +1,43 @@
+#ifndef HYPERTRIE_SWISSSET_HPP
+#define HYPERTRIE_SWISSSET_HPP
+
+#include <fmt/format.h>
+#include <vector>
+
+#include "Dice/hypertrie/internal/container/SwissTable.hpp"
+
+namespace hypertrie::internal::container {
+
+	template<typename Key>
+	using swiss_set = swiss_table<Key, void, Dice::hash::DiceHash<Key>>;
+}
+
+template<typename Key>
+std::ostream &operator<<(std::ostream &os, const hypertrie::internal::container::swiss_set<Key> &set) {
+	return os << fmt::format("{}", set);
+}
+
+
+template<typename K>
+struct fmt::formatter<hypertrie::internal::container::swiss_set<K>> {
+private:
+	using set_type = hypertrie::internal::container::swiss_set<K>;
+
+public:
+	auto parse(format_parse_context &ctx) {
+		return ctx.begin();
+	}
+
+	template<typename FormatContext>
+	auto format(const set_type &set, FormatContext &ctx) {
+
+		if (set.size() == 0)
+			return fmt::format_to(ctx.out(), "{{ }}");
+		else {
+			fmt::format_to(ctx.out(), "{{ ");
+			fmt::format_to(ctx.out(), "{}", fmt::join(std::vector<K>{set.begin(), set.end()}, ", "));
+			return fmt::format_to(ctx.out(), " }}");
+		}
+	}
+};
+#endif//HYPERTRIE_SWISSSET_HPP
@@ -0,0 +1,527 @@
+#ifndef HYPERTRIE_SWISSTABLE_HPP
+#define HYPERTRIE_SWISSTABLE_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <Dice/hash/DiceHash.hpp>
+
+namespace hypertrie::internal::container {
+
+	namespace swiss {
+		/**
+		 * Control byte of a slot. Full slots store the lower 7 bits of the key's hash, so the sign bit is clear.
+		 */
+		using ctrl_type = int8_t;
+		constexpr static const ctrl_type ctrl_empty = -128;
+		constexpr static const ctrl_type ctrl_deleted = -2;
+
+		/**
+		 * Number of control bytes that are probed at once.
+		 */
+		constexpr static const size_t group_width = 16;
+
+		/**
+		 * A group of group_width control bytes. The match methods return a bit mask with one bit per slot of the group.
+		 */
+		class Group {
+#if defined(__SSE2__)
+			__m128i ctrl_;
+
+		public:
+			explicit Group(const ctrl_type *ctrl) noexcept : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl))) {}
+
+			[[nodiscard]] uint32_t match(ctrl_type h2) const noexcept {
+				return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)));
+			}
+
+			[[nodiscard]] uint32_t matchEmpty() const noexcept {
+				return match(ctrl_empty);
+			}
+
+			[[nodiscard]] uint32_t matchEmptyOrDeleted() const noexcept {
+				// the sign bit is set for empty and deleted
+				return uint32_t(_mm_movemask_epi8(ctrl_));
+			}
+#else
+			const ctrl_type *ctrl_;
+
+		public:
+			explicit Group(const ctrl_type *ctrl) noexcept : ctrl_(ctrl) {}
+
+			[[nodiscard]] uint32_t match(ctrl_type h2) const noexcept {
+				uint32_t mask = 0;
+				for (size_t i = 0; i < group_width; ++i)
+					mask |= uint32_t(ctrl_[i] == h2) << i;
+				return mask;
+			}
+
+			[[nodiscard]] uint32_t matchEmpty() const noexcept {
+				return match(ctrl_empty);
+			}
+
+			[[nodiscard]] uint32_t matchEmptyOrDeleted() const noexcept {
+				uint32_t mask = 0;
+				for (size_t i = 0; i < group_width; ++i)
+					mask |= uint32_t(ctrl_[i] < 0) << i;
+				return mask;
+			}
+#endif
+		};
+	}// namespace swiss
+
+	/**
+	 * Open-addressing hash table with a Swiss table layout: a control byte per slot stores 7 bits of the key's hash,
+	 * and a probe compares the control bytes of a group of 16 slots at once (with SSE2 if available).
+	 * Keys and values are stored inline in a flat slot array, no node is allocated per entry.
+	 *
+	 * Iterators and references are invalidated by inserts that grow the table. Erasing invalidates only the erased entry.
+	 * @tparam Key key type
+	 * @tparam Mapped mapped type, or void for a set
+	 * @tparam Hash hash function for Key
+	 * @tparam KeyEqual equality for Key
+	 */
+	template<typename Key, typename Mapped, typename Hash = Dice::hash::DiceHash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class swiss_table {
+		static constexpr const bool is_map = not std::is_void_v<Mapped>;
+
+	public:
+		using key_type = Key;
+		using mapped_type = Mapped;
+		/**
+		 * For maps, the stored pair. Its key must not be modified.
+		 */
+		using value_type = std::conditional_t<is_map, std::pair<Key, Mapped>, Key>;
+		using size_type = size_t;
+		using hasher = Hash;
+		using key_equal = KeyEqual;
+
+	private:
+		using ctrl_type = swiss::ctrl_type;
+		using Group = swiss::Group;
+		using Allocator = std::allocator<value_type>;
+		static constexpr const size_t group_width = swiss::group_width;
+		static constexpr const size_t npos = std::numeric_limits<size_t>::max();
+
+		ctrl_type *ctrl_ = nullptr;
+		value_type *slots_ = nullptr;
+		size_t capacity_ = 0;
+		size_t size_ = 0;
+		size_t deleted_ = 0;
+		[[no_unique_address]] Hash hash_{};
+		[[no_unique_address]] KeyEqual equal_{};
+
+		static const Key &keyOf(const value_type &value) noexcept {
+			if constexpr (is_map)
+				return value.first;
+			else
+				return value;
+		}
+
+		/**
+		 * Spreads the bits of the hash, the probe start uses the upper bits and the control byte the lower 7 bits.
+		 */
+		size_t hashOf(const Key &key) const noexcept {
+			size_t hash = hash_(key);
+			hash ^= hash >> 33;
+			hash *= 0xff51afd7ed558ccdULL;
+			hash ^= hash >> 33;
+			return hash;
+		}
+
+		static ctrl_type h2(size_t hash) noexcept { return ctrl_type(hash & 0x7F); }
+
+		size_t groupMask() const noexcept { return capacity_ / group_width - 1; }
+
+		/**
+		 * Triangular probing over the groups. As the number of groups is a power of two, every group is visited.
+		 */
+		template<typename F>
+		size_t probe(size_t hash, F &&f) const noexcept {
+			size_t group = (hash >> 7) & groupMask();
+			for (size_t step = 1;; ++step) {
+				if (size_t found = f(group * group_width); found != npos)
+					return found;
+				group = (group + step) & groupMask();
+			}
+		}
+
+		size_t findIndex(const Key &key) const noexcept {
+			if (size_ == 0)
+				return npos;
+			const size_t hash = hashOf(key);
+			size_t result = npos;
+			probe(hash, [&](size_t group_start) -> size_t {
+				Group group{ctrl_ + group_start};
+				for (uint32_t mask = group.match(h2(hash)); mask != 0; mask &= mask - 1) {
+					const size_t index = group_start + size_t(std::countr_zero(mask));
+					if (equal_(keyOf(slots_[index]), key)) {
+						result = index;
+						return index;
+					}
+				}
+				// an empty slot terminates every probe sequence that passes this group
+				return (group.matchEmpty() != 0) ? group_start : npos;
+			});
+			return result;
+		}
+
+		/**
+		 * @return the first empty or deleted slot on the probe sequence of hash
+		 */
+		size_t findFree(size_t hash) const noexcept {
+			return probe(hash, [&](size_t group_start) -> size_t {
+				if (uint32_t mask = Group{ctrl_ + group_start}.matchEmptyOrDeleted(); mask != 0)
+					return group_start + size_t(std::countr_zero(mask));
+				return npos;
+			});
+		}
+
+		void allocate(size_t capacity) {
+			capacity_ = capacity;
+			ctrl_ = new ctrl_type[capacity];
+			std::memset(ctrl_, swiss::ctrl_empty, capacity);
+			slots_ = Allocator{}.allocate(capacity);
+		}
+
+		void deallocate() noexcept {
+			if (capacity_ == 0)
+				return;
+			for (size_t index = 0; index < capacity_; ++index)
+				if (ctrl_[index] >= 0)
+					std::destroy_at(slots_ + index);
+			Allocator{}.deallocate(slots_, capacity_);
+			delete[] ctrl_;
+			ctrl_ = nullptr;
+			slots_ = nullptr;
+			capacity_ = 0;
+			size_ = 0;
+			deleted_ = 0;
+		}
+
+		void rehash(size_t capacity) {
+			ctrl_type *old_ctrl = ctrl_;
+			value_type *old_slots = slots_;
+			const size_t old_capacity = capacity_;
+			allocate(capacity);
+			deleted_ = 0;
+			for (size_t index = 0; index < old_capacity; ++index) {
+				if (old_ctrl[index] < 0)
+					continue;
+				const size_t hash = hashOf(keyOf(old_slots[index]));
+				const size_t new_index = findFree(hash);
+				ctrl_[new_index] = h2(hash);
+				std::construct_at(slots_ + new_index, std::move(old_slots[index]));
+				std::destroy_at(old_slots + index);
+			}
+			if (old_capacity != 0) {
+				Allocator{}.deallocate(old_slots, old_capacity);
+				delete[] old_ctrl;
+			}
+		}
+
+		/**
+		 * Grows the table if inserting one more entry would exceed the maximal load factor of 7/8.
+		 * If most of the load are deleted slots, the table is rehashed in place instead.
+		 */
+		void prepareInsert() {
+			if (size_ + deleted_ + 1 <= capacity_ / 8 * 7)
+				return;
+			if (capacity_ == 0)
+				rehash(group_width);
+			else if (size_ + 1 > capacity_ / 16 * 7)
+				rehash(capacity_ * 2);
+			else
+				rehash(capacity_);
+		}
+
+		template<typename... Args>
+		std::pair<size_t, bool> insertIndex(const Key &key, Args &&...args) {
+			if (size_t found = findIndex(key); found != npos)
+				return {found, false};
+			prepareInsert();
+			const size_t hash = hashOf(key);
+			const size_t index = findFree(hash);
+			if (ctrl_[index] == swiss::ctrl_deleted)
+				--deleted_;
+			std::construct_at(slots_ + index, std::forward<Args>(args)...);
+			ctrl_[index] = h2(hash);
+			++size_;
+			return {index, true};
+		}
+
+		void eraseIndex(size_t index) noexcept {
+			std::destroy_at(slots_ + index);
+			--size_;
+			// if the group of the slot has an empty slot, no probe sequence continues past it
+			const size_t group_start = index - index % group_width;
+			if (Group{ctrl_ + group_start}.matchEmpty() != 0) {
+				ctrl_[index] = swiss::ctrl_empty;
+			} else {
+				ctrl_[index] = swiss::ctrl_deleted;
+				++deleted_;
+			}
+		}
+
+		size_t nextFull(size_t index) const noexcept {
+			while (index < capacity_ and ctrl_[index] < 0)
+				++index;
+			return index;
+		}
+
+	public:
+		template<bool is_const>
+		class iterator_impl {
+			friend class swiss_table;
+			using table_type = std::conditional_t<is_const, const swiss_table, swiss_table>;
+
+			table_type *table_ = nullptr;
+			size_t index_ = 0;
+
+			iterator_impl(table_type *table, size_t index) noexcept : table_(table), index_(index) {}
+
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = typename swiss_table::value_type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = std::conditional_t<is_const, const value_type *, value_type *>;
+			using reference = std::conditional_t<is_const, const value_type &, value_type &>;
+
+			iterator_impl() = default;
+
+			/**
+			 * iterator converts to const_iterator
+			 */
+			template<bool other_const, typename = std::enable_if_t<(is_const and not other_const)>>
+			iterator_impl(const iterator_impl<other_const> &other) noexcept : table_(other.table_), index_(other.index_) {}
+
+			reference operator*() const noexcept { return table_->slots_[index_]; }
+
+			pointer operator->() const noexcept { return table_->slots_ + index_; }
+
+			iterator_impl &operator++() noexcept {
+				index_ = table_->nextFull(index_ + 1);
+				return *this;
+			}
+
+			iterator_impl operator++(int) noexcept {
+				auto copy = *this;
+				++(*this);
+				return copy;
+			}
+
+			bool operator==(const iterator_impl &other) const noexcept { return index_ == other.index_; }
+
+			bool operator!=(const iterator_impl &other) const noexcept { return index_ != other.index_; }
+
+			template<bool>
+			friend class iterator_impl;
+		};
+
+		using iterator = iterator_impl<false>;
+		using const_iterator = iterator_impl<true>;
+
+		swiss_table() = default;
+
+		swiss_table(std::initializer_list<value_type> values) {
+			reserve(values.size());
+			for (const auto &value : values)
+				insert(value);
+		}
+
+		template<typename InputIt>
+		swiss_table(InputIt first, InputIt last) {
+			for (; first != last; ++first)
+				insert(*first);
+		}
+
+		swiss_table(const swiss_table &other) : hash_(other.hash_), equal_(other.equal_) {
+			if (other.size_ == 0)
+				return;
+			allocate(other.capacity_);
+			std::memcpy(ctrl_, other.ctrl_, capacity_);
+			for (size_t index = 0; index < capacity_; ++index)
+				if (ctrl_[index] >= 0)
+					std::construct_at(slots_ + index, other.slots_[index]);
+			size_ = other.size_;
+			deleted_ = other.deleted_;
+		}
+
+		swiss_table(swiss_table &&other) noexcept
+			: ctrl_(std::exchange(other.ctrl_, nullptr)),
+			  slots_(std::exchange(other.slots_, nullptr)),
+			  capacity_(std::exchange(other.capacity_, 0)),
+			  size_(std::exchange(other.size_, 0)),
+			  deleted_(std::exchange(other.deleted_, 0)),
+			  hash_(std::move(other.hash_)),
+			  equal_(std::move(other.equal_)) {}
+
+		swiss_table &operator=(const swiss_table &other) {
+			if (this != &other) {
+				swiss_table copy{other};
+				swap(copy);
+			}
+			return *this;
+		}
+
+		swiss_table &operator=(swiss_table &&other) noexcept {
+			if (this != &other) {
+				deallocate();
+				swap(other);
+			}
+			return *this;
+		}
+
+		~swiss_table() { deallocate(); }
+
+		void swap(swiss_table &other) noexcept {
+			std::swap(ctrl_, other.ctrl_);
+			std::swap(slots_, other.slots_);
+			std::swap(capacity_, other.capacity_);
+			std::swap(size_, other.size_);
+			std::swap(deleted_, other.deleted_);
+			std::swap(hash_, other.hash_);
+			std::swap(equal_, other.equal_);
+		}
+
+		[[nodiscard]] size_t size() const noexcept { return size_; }
+
+		[[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+		[[nodiscard]] size_t bucket_count() const noexcept { return capacity_; }
+
+		iterator begin() noexcept { return {this, nextFull(0)}; }
+
+		iterator end() noexcept { return {this, capacity_}; }
+
+		const_iterator begin() const noexcept { return {this, nextFull(0)}; }
+
+		const_iterator end() const noexcept { return {this, capacity_}; }
+
+		const_iterator cbegin() const noexcept { return begin(); }
+
+		const_iterator cend() const noexcept { return end(); }
+
+		iterator find(const Key &key) noexcept {
+			const size_t index = findIndex(key);
+			return {this, (index == npos) ? capacity_ : index};
+		}
+
+		const_iterator find(const Key &key) const noexcept {
+			const size_t index = findIndex(key);
+			return {this, (index == npos) ? capacity_ : index};
+		}
+
+		[[nodiscard]] bool contains(const Key &key) const noexcept { return findIndex(key) != npos; }
+
+		[[nodiscard]] size_t count(const Key &key) const noexcept { return contains(key); }
+
+		std::pair<iterator, bool> insert(const value_type &value) {
+			auto [index, inserted] = insertIndex(keyOf(value), value);
+			return {{this, index}, inserted};
+		}
+
+		std::pair<iterator, bool> insert(value_type &&value) {
+			// the key is copied, as value is moved from on construction
+			const Key key = keyOf(value);
+			auto [index, inserted] = insertIndex(key, std::move(value));
+			return {{this, index}, inserted};
+		}
+
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(Args &&...args) {
+			return insert(value_type(std::forward<Args>(args)...));
+		}
+
+		template<typename... Args, bool map = is_map, typename = std::enable_if_t<map>>
+		std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args) {
+			auto [index, inserted] = insertIndex(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+			return {{this, index}, inserted};
+		}
+
+		template<bool map = is_map, typename = std::enable_if_t<map>>
+		auto &operator[](const Key &key) {
+			return try_emplace(key).first->second;
+		}
+
+		template<bool map = is_map, typename = std::enable_if_t<map>>
+		auto &at(const Key &key) {
+			const size_t index = findIndex(key);
+			if (index == npos)
+				throw std::out_of_range{"key not found"};
+			return slots_[index].second;
+		}
+
+		template<bool map = is_map, typename = std::enable_if_t<map>>
+		const auto &at(const Key &key) const {
+			const size_t index = findIndex(key);
+			if (index == npos)
+				throw std::out_of_range{"key not found"};
+			return slots_[index].second;
+		}
+
+		size_t erase(const Key &key) noexcept {
+			const size_t index = findIndex(key);
+			if (index == npos)
+				return 0;
+			eraseIndex(index);
+			return 1;
+		}
+
+		/**
+		 * @return iterator to the entry after position
+		 */
+		iterator erase(const_iterator position) noexcept {
+			eraseIndex(position.index_);
+			return {this, nextFull(position.index_ + 1)};
+		}
+
+		iterator erase(iterator position) noexcept {
+			return erase(const_iterator{position});
+		}
+
+		void clear() noexcept { deallocate(); }
+
+		/**
+		 * Allocates enough slots for size entries.
+		 */
+		void reserve(size_t size) {
+			size_t capacity = group_width;
+			while (capacity / 8 * 7 < size)
+				capacity *= 2;
+			if (capacity > capacity_)
+				rehash(capacity);
+		}
+
+		bool operator==(const swiss_table &other) const noexcept {
+			if (size_ != other.size_)
+				return false;
+			for (const auto &value : *this) {
+				auto found = other.find(keyOf(value));
+				if (found == other.end())
+					return false;
+				if constexpr (is_map)
+					if (not(found->second == value.second))
+						return false;
+			}
+			return true;
+		}
+	};
+
+}// namespace hypertrie::internal::container
+
+#endif//HYPERTRIE_SWISSTABLE_HPP
@@ -20,13 +20,26 @@ namespace hypertrie::internal::raw {
 		using map_type = typename tr::template map_type<key, value>;
 		template<typename key>
 		using set_type = typename tr::template set_type<key>;
+		template<size_t depth, typename key, typename value>
+		using edges_map_type = typename tr::template edges_map_type<depth, key, value>;
+		template<size_t depth, typename key>
+		using edges_set_type = typename tr::template edges_set_type<depth, key>;
+		template<size_t depth, typename key, typename value>
+		using storage_map_type = typename tr::template storage_map_type<depth, key, value>;
 
 		using SliceKey = typename tr::SliceKey;
+		using CompactSliceKey = typename tr::CompactSliceKey;
 		using Key = typename tr::Key;
 		/// internal definitions
 		template<size_t depth>
 		using RawKey = hypertrie::internal::RawKey<depth, typename tr::key_part_type>;
 
+		/**
+		 * Entry of a raw_key_iterator. Like tr::IteratorEntry, but with a RawKey instead of a Key.
+		 */
+		template<size_t depth>
+		using RawIteratorEntry = std::conditional_t<(tr::is_bool_valued), RawKey<depth>, std::pair<RawKey<depth>, value_type>>;
+
 		static size_t sliceKeyFixedDepth(const SliceKey &slice_key) {
 			size_t fixed_depth = 0;
 			for (auto opt_key_part : slice_key) {
@@ -50,6 +63,11 @@ namespace hypertrie::internal::raw {
 		public:
 			RawSliceKey() : fixed_values{} {}
 
+			/**
+			 * @param fixed_values the fixed positions and key parts, ordered by position
+			 */
+			RawSliceKey(const std::array<FixedValue, fixed_depth> &fixed_values) : fixed_values(fixed_values) {}
+
 			explicit RawSliceKey(const SliceKey &slice_key) {
 				assert(sliceKeyFixedDepth(slice_key) == fixed_depth);
 				size_t pos = 0;
@@ -61,6 +79,15 @@ namespace hypertrie::internal::raw {
 				}
 			}
 
+			/**
+			 * Takes the fixed positions and key parts directly from the packed representation, no rescan of the positions is needed.
+			 */
+			explicit RawSliceKey(const CompactSliceKey &slice_key) {
+				assert(slice_key.fixedDepth() == fixed_depth);
+				size_t i = 0;
+				slice_key.forEachFixed([&](pos_type pos, key_part_type key_part) { fixed_values[i++] = {pos, key_part}; });
+			}
+
 			const FixedValue &operator[](size_t pos) const {
 				// TODO: fix
 				return fixed_values[pos];
@@ -149,7 +176,7 @@ namespace hypertrie::internal::raw {
 
 		constexpr static bool is_bool_valued = tr::is_bool_valued;
 		constexpr static const bool is_lsb_unused = tr::lsb_unused;
-		constexpr static bool is_tsl_map = std::is_same_v<map_type<int, int>, container::tsl_sparse_map<int, int>>;
+		constexpr static const bool has_bitmap_leaves = tr::has_bitmap_leaves;
 
 		/**
 		 * Generates a subkey by removing a key_part at the given position
@@ -168,14 +195,14 @@ namespace hypertrie::internal::raw {
 
 		/**
 		 * Different maps use different methods to provide access to non-constant mapped_type references. This method provides an abstraction.
-		 * @tparam K key_type of the map
-		 * @tparam V mapped_type of the map
+		 * As the map type may differ per depth, the tsl maps are recognized by their iterator.
+		 * @tparam Map the map
 		 * @param map_it a valid iterator pointing to an entry
 		 * @return a reference to the mapped_type
 		 */
-		template<typename K, typename V>
-		static V &deref(typename map_type<K, V>::iterator &map_it) {
-			if constexpr (is_tsl_map) return map_it.value();
+		template<typename Map>
+		static typename Map::mapped_type &deref(typename Map::iterator &map_it) {
+			if constexpr (requires { map_it.value(); }) return map_it.value();
 			else
 				return map_it->second;
 		}
@@ -163,6 +163,11 @@ namespace hypertrie::internal::raw {
 		} 
 	public:
 		bool find(key_part_type key_part) {
+			if constexpr (depth == 1 and tri::has_bitmap_leaves) {
+				// membership test directly on the bitmap
+				value_ = nodec_->uncompressed_node()->edges(0).contains(key_part);
+				return value_;
+			}
 			this->operator[](key_part);
 			if constexpr(result_depth == 0)
 				return value_ != value_type{};
@@ -0,0 +1,356 @@
+#ifndef HYPERTRIE_RAWDIFF_HPP
+#define HYPERTRIE_RAWDIFF_HPP
+
+#include "Dice/hypertrie/internal/ConfigHypertrieDepthLimit.hpp"
+#include "Dice/hypertrie/internal/raw/iterator/Iterator.hpp"
+#include "Dice/hypertrie/internal/raw/storage/NodeContext.hpp"
+#include "Dice/hypertrie/internal/util/IntegralTemplatedTuple.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+namespace hypertrie::internal::raw {
+
+	/**
+	 * How a RawDiff walks the nodes of one depth.
+	 */
+	enum struct RawDiffMode {
+		/**
+		 * Nothing (more) to report.
+		 */
+		done,
+		/**
+		 * Both nodes are uncompressed, their edges are walked: first those of a, then those of b.
+		 */
+		lockstep,
+		/**
+		 * All entries of a node are reported.
+		 */
+		report,
+		/**
+		 * One node is compressed. The entries of the other node are reported, except for the entry of the compressed
+		 * node, which is reported at the end if the other node does not contain it.
+		 */
+		compressed
+	};
+
+	/**
+	 * State of a RawDiff at the nodes of one depth.
+	 * @tparam depth depth of the nodes
+	 * @tparam tri HypertrieInternalTrait
+	 */
+	template<size_t depth, HypertrieInternalTrait tri>
+	struct RawDiffLevel {
+		using ChildrenIterator = typename UncompressedNode<depth, tri>::ChildrenType::const_iterator;
+
+		RawDiffMode mode = RawDiffMode::done;
+		// lockstep
+		UncompressedNodeContainer<depth, tri> a{};
+		UncompressedNodeContainer<depth, tri> b{};
+		bool b_side = false;
+		ChildrenIterator edge{};
+		ChildrenIterator edges_end{};
+		// report and compressed: the entries of nodec are reported for the side in_a, the compressed entry for the other
+		NodeContainer<depth, tri> nodec{};
+		std::optional<raw_key_iterator<depth, tri>> entries;
+		bool in_a = false;
+		// compressed
+		typename tri::template RawKey<depth> compressed_key{};
+		typename tri::value_type compressed_value{};
+		bool compressed_done = false;
+	};
+
+	/**
+	 * Walks two nodes of the same NodeContext in lockstep and yields the entries that are only in one of them, one at a
+	 * time. Children with equal TensorHashes are identical sub-tensors and are skipped without being visited.
+	 * Thus, the cost of a diff scales with the difference and not with the size of the nodes.
+	 *
+	 * The walk keeps one level of state per depth instead of recursing, so it can be suspended after each entry.
+	 * It holds pointers into itself and into the nodes, so it can be neither copied nor moved, and the nodes must not be
+	 * modified during the walk.
+	 * @tparam depth depth of the nodes
+	 * @tparam tri_t HypertrieInternalTrait
+	 */
+	template<size_t depth, HypertrieInternalTrait tri_t>
+	class RawDiff {
+	public:
+		using tri = tri_t;
+		using tr = typename tri::tr;
+		using key_part_type = typename tri::key_part_type;
+		using value_type = typename tri::value_type;
+		using RawKey = typename tri::template RawKey<depth>;
+		using Context = NodeContext<hypertrie_depth_limit - 1, tri>;
+
+	private:
+		using Mode = RawDiffMode;
+
+		template<size_t level_depth>
+		using Level = RawDiffLevel<level_depth, tri>;
+
+		Context *context_;
+		util::IntegralTemplatedTuple<Level, 1, depth> levels_;
+		/**
+		 * Depth of the deepest level that is walked.
+		 */
+		size_t current_ = depth;
+		RawKey key_{};
+		value_type value_{};
+		bool in_a_ = false;
+		bool ended_ = false;
+
+	public:
+		/**
+		 * @param context the NodeContext that stores the nodes. Contextless (compressed) nodes are supported.
+		 * @param a first node container
+		 * @param b second node container
+		 */
+		RawDiff(Context &context, const NodeContainer<depth, tri> &a, const NodeContainer<depth, tri> &b) : context_(&context) {
+			enter<depth>(a, b);
+			ended_ = not next_rek<depth>();
+		}
+
+		RawDiff(const RawDiff &) = delete;
+		RawDiff &operator=(const RawDiff &) = delete;
+
+		RawDiff &operator++() {
+			ended_ = not next_rek<depth>();
+			return *this;
+		}
+
+		operator bool() const noexcept { return not ended_; }
+
+		/**
+		 * @return the key of the current entry
+		 */
+		[[nodiscard]] const RawKey &key() const noexcept { return key_; }
+
+		/**
+		 * @return the value of the current entry
+		 */
+		[[nodiscard]] value_type value() const noexcept { return value_; }
+
+		/**
+		 * @return true if the current entry is only in a, false if it is only in b
+		 */
+		[[nodiscard]] bool inA() const noexcept { return in_a_; }
+
+		/**
+		 * Calls consumer(const RawKey &key, value_type value, bool in_a) for every entry that is in a but not in b (in_a == true)
+		 * and for every entry that is in b but not in a (in_a == false).
+		 * If a key is in both nodes with different values, it is reported for both sides.
+		 * @param context the NodeContext that stores the nodes. Contextless (compressed) nodes are supported.
+		 * @param a first node container
+		 * @param b second node container
+		 * @param consumer callback that is called for each differing entry
+		 */
+		template<typename F>
+		static void diff(Context &context, const NodeContainer<depth, tri> &a, const NodeContainer<depth, tri> &b, F &&consumer) {
+			for (RawDiff walk{context, a, b}; walk; ++walk)
+				consumer(walk.key(), walk.value(), walk.inA());
+		}
+
+	private:
+		template<size_t level_depth>
+		void enter(const NodeContainer<level_depth, tri> &a, const NodeContainer<level_depth, tri> &b) {
+			auto &level = levels_.template get<level_depth>();
+			current_ = level_depth;
+			if (a.hash() == b.hash())
+				level.mode = Mode::done;// identical sub-tensors
+			else if (b.empty())
+				enterEntries<level_depth>(level, a, true, Mode::report);
+			else if (a.empty())
+				enterEntries<level_depth>(level, b, false, Mode::report);
+			else if (a.isCompressed())
+				enterCompressed<level_depth>(level, a, b, true);
+			else if (b.isCompressed())
+				enterCompressed<level_depth>(level, b, a, false);
+			else {
+				level.mode = Mode::lockstep;
+				level.a = a.uncompressed();
+				level.b = b.uncompressed();
+				level.b_side = false;
+				level.edge = level.a.uncompressed_node()->edges(0).begin();
+				level.edges_end = level.a.uncompressed_node()->edges(0).end();
+			}
+		}
+
+		template<size_t level_depth>
+		void enterEntries(Level<level_depth> &level, const NodeContainer<level_depth, tri> &nodec, bool in_a, Mode mode) {
+			current_ = level_depth;
+			level.mode = mode;
+			level.nodec = nodec;
+			level.entries.emplace(level.nodec, *context_);
+			level.in_a = in_a;
+		}
+
+		/**
+		 * compressed is a compressed node, other is any non-empty node.
+		 */
+		template<size_t level_depth>
+		void enterCompressed(Level<level_depth> &level, const NodeContainer<level_depth, tri> &compressed, const NodeContainer<level_depth, tri> &other,
+							 bool compressed_is_a) {
+			if constexpr (level_depth == 1 and tri::is_bool_valued and tri::is_lsb_unused) {
+				level.compressed_key[0] = compressed.hash().getKeyPart();
+				level.compressed_value = true;
+			} else {
+				level.compressed_key = compressed.compressed_node()->key();
+				level.compressed_value = compressed.compressed_node()->value();
+			}
+			level.compressed_done = false;
+			enterEntries<level_depth>(level, other, not compressed_is_a, Mode::compressed);
+		}
+
+		template<size_t level_depth>
+		void yield(const typename tri::template RawIteratorEntry<level_depth> &entry, bool in_a) {
+			constexpr static const size_t offset = depth - level_depth;
+			if constexpr (tri::is_bool_valued) {
+				std::copy(entry.begin(), entry.end(), key_.begin() + offset);
+				value_ = true;
+			} else {
+				std::copy(entry.first.begin(), entry.first.end(), key_.begin() + offset);
+				value_ = entry.second;
+			}
+			in_a_ = in_a;
+		}
+
+		/**
+		 * Advances the walk at level_depth and the levels below it to the next differing entry.
+		 * @return false if the nodes of level_depth have no further differing entries
+		 */
+		template<size_t level_depth>
+		bool next_rek() {
+			auto &level = levels_.template get<level_depth>();
+			while (true) {
+				if constexpr (level_depth > 1)
+					if (current_ < level_depth) {
+						if (next_rek<level_depth - 1>())
+							return true;
+						current_ = level_depth;// the children are done
+					}
+				switch (level.mode) {
+					case Mode::done:
+						return false;
+					case Mode::report: {
+						auto &entries = *level.entries;
+						if (not entries)
+							return false;
+						yield<level_depth>(*entries, level.in_a);
+						++entries;
+						return true;
+					}
+					case Mode::compressed:
+						return nextCompressed<level_depth>(level);
+					case Mode::lockstep:
+						if constexpr (level_depth == 1)
+							return nextLeaf(level);
+						else if (not descend<level_depth>(level))
+							return false;
+				}
+			}
+		}
+
+		template<size_t level_depth>
+		bool nextCompressed(Level<level_depth> &level) {
+			constexpr static const size_t offset = depth - level_depth;
+			for (auto &entries = *level.entries; entries; ++entries) {
+				const auto &entry = *entries;
+				const auto &[entry_key, entry_value] = [&]() -> std::pair<const typename tri::template RawKey<level_depth> &, value_type> {
+					if constexpr (tri::is_bool_valued)
+						return {entry, true};
+					else
+						return {entry.first, entry.second};
+				}();
+				if (not level.compressed_done and entry_value == level.compressed_value and entry_key == level.compressed_key) {
+					level.compressed_done = true;// the entry of the compressed node is in both nodes
+					continue;
+				}
+				yield<level_depth>(entry, level.in_a);
+				++entries;
+				return true;
+			}
+			if (level.compressed_done)
+				return false;
+			level.compressed_done = true;
+			std::copy(level.compressed_key.begin(), level.compressed_key.end(), key_.begin() + offset);
+			value_ = level.compressed_value;
+			in_a_ = not level.in_a;
+			return true;
+		}
+
+		/**
+		 * Switches a lockstep level from the edges of a to the edges of b.
+		 * @return false if the edges of b were already walked
+		 */
+		template<size_t level_depth>
+		bool switchToB(Level<level_depth> &level) {
+			if (level.b_side)
+				return false;
+			level.b_side = true;
+			level.edge = level.b.uncompressed_node()->edges(0).begin();
+			level.edges_end = level.b.uncompressed_node()->edges(0).end();
+			return true;
+		}
+
+		bool nextLeaf(Level<1> &level) {
+			do {
+				auto &other = (level.b_side) ? level.a : level.b;
+				while (level.edge != level.edges_end) {
+					const auto edge = *level.edge;
+					++level.edge;
+					if constexpr (tri::is_bool_valued) {
+						if (not other.uncompressed_node()->find(0, edge).first) {
+							key_[depth - 1] = edge;
+							value_ = true;
+							in_a_ = not level.b_side;
+							return true;
+						}
+					} else {
+						if (other.uncompressed_node()->child(0, edge.first) != edge.second) {
+							key_[depth - 1] = edge.first;
+							value_ = edge.second;
+							in_a_ = not level.b_side;
+							return true;
+						}
+					}
+				}
+			} while (switchToB(level));
+			return false;
+		}
+
+		/**
+		 * Enters the next pair of children of a lockstep level that differ.
+		 * @return false if all children were walked
+		 */
+		template<size_t level_depth>
+		bool descend(Level<level_depth> &level) {
+			constexpr static const size_t offset = depth - level_depth;
+			do {
+				while (level.edge != level.edges_end) {
+					const auto [key_part, child_hash] = *level.edge;
+					++level.edge;
+					key_[offset] = key_part;
+					if (not level.b_side) {
+						auto [found, b_child] = level.b.uncompressed_node()->find(0, key_part);
+						if (not found) {
+							enterEntries<level_depth - 1>(levels_.template get<level_depth - 1>(),
+														  context_->template getChild<level_depth>(level.a, 0, key_part), true, Mode::report);
+							return true;
+						} else if (not(b_child->second == child_hash)) {
+							enter<level_depth - 1>(context_->template getChild<level_depth>(level.a, 0, key_part),
+												   context_->template getChild<level_depth>(level.b, 0, key_part));
+							return true;
+						}
+					} else if (auto [found, _] = level.a.uncompressed_node()->find(0, key_part); not found) {
+						enterEntries<level_depth - 1>(levels_.template get<level_depth - 1>(),
+													  context_->template getChild<level_depth>(level.b, 0, key_part), false, Mode::report);
+						return true;
+					}
+				}
+			} while (switchToB(level));
+			return false;
+		}
+	};
+}// namespace hypertrie::internal::raw
+
+#endif//HYPERTRIE_RAWDIFF_HPP
@@ -4,9 +4,17 @@
 #include "Dice/hypertrie/internal/ConfigHypertrieDepthLimit.hpp"
 #include "Dice/hypertrie/internal/raw/storage/NodeContext.hpp"
 #include "Dice/hypertrie/internal/util/IntegralTemplatedTuple.hpp"
+
+#include <span>
+
 namespace hypertrie::internal::raw {
 
-	template<HypertrieInternalTrait tri_t>
+	/**
+	 * State of an iterator. It is independent of the depth, so iterators of different depths can be type-erased to it.
+	 * @tparam tri_t HypertrieInternalTrait
+	 * @tparam Entry_t type of the entries, either tr::IteratorEntry or tri::RawIteratorEntry
+	 */
+	template<HypertrieInternalTrait tri_t, typename Entry_t = typename tri_t::tr::IteratorEntry>
 	class base_iterator {
 		using tri = tri_t;
 		using tr = typename tri::tr;
@@ -15,8 +23,7 @@ namespace hypertrie::internal::raw {
 		using UncomressedChildren = typename UncompressedNode<depth_, tri>::ChildrenType;
 		template<size_t depth_>
 		using UncomressedChildrenIterator = typename UncomressedChildren<depth_>::const_iterator;
-		using Entry = typename tr::IteratorEntry;
-		using Key = typename tr::Key;
+		using Entry = Entry_t;
 		using value_t = typename tri::value_type;
 
 		mutable void *node_context_;
@@ -38,7 +45,7 @@ namespace hypertrie::internal::raw {
 		template<size_t child_depth>
 		auto &getEnd() { return ends.template get<child_depth + 1>(); }
 
-		Key &key() noexcept {
+		auto &key() noexcept {
 			if constexpr (tri::is_bool_valued) return entry;
 			else
 				return entry.first;
@@ -52,10 +59,19 @@ namespace hypertrie::internal::raw {
 		base_iterator(void *nodeContext, void *nodec, NodeCompression compression, bool ended) : node_context_(nodeContext), nodec_(nodec), compression_(compression), ended_(ended) {}
 	};
 
+	/**
+	 * Iterates the entries of a node.
+	 * @tparam depth_t depth of the node
+	 * @tparam tri_t HypertrieInternalTrait
+	 * @tparam Entry_t type of the entries. The default tr::IteratorEntry holds a Key vector.
+	 * With tri::RawIteratorEntry<depth_t> the key is a RawKey and iterating does not allocate at all (see raw_key_iterator).
+	 */
 	template<size_t depth_t,
 			 HypertrieInternalTrait tri_t,
-			typename = typename std::enable_if_t<(depth_t >= 1)>>
-	class iterator : public base_iterator<tri_t> {
+			 typename Entry_t = typename tri_t::tr::IteratorEntry>
+	class iterator : public base_iterator<tri_t, Entry_t> {
+		static_assert(depth_t >= 1);
+
 	public:
 
 		/// public definitions
@@ -63,12 +79,17 @@ namespace hypertrie::internal::raw {
 		using tri = tri_t;
 		using tr = typename tri::tr;
 	private:
+		using base = base_iterator<tri_t, Entry_t>;
 		using key_part_type = typename tri::key_part_type;
 
 		using RawKey = typename tri::template RawKey<depth>;
-		using Key = typename tr::Key;
 
-		using Entry = typename tr::IteratorEntry;
+		using Entry = Entry_t;
+
+		/**
+		 * If true, the key is a RawKey of fixed size. Otherwise, it is a Key vector that is resized on construction.
+		 */
+		static constexpr const bool has_raw_key = std::is_same_v<Entry, typename tri::template RawIteratorEntry<depth>>;
 
 		auto *nodec() const {
 			return reinterpret_cast<NodeContainer<depth, tri>*>(this->nodec_);
@@ -84,19 +105,21 @@ namespace hypertrie::internal::raw {
 		using value_type = Entry;
 
 		iterator(NodeContainer<depth, tri> &nodec, NodeContext<hypertrie_depth_limit, tri> &node_context)
-			: base_iterator<tri>(&node_context, &nodec, (NodeCompression)nodec.isCompressed(), nodec.empty()) {
+			: base(&node_context, &nodec, (NodeCompression)nodec.isCompressed(), nodec.empty()) {
 			if (not this->ended_){
-				this->key().resize(depth);
+				if constexpr (not has_raw_key)
+					this->key().resize(depth);
 				this->init_rek();
 			}
 		}
 
 		template<size_t any_depth>
 		iterator(NodeContainer<depth, tri> &nodec, NodeContext<any_depth, tri> &node_context)
-				: base_iterator<tri>(&node_context, &nodec, (NodeCompression)nodec.isCompressed(), nodec.empty()) {
+				: base(&node_context, &nodec, (NodeCompression)nodec.isCompressed(), nodec.empty()) {
 			static_assert(any_depth < hypertrie_depth_limit);
 			if (not this->ended_){
-				this->key().resize(depth);
+				if constexpr (not has_raw_key)
+					this->key().resize(depth);
 				this->init_rek();
 			}
 		}
@@ -112,6 +135,20 @@ namespace hypertrie::internal::raw {
 
 		inline operator bool() const { return not this->ended_; }
 
+		/**
+		 * Copies the next entries to out and advances the iterator past them. Allows to export entries block-wise.
+		 * @param out buffer for the entries
+		 * @return the number of entries written. It is less than out.size() only if the iterator reached its end.
+		 */
+		size_t fill(std::span<value_type> out) {
+			size_t written = 0;
+			for (; written < out.size() and not this->ended_; ++written) {
+				out[written] = this->entry;
+				inc_rek();
+			}
+			return written;
+		}
+
 		/*
 		 * Static Interface for usage with function pointers
 		 */
@@ -292,6 +329,12 @@ namespace hypertrie::internal::raw {
 			}
 		}
 	};
+	/**
+	 * An iterator with entries of type tri::RawIteratorEntry<depth>, i.e. a RawKey (bool-valued) or a pair of a RawKey and a value.
+	 * It does not allocate and has no runtime dispatch.
+	 */
+	template<size_t depth, HypertrieInternalTrait tri>
+	using raw_key_iterator = iterator<depth, tri, typename tri::template RawIteratorEntry<depth>>;
 };// namespace hypertrie::internal::raw
 
 #endif//HYPERTRIE_RAWITERATOR_HPP
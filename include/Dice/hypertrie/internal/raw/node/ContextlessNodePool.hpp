@@ -0,0 +1,93 @@
+#ifndef HYPERTRIE_CONTEXTLESSNODEPOOL_HPP
+#define HYPERTRIE_CONTEXTLESSNODEPOOL_HPP
+
+#include <vector>
+
+#include "Dice/hypertrie/internal/raw/node/Node.hpp"
+
+namespace hypertrie::internal::raw {
+
+	/**
+	 * Recycles compressed nodes that are not managed by a NodeStorage, e.g. the results of slices that end in a compressed node.
+	 * Such contextless nodes are created and destroyed whenever a result is sliced, copied or dropped.
+	 * Released nodes are kept in a thread-local free list and handed out again instead of allocating a new node.
+	 *
+	 * Pooled nodes are ordinary heap objects. A node may be released on another thread than it was acquired on
+	 * and a node that is not released to the pool may be deleted as usual.
+	 * @tparam depth depth of the nodes
+	 * @tparam tri HypertrieInternalTrait
+	 */
+	template<size_t depth, HypertrieInternalTrait tri>
+	class ContextlessNodePool {
+	public:
+		using Node = CompressedNode<depth, tri>;
+
+		/**
+		 * Maximal number of free nodes that are kept per thread. Further released nodes are deleted.
+		 */
+		static constexpr const size_t max_free_nodes = 1024;
+
+	private:
+		struct FreeList {
+			std::vector<Node *> nodes;
+
+			FreeList() { nodes.reserve(max_free_nodes); }
+
+			~FreeList() {
+				for (Node *node : nodes)
+					delete node;
+				destroyed() = true;
+			}
+		};
+
+		static FreeList &freeList() noexcept {
+			thread_local FreeList free_list;
+			return free_list;
+		}
+
+		/**
+		 * Set when the free list of this thread was destroyed, i.e. while the thread exits.
+		 * Nodes released afterwards are deleted directly.
+		 */
+		static bool &destroyed() noexcept {
+			thread_local bool destroyed = false;
+			return destroyed;
+		}
+
+	public:
+		/**
+		 * @return a node that holds a copy of node
+		 */
+		static Node *acquire(const Node &node = {}) {
+			if (destroyed())
+				return new Node(node);
+			auto &free_nodes = freeList().nodes;
+			if (free_nodes.empty())
+				return new Node(node);
+			Node *recycled = free_nodes.back();
+			free_nodes.pop_back();
+			*recycled = node;
+			return recycled;
+		}
+
+		/**
+		 * Returns a node to the pool. The node must not be used afterwards.
+		 */
+		static void release(Node *node) noexcept {
+			if (node == nullptr)
+				return;
+			if (destroyed()) {
+				delete node;
+				return;
+			}
+			auto &free_nodes = freeList().nodes;
+			if (free_nodes.size() < max_free_nodes)
+				free_nodes.push_back(node);
+			else
+				delete node;
+		}
+	};
+
+}// namespace hypertrie::internal::raw
+
+#endif//HYPERTRIE_CONTEXTLESSNODEPOOL_HPP
@@ -127,7 +127,7 @@ namespace hypertrie::internal::raw {
 		using value_type = typename tri::value_type;
 		using key_part_type = typename tri::key_part_type;
 		template<typename K, typename V>
-		using map_type = typename tri::template map_type<K, V>;
+		using map_type = typename tri::template edges_map_type<depth, K, V>;
 
 		using ChildType = std::conditional_t<(depth > 1),
 											 std::conditional_t<(depth == 2 and tri::is_lsb_unused),
@@ -136,8 +136,8 @@ namespace hypertrie::internal::raw {
 											 value_type>;
 
 		using ChildrenType = std::conditional_t<((depth == 1) and tri::is_bool_valued),
-												typename tri::template set_type<key_part_type>,
-												typename tri::template map_type<typename tri::key_part_type, ChildType>>;
+												typename tri::template edges_set_type<depth, key_part_type>,
+												typename tri::template edges_map_type<depth, key_part_type, ChildType>>;
 
 		using EdgesType = std::conditional_t<(depth > 1),
 											 std::array<ChildrenType, depth>,
@@ -301,7 +301,7 @@ namespace hypertrie::internal::raw {
 
 	private:
 		static constexpr const auto subkey = &tri::template subkey<depth>;
-		static constexpr const auto deref = &tri::template deref<typename ChildrenType::key_type, typename ChildrenType::mapped_type>;
+		static constexpr const auto deref = &tri::template deref<ChildrenType>;
 	public:
 
 		size_t size_ = 0;
@@ -0,0 +1,115 @@
+#ifndef HYPERTRIE_NODECODEC_HPP
+#define HYPERTRIE_NODECODEC_HPP
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+#include "Dice/hypertrie/internal/raw/Hypertrie_internal_traits.hpp"
+#include "Dice/hypertrie/internal/raw/node/Node.hpp"
+#include "Dice/hypertrie/internal/raw/node/TensorHash.hpp"
+
+namespace hypertrie::internal::raw {
+
+	/**
+	 * Encodes the content of nodes, i.e. everything but hash and ref_count, as a sequence of fields.
+	 *
+	 * Children are encoded by their hashes. Out must provide write(const T &) for the fields and write(const TensorHash &),
+	 * In must provide read<T>() and readHash(). Used by NodeStorageCheckpoint and NodePager.
+	 * @tparam depth depth of the nodes
+	 * @tparam tri_t HypertrieInternalTrait
+	 */
+	template<size_t depth, HypertrieInternalTrait tri_t>
+	struct NodeCodec {
+		using tri = tri_t;
+		using key_part_type = typename tri::key_part_type;
+		using value_type = typename tri::value_type;
+
+		template<typename Out>
+		static void write(Out &out, const CompressedNode<depth, tri> &node) {
+			for (auto key_part : node.key())
+				out.write(key_part);
+			if constexpr (not tri::is_bool_valued)
+				out.write(node.value());
+		}
+
+		template<typename Out>
+		static void write(Out &out, const UncompressedNode<depth, tri> &node) {
+			if constexpr (depth > 1) {
+				out.write(uint64_t(node.size_));
+				for (size_t pos = 0; pos < depth; ++pos) {
+					out.write(uint64_t(node.edges(pos).size()));
+					for (const auto &[key_part, child] : node.edges(pos)) {
+						out.write(key_part);
+						if constexpr (std::is_same_v<std::decay_t<decltype(child)>, TensorHash>)
+							out.write(child);
+						else
+							out.write(child.getTaggedNodeHash());
+					}
+				}
+			} else {
+				out.write(uint64_t(node.edges().size()));
+				if constexpr (tri::is_bool_valued) {
+					for (auto key_part : node.edges())
+						out.write(key_part);
+				} else {
+					for (const auto &[key_part, value] : node.edges()) {
+						out.write(key_part);
+						out.write(value);
+					}
+				}
+			}
+		}
+
+		/**
+		 * @return a new node, the caller takes ownership
+		 */
+		template<typename In>
+		static CompressedNode<depth, tri> *readCompressed(In &in, size_t ref_count) {
+			typename tri::template RawKey<depth> key;
+			for (auto &key_part : key)
+				key_part = in.template read<key_part_type>();
+			if constexpr (tri::is_bool_valued)
+				return new CompressedNode<depth, tri>{key, ref_count};
+			else
+				return new CompressedNode<depth, tri>{key, in.template read<value_type>(), ref_count};
+		}
+
+		/**
+		 * @return a new node, the caller takes ownership
+		 */
+		template<typename In>
+		static UncompressedNode<depth, tri> *readUncompressed(In &in, size_t ref_count) {
+			// owned until complete, a truncated input must not leak the node
+			auto node = std::make_unique<UncompressedNode<depth, tri>>(ref_count);
+			if constexpr (depth > 1) {
+				using ChildType = typename WithEdges<depth, tri>::ChildType;
+				node->size_ = in.template read<uint64_t>();
+				for (size_t pos = 0; pos < depth; ++pos) {
+					auto &edges = node->edges(pos);
+					const size_t edge_count = in.template read<uint64_t>();
+					// not every edge container supports reserve, e.g. std_map
+					if constexpr (requires { edges.reserve(edge_count); })
+						edges.reserve(edge_count);
+					for (size_t i = 0; i < edge_count; ++i) {
+						const auto key_part = in.template read<key_part_type>();
+						edges[key_part] = ChildType(in.readHash());
+					}
+				}
+			} else {
+				const size_t edge_count = in.template read<uint64_t>();
+				for (size_t i = 0; i < edge_count; ++i) {
+					const auto key_part = in.template read<key_part_type>();
+					if constexpr (tri::is_bool_valued)
+						node->edges().insert(key_part);
+					else
+						node->edges().emplace(key_part, in.template read<value_type>());
+				}
+			}
+			return node.release();
+		}
+	};
+
+}// namespace hypertrie::internal::raw
+
+#endif//HYPERTRIE_NODECODEC_HPP
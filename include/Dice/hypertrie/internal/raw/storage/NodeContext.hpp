@@ -4,6 +4,7 @@
 #include <compare>
 
 #include "Dice/hypertrie/internal/Hypertrie_traits.hpp"
+#include "Dice/hypertrie/internal/raw/node/ContextlessNodePool.hpp"
 #include "Dice/hypertrie/internal/raw/node/NodeContainer.hpp"
 #include "Dice/hypertrie/internal/raw/node/TensorHash.hpp"
 #include "Dice/hypertrie/internal/raw/storage/NodeStorage.hpp"
@@ -52,20 +53,20 @@ namespace hypertrie::internal::raw {
 		template<size_t depth>
 		void incRefCount(NodeContainer<depth, tri> &nodec) {
 			if constexpr (depth == 1 and tri::is_bool_valued and tri::is_lsb_unused)
-				return;// there is no real node to be counted
-			else {
-				assert(nodec.ref_count() > 0);
-				nodec.ref_count()++;
-			}
+				if (nodec.isCompressed())
+					return;// there is no real node to be counted
+			assert(nodec.ref_count() > 0);
+			nodec.ref_count()++;
+			if (auto *journal = storage.template journal<depth>())
+				journal->recounted(TensorHash(nodec.hash()));
 		}
 		template<size_t depth>
 		void decrRefCount(NodeContainer<depth, tri> &nodec) {
 			if constexpr (depth == 1 and tri::is_bool_valued and tri::is_lsb_unused)
-				return;
-			else {
-				RekNodeModification<max_depth, depth, tri> update{this->storage, nodec};
-				update.apply_decrement_ref_count();
-			}
+				if (nodec.isCompressed())
+					return;// there is no real node to be counted
+			RekNodeModification<max_depth, depth, tri> update{this->storage, nodec};
+			update.apply_decrement_ref_count();
 		}
 
 		/**
@@ -86,6 +87,7 @@ namespace hypertrie::internal::raw {
 			const value_type old_value = get(nodec, key);
 			if (value == old_value)
 				return value;
+			// the NUMA placement is applied to bulk loads only, setting the memory policy costs more than a single update
 			RekNodeModification<max_depth, depth, tri> update{this->storage, nodec};
 			update.apply_update(key, value, old_value);
 			return old_value;
@@ -99,6 +101,23 @@ namespace hypertrie::internal::raw {
 		 */
 		template<size_t depth>
 		void bulk_insert(NodeContainer<depth, tri> &nodec, std::vector<RawKey<depth>> keys) {
+			if (storage.numaPlacement() == util::NumaPlacement::partitioned and util::NumaTopology::instance().nodes() > 1) {
+				// one update per NUMA node, so that the nodes of each group are allocated on its NUMA node
+				const auto &topology = util::NumaTopology::instance();
+				std::vector<std::vector<RawKey<depth>>> groups(topology.nodes());
+				for (const auto &key : keys)
+					groups[topology.nodeOf(key[0])].push_back(key);
+				keys.clear();
+				for (auto &group : groups) {
+					if (group.empty())
+						continue;
+					const auto memory_policy = storage.placeNodes(group.front()[0]);
+					RekNodeModification<max_depth, depth, tri> update{this->storage, nodec};
+					update.apply_update(std::move(group));
+				}
+				return;
+			}
+			const auto memory_policy = storage.placeNodes(keys.empty() ? key_part_type{} : keys.front()[0]);
 			RekNodeModification<max_depth, depth, tri> update{this->storage, nodec};
 			update.apply_update(std::move(keys));
 		}
@@ -242,7 +261,7 @@ namespace hypertrie::internal::raw {
 							return {};
 
 						} else {
-							nc.node() = new CompressedNode<result_depth, tri>();
+							nc.node() = ContextlessNodePool<result_depth, tri>::acquire();
 							// todo: don't return a new node if the compressednode is not sliced
 							size_t slice_pos = 0;
 							size_t result_pos = 0;
@@ -340,7 +359,7 @@ namespace hypertrie::internal::raw {
 
 							} else {
 								if (contextless_compressed_result == nullptr)
-									nc.node() = new CompressedNode<result_depth, tri>();
+									nc.node() = ContextlessNodePool<result_depth, tri>::acquire();
 								else
 									nc.node() = contextless_compressed_result;
 								size_t read_pos = 0;
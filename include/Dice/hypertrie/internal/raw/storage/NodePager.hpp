@@ -0,0 +1,380 @@
+#ifndef HYPERTRIE_NODEPAGER_HPP
+#define HYPERTRIE_NODEPAGER_HPP
+
+#include <array>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "Dice/hypertrie/internal/container/SwissMap.hpp"
+#include "Dice/hypertrie/internal/raw/Hypertrie_internal_traits.hpp"
+#include "Dice/hypertrie/internal/raw/node/Node.hpp"
+#include "Dice/hypertrie/internal/raw/node/TensorHash.hpp"
+#include "Dice/hypertrie/internal/raw/storage/NodeCodec.hpp"
+
+namespace hypertrie::internal::raw {
+
+	struct NodePagingConfig {
+		/**
+		 * The page file. It is a scratch file: an existing file is replaced and the file is removed with the NodeStorage.
+		 * Use checkpoints (see NodeStorageCheckpoint) to persist a NodeStorage.
+		 */
+		std::filesystem::path page_file;
+		/**
+		 * Maximal number of nodes of unpinned depths kept in memory after an eviction.
+		 */
+		size_t max_resident_nodes = 1UL << 24;
+		/**
+		 * Nodes of this depth and above are never evicted. It must not be greater than the depth of any hypertrie of the
+		 * storage, so that root nodes stay in memory.
+		 */
+		size_t pinned_depth = 3;
+	};
+
+	/**
+	 * Page file and page table of a NodeStorage with paging enabled (see NodeStorage::enablePaging()).
+	 *
+	 * Nodes are immutable and content-addressed, so a node is written to the page file at most once per hash: the record
+	 * of an evicted node is kept when the node is faulted in again and reused when it is evicted again. Records contain the
+	 * node encoded by NodeCodec, ref_counts are kept in the page table. Records of nodes that left the storage become dead
+	 * and are dropped when the page file is compacted.
+	 *
+	 * Recency of access is tracked per node by a global access epoch. Nodes that were not accessed since they were created
+	 * count as least recently used. NodeStorage only records sampled accesses (see NodeStorage::getPagedNode()), so
+	 * recency is approximate.
+	 *
+	 * All methods must be called with mutex() locked exclusively. NodeStorage looks up resident nodes with mutex() locked
+	 * shared, so that concurrent readers do not serialize.
+	 */
+	template<size_t max_depth, HypertrieInternalTrait tri_t>
+	class NodePager {
+	public:
+		using tri = tri_t;
+
+	private:
+		struct PageEntry {
+			uint64_t offset;
+			uint64_t size;
+			size_t ref_count;
+			/**
+			 * The node is in memory, the record is a clean copy of it.
+			 */
+			bool resident;
+		};
+
+		using PageTable = container::swiss_map<TensorHash, PageEntry>;
+		using AccessTable = container::swiss_map<TensorHash, uint64_t>;
+		using HoldTable = container::swiss_map<TensorHash, size_t>;
+
+		/**
+		 * Compaction is considered once this many bytes of the page file are dead.
+		 */
+		static constexpr const uint64_t min_compaction_dead_bytes = 64UL << 20;
+
+		class ByteWriter {
+			std::vector<std::byte> &buffer_;
+
+		public:
+			explicit ByteWriter(std::vector<std::byte> &buffer) : buffer_(buffer) {}
+
+			template<typename T>
+			void write(const T &value) {
+				const auto *bytes = reinterpret_cast<const std::byte *>(&value);
+				buffer_.insert(buffer_.end(), bytes, bytes + sizeof(T));
+			}
+
+			void write(const TensorHash &hash) {
+				write(hash.hash());
+			}
+		};
+
+		class ByteReader {
+			const std::byte *pos_;
+
+		public:
+			explicit ByteReader(const std::byte *data) : pos_(data) {}
+
+			template<typename T>
+			T read() {
+				T value;
+				std::memcpy(&value, pos_, sizeof(T));
+				pos_ += sizeof(T);
+				return value;
+			}
+
+			TensorHash readHash() {
+				return TensorHash(read<RawTensorHash>());
+			}
+		};
+
+		NodePagingConfig config_;
+		int fd_;
+		uint64_t file_size_ = 0;
+		uint64_t dead_bytes_ = 0;
+		uint64_t epoch_ = 0;
+		std::array<PageTable, max_depth> pages_;
+		std::array<AccessTable, max_depth> accesses_;
+		std::array<size_t, max_depth> evicted_{};
+		/**
+		 * Number of holds per node, see holdRoot().
+		 */
+		std::array<HoldTable, max_depth> holds_;
+		/**
+		 * Records of the current eviction, appended to the page file by flush().
+		 */
+		std::vector<std::byte> pending_;
+		std::vector<std::byte> read_buffer_;
+		std::shared_mutex mutex_;
+
+		[[noreturn]] void fail(const char *what) const {
+			throw std::system_error{errno, std::generic_category(), fmt::format("{} {}", what, config_.page_file.string())};
+		}
+
+		void writeFully(int fd, const std::byte *data, size_t size, uint64_t offset) const {
+			while (size > 0) {
+				ssize_t written = ::pwrite(fd, data, size, off_t(offset));
+				if (written < 0) {
+					if (errno == EINTR)
+						continue;
+					fail("could not write page file");
+				}
+				data += written;
+				offset += uint64_t(written);
+				size -= size_t(written);
+			}
+		}
+
+		void readFully(std::byte *data, size_t size, uint64_t offset) const {
+			while (size > 0) {
+				ssize_t read = ::pread(fd_, data, size, off_t(offset));
+				if (read < 0) {
+					if (errno == EINTR)
+						continue;
+					fail("could not read page file");
+				}
+				if (read == 0)
+					throw std::runtime_error{fmt::format("page file {} is truncated", config_.page_file.string())};
+				data += read;
+				offset += uint64_t(read);
+				size -= size_t(read);
+			}
+		}
+
+		const std::byte *readRecord(const PageEntry &entry) {
+			read_buffer_.resize(entry.size);
+			readFully(read_buffer_.data(), entry.size, entry.offset);
+			return read_buffer_.data();
+		}
+
+		/**
+		 * Rewrites the page file with the live records only.
+		 */
+		void compact() {
+			const std::filesystem::path tmp_path = config_.page_file.string() + ".compact";
+			const int fd = ::open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+			if (fd < 0)
+				fail("could not compact page file");
+			uint64_t offset = 0;
+			try {
+				for (auto &pages : pages_)
+					for (auto &[hash, entry] : pages) {
+						writeFully(fd, readRecord(entry), entry.size, offset);
+						entry.offset = offset;
+						offset += entry.size;
+					}
+				std::filesystem::rename(tmp_path, config_.page_file);
+			} catch (...) {
+				::close(fd);
+				std::filesystem::remove(tmp_path);
+				throw;
+			}
+			::close(fd_);
+			fd_ = fd;
+			file_size_ = offset;
+			dead_bytes_ = 0;
+		}
+
+	public:
+		explicit NodePager(NodePagingConfig config)
+			: config_(std::move(config)),
+			  fd_(::open(config_.page_file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600)) {
+			if (fd_ < 0)
+				fail("could not open page file");
+		}
+
+		NodePager(const NodePager &) = delete;
+		NodePager &operator=(const NodePager &) = delete;
+
+		~NodePager() {
+			::close(fd_);
+			std::filesystem::remove(config_.page_file);
+		}
+
+		[[nodiscard]] const NodePagingConfig &config() const noexcept { return config_; }
+
+		[[nodiscard]] std::shared_mutex &mutex() noexcept { return mutex_; }
+
+		[[nodiscard]] bool pinned(size_t depth) const noexcept { return depth >= config_.pinned_depth; }
+
+		/**
+		 * @return number of nodes of the given depth that are not in memory
+		 */
+		[[nodiscard]] size_t evictedNodes(size_t depth) const noexcept { return evicted_[depth - 1]; }
+
+		[[nodiscard]] size_t evictedNodes() const noexcept {
+			size_t evicted = 0;
+			for (auto count : evicted_)
+				evicted += count;
+			return evicted;
+		}
+
+		[[nodiscard]] uint64_t fileSize() const noexcept { return file_size_; }
+
+		void touch(size_t depth, const TensorHash &hash) {
+			if (not pinned(depth))
+				accesses_[depth - 1][hash] = ++epoch_;
+		}
+
+		/**
+		 * Keeps a node of an unpinned depth in memory until releaseRoot() was called as often. Pinned const_Hypertries hold
+		 * their root node by pointer, so it must not be evicted.
+		 */
+		void holdRoot(size_t depth, const TensorHash &hash) {
+			if (not pinned(depth))
+				++holds_[depth - 1][hash];
+		}
+
+		void releaseRoot(size_t depth, const TensorHash &hash) {
+			if (pinned(depth))
+				return;
+			auto &holds = holds_[depth - 1];
+			auto found = holds.find(hash);
+			assert(found != holds.end());
+			if (--found->second == 0)
+				holds.erase(found);
+		}
+
+		/**
+		 * @return true if the node is held by holdRoot() and must not be evicted
+		 */
+		[[nodiscard]] bool held(size_t depth, const TensorHash &hash) const noexcept {
+			return not pinned(depth) and holds_[depth - 1].count(hash) != 0;
+		}
+
+		/**
+		 * @return the last access epoch of the node, 0 if it was not accessed
+		 */
+		[[nodiscard]] uint64_t lastAccess(size_t depth, const TensorHash &hash) const noexcept {
+			const auto &accesses = accesses_[depth - 1];
+			auto found = accesses.find(hash);
+			return (found != accesses.end()) ? found->second : 0;
+		}
+
+		/**
+		 * Evicts a node. The node is deleted, the caller must remove it from the storage. Records are written by flush().
+		 */
+		template<size_t depth, NodeCompression compression>
+		void evict(const TensorHash &hash, Node<depth, compression, tri> *node) {
+			auto &pages = pages_[depth - 1];
+			if (auto found = pages.find(hash); found != pages.end()) {
+				found->second.ref_count = node->ref_count();
+				found->second.resident = false;
+			} else {
+				const uint64_t offset = file_size_ + pending_.size();
+				ByteWriter out{pending_};
+				NodeCodec<depth, tri>::write(out, *node);
+				pages.insert({hash, PageEntry{offset, file_size_ + pending_.size() - offset, node->ref_count(), false}});
+			}
+			accesses_[depth - 1].erase(hash);
+			++evicted_[depth - 1];
+			delete node;
+		}
+
+		/**
+		 * Appends the records of evicted nodes to the page file and compacts it if more than half of it is dead.
+		 */
+		void flush() {
+			writeFully(fd_, pending_.data(), pending_.size(), file_size_);
+			file_size_ += pending_.size();
+			pending_.clear();
+			if (dead_bytes_ >= min_compaction_dead_bytes and dead_bytes_ * 2 > file_size_)
+				compact();
+		}
+
+		/**
+		 * Loads an evicted node. The caller must insert it into the storage.
+		 * @return the node or nullptr if the node is not evicted
+		 */
+		template<size_t depth, NodeCompression compression>
+		Node<depth, compression, tri> *fault(const TensorHash &hash) {
+			auto &pages = pages_[depth - 1];
+			auto found = pages.find(hash);
+			if (found == pages.end() or found->second.resident)
+				return nullptr;
+			PageEntry &entry = found->second;
+			ByteReader in{readRecord(entry)};
+			Node<depth, compression, tri> *node = [&]() {
+				if constexpr (compression == NodeCompression::compressed)
+					return NodeCodec<depth, tri>::readCompressed(in, entry.ref_count);
+				else
+					return NodeCodec<depth, tri>::readUncompressed(in, entry.ref_count);
+			}();
+			entry.resident = true;
+			--evicted_[depth - 1];
+			return node;
+		}
+
+		/**
+		 * Drops the record of a node that left the storage.
+		 */
+		void discard(size_t depth, const TensorHash &hash) {
+			auto &pages = pages_[depth - 1];
+			if (auto found = pages.find(hash); found != pages.end()) {
+				dead_bytes_ += found->second.size;
+				if (not found->second.resident)
+					--evicted_[depth - 1];
+				pages.erase(found);
+			}
+			accesses_[depth - 1].erase(hash);
+		}
+
+		/**
+		 * Calls on_compressed(hash, node) or on_uncompressed(hash, node) for every evicted node of the given depth. The
+		 * nodes are loaded temporarily, they are not faulted in.
+		 */
+		template<size_t depth, typename OnCompressed, typename OnUncompressed>
+		void forEachEvicted(OnCompressed &&on_compressed, OnUncompressed &&on_uncompressed) {
+			for (const auto &[hash, entry] : pages_[depth - 1]) {
+				if (entry.resident)
+					continue;
+				ByteReader in{readRecord(entry)};
+				if (hash.isCompressed()) {
+					if constexpr (not(depth == 1 and tri::is_lsb_unused and tri::is_bool_valued)) {
+						std::unique_ptr<CompressedNode<depth, tri>> node{NodeCodec<depth, tri>::readCompressed(in, entry.ref_count)};
+						on_compressed(hash, *node);
+					}
+				} else {
+					std::unique_ptr<UncompressedNode<depth, tri>> node{NodeCodec<depth, tri>::readUncompressed(in, entry.ref_count)};
+					on_uncompressed(hash, *node);
+				}
+			}
+		}
+	};
+
+}// namespace hypertrie::internal::raw
+
+#endif//HYPERTRIE_NODEPAGER_HPP
@@ -1,11 +1,20 @@
 #ifndef HYPERTRIE_LEVELNODESTORAGE_HPP
 #define HYPERTRIE_LEVELNODESTORAGE_HPP
 
+#include "Dice/hypertrie/internal/container/SwissSet.hpp"
 #include "Dice/hypertrie/internal/raw/Hypertrie_internal_traits.hpp"
 #include "Dice/hypertrie/internal/raw/node/Node.hpp"
 #include "Dice/hypertrie/internal/raw/node/TensorHash.hpp"
+#include "Dice/hypertrie/internal/raw/storage/NodePager.hpp"
 #include "Dice/hypertrie/internal/util/CONSTANTS.hpp"
 #include "Dice/hypertrie/internal/util/IntegralTemplatedTuple.hpp"
+#include "Dice/hypertrie/internal/util/Numa.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
 
 namespace hypertrie::internal::raw {
 
@@ -15,11 +24,11 @@ namespace hypertrie::internal::raw {
 	struct LevelNodeStorage {
 		using tri = tri_t;
 		template<typename K, typename V>
-		using map_type = typename tri::template map_type<K, V*>;
+		using map_type = typename tri::template storage_map_type<depth, K, V*>;
 		using CompressedNodeMap = map_type<TensorHash, CompressedNode<depth, tri>>;
 		using UncompressedNodeMap = map_type<TensorHash, UncompressedNode<depth, tri>>;
-		// TODO: add "revision" for compressed_nodes_ and uncompressed_nodes_
-		// TODO: A node container must be updated if the revision does not fit the associated node storage
+		// Revisions are not stored explicitly: nodes are immutable, hash-addressed and reference counted.
+		// A revision is pinned by holding a reference on its root node (see Hypertrie::snapshot()).
 	protected:
 		CompressedNodeMap compressed_nodes_;
 		UncompressedNodeMap uncompressed_nodes_;
@@ -40,7 +49,7 @@ namespace hypertrie::internal::raw {
 
 		template<NodeCompression compression>
 		static Node<depth, compression, tri> &deref(typename map_type<TensorHash, Node<depth, compression, tri>>::iterator &map_it) {
-			return *tri::template deref<TensorHash, Node<depth, compression, tri>*>(map_it);
+			return *tri::template deref<map_type<TensorHash, Node<depth, compression, tri>>>(map_it);
 		}
 
 		explicit operator std::string() const {
@@ -55,7 +64,7 @@ namespace hypertrie::internal::raw {
 	struct LevelNodeStorage<1, tri_t, std::enable_if_t<(tri_t::is_lsb_unused and tri_t::is_bool_valued)>> {
 		using tri = tri_t;
 		template<typename K, typename V>
-		using map_type = typename tri::template map_type<K, V*>;
+		using map_type = typename tri::template storage_map_type<1, K, V*>;
 		using UncompressedNodeMap = map_type<TensorHash, UncompressedNode<1, tri>>;
 	protected:
 		UncompressedNodeMap uncompressed_nodes_;
@@ -72,7 +81,7 @@ namespace hypertrie::internal::raw {
 		template <NodeCompression compression = NodeCompression::uncompressed>
 		static UncompressedNode<1, tri> &deref(typename map_type<TensorHash, UncompressedNode<1, tri>>::iterator &map_it) {
 			assert(compression == NodeCompression::uncompressed);
-			return *tri::template deref<TensorHash, UncompressedNode<1, tri>*>(map_it);
+			return *tri::template deref<UncompressedNodeMap>(map_it);
 		}
 
 		explicit operator std::string() const {
@@ -82,6 +91,52 @@ namespace hypertrie::internal::raw {
 		}
 	};
 
+	/**
+	 * Changes to the nodes of one depth of a NodeStorage since the last checkpoint (see NodeStorageCheckpoint).
+	 * Relative to the nodes at the last checkpoint, created holds the nodes that were added, retired the nodes that were
+	 * removed and recounted the remaining nodes whose ref_count changed.
+	 */
+	class NodeJournal {
+		using HashSet = container::swiss_set<TensorHash>;
+
+		HashSet created_;
+		HashSet retired_;
+		HashSet recounted_;
+
+	public:
+		void created(const TensorHash &hash) {
+			// the node is content-addressed, so a node that reappears is unchanged apart from its ref_count
+			if (retired_.erase(hash))
+				recounted_.insert(hash);
+			else
+				created_.insert(hash);
+		}
+
+		void retired(const TensorHash &hash) {
+			if (created_.erase(hash))
+				return;// never checkpointed
+			recounted_.erase(hash);
+			retired_.insert(hash);
+		}
+
+		void recounted(const TensorHash &hash) {
+			if (not created_.contains(hash))
+				recounted_.insert(hash);
+		}
+
+		[[nodiscard]] const HashSet &created() const noexcept { return created_; }
+
+		[[nodiscard]] const HashSet &retired() const noexcept { return retired_; }
+
+		[[nodiscard]] const HashSet &recounted() const noexcept { return recounted_; }
+
+		void clear() {
+			created_.clear();
+			retired_.clear();
+			recounted_.clear();
+		}
+	};
+
 	template<size_t max_depth,
 			 HypertrieInternalTrait tri_t = Hypertrie_internal_t<>,
 			 typename = typename std::enable_if_t<(max_depth >= 1)>>
@@ -112,6 +167,33 @@ namespace hypertrie::internal::raw {
 
 		storage_t storage_;
 
+		/**
+		 * Journals per depth (index depth - 1). Changes are only journaled while tracking is enabled.
+		 */
+		std::array<NodeJournal, max_depth> journals_;
+		bool tracks_changes_ = false;
+
+		/**
+		 * Pages nodes of unpinned depths out to disk. nullptr unless paging is enabled.
+		 */
+		std::unique_ptr<NodePager<max_depth, tri>> pager_;
+
+		util::NumaPlacement numa_placement_ = util::NumaPlacement::first_touch;
+
+		/**
+		 * getPagedNode() records every this many accesses of a thread in the pager. Faults are always recorded.
+		 */
+		static constexpr const size_t touch_sample_interval = 16;
+
+		/**
+		 * A node of an unpinned depth that may be evicted.
+		 */
+		struct EvictionCandidate {
+			uint64_t last_access;
+			size_t depth;
+			TensorHash hash;
+		};
+
 
 		// TODO: remove
 		template<size_t depth>
@@ -124,6 +206,90 @@ namespace hypertrie::internal::raw {
 			return this->storage_.template get<depth>();
 		}
 
+		template<size_t depth, NodeCompression compression>
+		SpecificNodeContainer<depth, compression, tri> findNode(const TensorHash &node_hash) {
+			auto &nodes = getNodeStorage<depth, compression>();
+			auto found = nodes.find(node_hash);
+			if (found != nodes.end())
+				if constexpr((depth == 1 and tri_t::is_lsb_unused and tri_t::is_bool_valued))
+					return {node_hash, &LevelNodeStorage<depth, tri>::deref(found)};
+				else
+					return {node_hash, &LevelNodeStorage<depth, tri>::template deref<compression>(found)};
+			else
+				return {};
+		}
+
+		/**
+		 * Looks up a node and faults it in if it was evicted.
+		 *
+		 * Resident nodes are looked up with the pager mutex locked shared. Only every touch_sample_interval-th access of a
+		 * thread is recorded by NodePager::touch(), which needs the mutex locked exclusively, as do faults.
+		 */
+		template<size_t depth, NodeCompression compression>
+		SpecificNodeContainer<depth, compression, tri> getPagedNode(const TensorHash &node_hash) {
+			static thread_local size_t accesses = 0;
+			const bool sampled = (++accesses % touch_sample_interval) == 0 and not pager_->pinned(depth);
+			if (not sampled) {
+				std::shared_lock lock{pager_->mutex()};
+				auto nodec = findNode<depth, compression>(node_hash);
+				if (not nodec.null())
+					return nodec;
+			}
+			std::unique_lock lock{pager_->mutex()};
+			auto nodec = findNode<depth, compression>(node_hash);
+			if (nodec.null()) {
+				auto *node = pager_->template fault<depth, compression>(node_hash);
+				if (node == nullptr)
+					return {};
+				getNodeStorage<depth, compression>().insert({node_hash, node});
+				nodec = {node_hash, node};
+			}
+			pager_->touch(depth, node_hash);
+			return nodec;
+		}
+
+		template<size_t depth = 1>
+		void collectEvictionCandidates(std::vector<EvictionCandidate> &candidates) {
+			if (pager_->pinned(depth))
+				return;
+			const auto collect = [&](const auto &nodes) {
+				for (const auto &[hash, node] : nodes)
+					if (not pager_->held(depth, hash))
+						candidates.push_back({pager_->lastAccess(depth, hash), depth, hash});
+			};
+			collect(getNodeStorage<depth, NodeCompression::uncompressed>());
+			if constexpr (not(depth == 1 and tri_t::is_lsb_unused and tri_t::is_bool_valued))
+				collect(getNodeStorage<depth, NodeCompression::compressed>());
+			if constexpr (depth < max_depth)
+				collectEvictionCandidates<depth + 1>(candidates);
+		}
+
+		template<size_t depth, NodeCompression compression>
+		void evictNode(const TensorHash &node_hash) {
+			auto &nodes = getNodeStorage<depth, compression>();
+			auto it = nodes.find(node_hash);
+			assert(it != nodes.end());
+			pager_->template evict<depth, compression>(node_hash, &LevelNodeStorage<depth, tri>::template deref<compression>(it));
+			nodes.erase(it);
+		}
+
+		/**
+		 * Evicts the candidates of depth and above. The candidates are sorted by depth.
+		 */
+		template<size_t depth = 1>
+		void evictCandidates(const EvictionCandidate *candidate, const EvictionCandidate *end) {
+			for (; candidate != end and candidate->depth == depth; ++candidate) {
+				if (candidate->hash.isCompressed()) {
+					if constexpr (not(depth == 1 and tri_t::is_lsb_unused and tri_t::is_bool_valued))
+						evictNode<depth, NodeCompression::compressed>(candidate->hash);
+				} else {
+					evictNode<depth, NodeCompression::uncompressed>(candidate->hash);
+				}
+			}
+			if constexpr (depth < max_depth)
+				evictCandidates<depth + 1>(candidate, end);
+		}
+
 	public:
 		// TODO: private?
 		template<size_t depth, NodeCompression compression, typename = std::enable_if_t<(not (depth == 1 and tri_t::is_lsb_unused and tri_t::is_bool_valued and compression == NodeCompression::compressed))>>
@@ -136,15 +302,9 @@ namespace hypertrie::internal::raw {
 
 		template<size_t depth, NodeCompression compression, typename = std::enable_if_t<(not (depth == 1 and tri_t::is_lsb_unused and tri_t::is_bool_valued and compression == NodeCompression::compressed))>>
 		SpecificNodeContainer<depth, compression, tri> getNode(const TensorHash &node_hash) {
-			auto &nodes = getNodeStorage<depth, compression>();
-			auto found = nodes.find(node_hash);
-			if (found != nodes.end())
-				if constexpr((depth == 1 and tri_t::is_lsb_unused and tri_t::is_bool_valued))
-					return {node_hash, &LevelNodeStorage<depth, tri>::deref(found)};
-				else
-					return {node_hash, &LevelNodeStorage<depth, tri>::template deref<compression>(found)};
-			else
-				return {};
+			if (pager_)
+				return getPagedNode<depth, compression>(node_hash);
+			return findNode<depth, compression>(node_hash);
 		}
 
 		template<size_t depth, typename = std::enable_if_t<(not (depth == 1 and tri_t::is_lsb_unused and tri_t::is_bool_valued))>>
@@ -199,6 +359,7 @@ namespace hypertrie::internal::raw {
 			if constexpr (not keep_old) {
 				const auto removed = nodes.erase(nc.hash());
 				assert(removed);
+				discardPage<depth>(nc.hash());
 				it = nodes.find(new_hash);// iterator was invalidates by modifying nodes. get a new one
 			}
 			auto &node = LevelNodeStorage<depth, tri>::template deref<compression>(it);
@@ -222,6 +383,7 @@ namespace hypertrie::internal::raw {
 			auto *node = &LevelNodeStorage<depth, tri>::template deref<compression>(it);
 			delete node;
 			nodes.erase(it);
+			discardPage<depth>(node_hash);
 		}
 
 		void setLSBCompressedLeaf(NodeContainer<1, tri> &nodec, const key_part_type &key_part, const bool &value) {
@@ -240,6 +402,124 @@ namespace hypertrie::internal::raw {
 			}
 		}
 
+		/**
+		 * Starts journaling created, retired and recounted nodes. Called by NodeStorageCheckpoint after a checkpoint was written.
+		 */
+		void trackChanges() noexcept {
+			tracks_changes_ = true;
+		}
+
+		[[nodiscard]] bool tracksChanges() const noexcept {
+			return tracks_changes_;
+		}
+
+		/**
+		 * @return the journal of the given depth or nullptr if changes are not tracked
+		 */
+		template<size_t depth>
+		NodeJournal *journal() noexcept {
+			return (tracks_changes_) ? &journals_[depth - 1] : nullptr;
+		}
+
+		void clearJournals() {
+			for (auto &journal : journals_)
+				journal.clear();
+		}
+
+		/**
+		 * Enables paging: evict() moves the least recently used nodes of depths below config.pinned_depth to a page file,
+		 * getNode() faults them in again. Paging cannot be disabled.
+		 */
+		void enablePaging(const NodePagingConfig &config) {
+			if (pager_)
+				throw std::logic_error{"paging is already enabled"};
+			pager_ = std::make_unique<NodePager<max_depth, tri>>(config);
+		}
+
+		/**
+		 * @return the pager or nullptr if paging is not enabled
+		 */
+		[[nodiscard]] NodePager<max_depth, tri> *pager() noexcept {
+			return pager_.get();
+		}
+
+		/**
+		 * Keeps the node from being evicted until releaseRoot() was called as often. Pinned const_Hypertries call it for
+		 * their root node. Does nothing unless paging is enabled.
+		 */
+		void holdRoot(size_t depth, const TensorHash &node_hash) {
+			if (not pager_)
+				return;
+			std::lock_guard lock{pager_->mutex()};
+			pager_->holdRoot(depth, node_hash);
+		}
+
+		void releaseRoot(size_t depth, const TensorHash &node_hash) {
+			if (not pager_)
+				return;
+			std::lock_guard lock{pager_->mutex()};
+			pager_->releaseRoot(depth, node_hash);
+		}
+
+		/**
+		 * Evicts the least recently used nodes of unpinned depths until at most NodePagingConfig::max_resident_nodes of them
+		 * are in memory. Root nodes of pinned const_Hypertries, e.g. snapshots and cached slices, are kept (see holdRoot()).
+		 * Other pointers to nodes of unpinned depths, e.g. held by iterators and unpinned slices, become invalid.
+		 * @return number of evicted nodes
+		 */
+		size_t evict() {
+			if (not pager_)
+				return 0;
+			std::lock_guard lock{pager_->mutex()};
+			std::vector<EvictionCandidate> candidates;
+			collectEvictionCandidates(candidates);
+			const size_t max_resident_nodes = pager_->config().max_resident_nodes;
+			if (candidates.size() <= max_resident_nodes)
+				return 0;
+			const auto evicted_end = candidates.begin() + std::ptrdiff_t(candidates.size() - max_resident_nodes);
+			std::nth_element(candidates.begin(), evicted_end, candidates.end(),
+							 [](const auto &a, const auto &b) { return a.last_access < b.last_access; });
+			std::sort(candidates.begin(), evicted_end,
+					  [](const auto &a, const auto &b) { return a.depth < b.depth; });
+			evictCandidates(candidates.data(), candidates.data() + (evicted_end - candidates.begin()));
+			pager_->flush();
+			return size_t(evicted_end - candidates.begin());
+		}
+
+		/**
+		 * Drops the page of a node that was removed from the storage under node_hash.
+		 */
+		template<size_t depth>
+		void discardPage(const TensorHash &node_hash) {
+			if (pager_) {
+				std::lock_guard lock{pager_->mutex()};
+				pager_->discard(depth, node_hash);
+			}
+		}
+
+		/**
+		 * Sets where nodes created by later bulk loads are allocated. Existing nodes are not moved. The placement is
+		 * best-effort, see util::ScopedMemoryPolicy.
+		 */
+		void setNumaPlacement(util::NumaPlacement placement) noexcept {
+			numa_placement_ = placement;
+		}
+
+		[[nodiscard]] util::NumaPlacement numaPlacement() const noexcept {
+			return numa_placement_;
+		}
+
+		/**
+		 * Applies the NUMA placement to the memory allocated by the calling thread while the returned policy lives. Each
+		 * policy costs system calls, so it is meant to span a whole bulk load.
+		 * @param first_key_part first key part of the keys that are modified, determines the NUMA node with NumaPlacement::partitioned
+		 */
+		[[nodiscard]] util::ScopedMemoryPolicy placeNodes(key_part_type first_key_part) const noexcept {
+			if (numa_placement_ == util::NumaPlacement::partitioned)
+				return {numa_placement_, util::NumaTopology::instance().nodeOf(first_key_part)};
+			return {numa_placement_};
+		}
+
 		explicit operator std::string() const {
 			return std::string(
 					fmt::format("[ NodeStorage \n"
@@ -0,0 +1,458 @@
+#ifndef HYPERTRIE_NODESTORAGECHECKPOINT_HPP
+#define HYPERTRIE_NODESTORAGECHECKPOINT_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Dice/hypertrie/internal/raw/storage/NodeCodec.hpp"
+#include "Dice/hypertrie/internal/raw/storage/NodeStorage.hpp"
+
+namespace hypertrie::internal::raw {
+
+	/**
+	 * Root node of a hypertrie stored in a checkpoint.
+	 */
+	struct CheckpointRoot {
+		size_t depth;
+		RawTensorHash hash;
+	};
+
+	/**
+	 * Writes the nodes of a NodeStorage to checkpoint files and restores them.
+	 *
+	 * Nodes are content-addressed and immutable, so a checkpoint is a set of nodes keyed by TensorHash. The first checkpoint
+	 * of a NodeStorage contains all nodes. Afterwards, the storage journals its changes (see NodeJournal) and every further
+	 * checkpoint only contains the nodes created, the hashes of the nodes retired and the new ref_counts of the nodes
+	 * recounted since the checkpoint before. Children are referenced by hash, so unchanged subtries are never rewritten.
+	 *
+	 * A checkpoint file consists of a header (magic, full or incremental, max_depth), the changes per depth starting at
+	 * depth 1, the roots and a FNV-1a checksum over all bytes before it. Files are written to a temporary file and renamed,
+	 * so a crash during write() leaves the previous checkpoint intact. restore() checks the checksums of all layers before
+	 * it applies the first one.
+	 */
+	template<size_t max_depth, HypertrieInternalTrait tri_t>
+	class NodeStorageCheckpoint {
+	public:
+		using tri = tri_t;
+		using key_part_type = typename tri::key_part_type;
+		using value_type = typename tri::value_type;
+		using NodeStorage_t = NodeStorage<max_depth, tri>;
+
+	private:
+		static constexpr const uint32_t file_magic = 0x4b435448;// "HTCK"
+
+		static_assert(sizeof(key_part_type) <= sizeof(uint64_t) and sizeof(value_type) <= sizeof(uint64_t));
+
+		/**
+		 * Depth 1 compressed nodes of boolean lsb-unused hypertries are stored in the edges of their parents.
+		 */
+		template<size_t depth>
+		static constexpr const bool has_compressed_nodes = not(depth == 1 and tri::is_lsb_unused and tri::is_bool_valued);
+
+		static constexpr const uint64_t checksum_seed = 0xcbf29ce484222325UL;
+
+		static void fold(uint64_t &checksum, const std::byte *data, size_t size) noexcept {
+			for (const std::byte *end = data + size; data != end; ++data) {
+				checksum ^= uint64_t(*data);
+				checksum *= 0x100000001b3UL;
+			}
+		}
+
+		[[noreturn]] static void fail(const char *what, const std::filesystem::path &path) {
+			throw std::system_error{errno, std::generic_category(), fmt::format("{} {}", what, path.string())};
+		}
+
+		class Writer {
+			std::filesystem::path path_;
+			std::filesystem::path tmp_path_;
+			int fd_;
+			std::vector<std::byte> buffer_;
+			uint64_t checksum_ = checksum_seed;
+
+			static constexpr const size_t buffer_size = 1UL << 20;
+
+			void flush() {
+				fold(checksum_, buffer_.data(), buffer_.size());
+				writeBuffer();
+			}
+
+			void writeBuffer() {
+				const std::byte *data = buffer_.data();
+				size_t size = buffer_.size();
+				while (size > 0) {
+					ssize_t written = ::write(fd_, data, size);
+					if (written < 0) {
+						if (errno == EINTR)
+							continue;
+						fail("could not write checkpoint", tmp_path_);
+					}
+					data += written;
+					size -= size_t(written);
+				}
+				buffer_.clear();
+			}
+
+		public:
+			explicit Writer(const std::filesystem::path &path)
+				: path_(path), tmp_path_(path.string() + ".tmp"),
+				  fd_(::open(tmp_path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)) {
+				if (fd_ < 0)
+					fail("could not open checkpoint", tmp_path_);
+				buffer_.reserve(buffer_size);
+			}
+
+			Writer(const Writer &) = delete;
+			Writer &operator=(const Writer &) = delete;
+
+			~Writer() {
+				if (fd_ >= 0) {
+					// finish() was not reached, the previous checkpoint at path_ stays untouched
+					::close(fd_);
+					std::filesystem::remove(tmp_path_);
+				}
+			}
+
+			template<typename T>
+			void write(const T &value) {
+				const auto *bytes = reinterpret_cast<const std::byte *>(&value);
+				buffer_.insert(buffer_.end(), bytes, bytes + sizeof(T));
+				if (buffer_.size() >= buffer_size)
+					flush();
+			}
+
+			void write(const TensorHash &hash) {
+				write(hash.hash());
+			}
+
+			void finish() {
+				flush();
+				const uint64_t checksum = checksum_;
+				const auto *bytes = reinterpret_cast<const std::byte *>(&checksum);
+				buffer_.insert(buffer_.end(), bytes, bytes + sizeof(checksum));
+				writeBuffer();
+				if (::fsync(fd_) != 0)
+					fail("could not sync checkpoint", tmp_path_);
+				::close(fd_);
+				fd_ = -1;
+				std::filesystem::rename(tmp_path_, path_);
+			}
+		};
+
+		class Reader {
+			std::filesystem::path path_;
+			int fd_;
+			std::vector<std::byte> buffer_;
+			size_t pos_ = 0;
+
+			static constexpr const size_t buffer_size = 1UL << 20;
+
+			void readFully(std::byte *data, size_t size) {
+				while (size > 0) {
+					if (pos_ == buffer_.size()) {
+						buffer_.resize(buffer_size);
+						ssize_t read;
+						do {
+							read = ::read(fd_, buffer_.data(), buffer_size);
+						} while (read < 0 and errno == EINTR);
+						if (read < 0)
+							fail("could not read checkpoint", path_);
+						if (read == 0)
+							throw std::runtime_error{fmt::format("checkpoint {} is truncated", path_.string())};
+						buffer_.resize(size_t(read));
+						pos_ = 0;
+					}
+					const size_t n = std::min(size, buffer_.size() - pos_);
+					std::memcpy(data, buffer_.data() + pos_, n);
+					pos_ += n;
+					data += n;
+					size -= n;
+				}
+			}
+
+		public:
+			explicit Reader(const std::filesystem::path &path)
+				: path_(path), fd_(::open(path.c_str(), O_RDONLY)) {
+				if (fd_ < 0)
+					fail("could not open checkpoint", path_);
+			}
+
+			Reader(const Reader &) = delete;
+			Reader &operator=(const Reader &) = delete;
+
+			~Reader() {
+				::close(fd_);
+			}
+
+			template<typename T>
+			T read() {
+				T value;
+				readFully(reinterpret_cast<std::byte *>(&value), sizeof(T));
+				return value;
+			}
+
+			TensorHash readHash() {
+				return TensorHash(read<RawTensorHash>());
+			}
+
+			/**
+			 * Checks the checksum of the whole file. It does not move the read position.
+			 */
+			void verify() {
+				struct stat file_stat;
+				if (::fstat(fd_, &file_stat) != 0)
+					fail("could not read checkpoint", path_);
+				if (size_t(file_stat.st_size) < sizeof(uint64_t))
+					throw std::runtime_error{fmt::format("checkpoint {} is truncated", path_.string())};
+				const size_t size = size_t(file_stat.st_size) - sizeof(uint64_t);
+				std::vector<std::byte> chunk(std::min(size, buffer_size));
+				uint64_t checksum = checksum_seed;
+				for (size_t offset = 0; offset < size;) {
+					const ssize_t read = ::pread(fd_, chunk.data(), std::min(chunk.size(), size - offset), off_t(offset));
+					if (read < 0 and errno == EINTR)
+						continue;
+					if (read <= 0)
+						fail("could not read checkpoint", path_);
+					fold(checksum, chunk.data(), size_t(read));
+					offset += size_t(read);
+				}
+				uint64_t expected;
+				for (size_t read_bytes = 0; read_bytes < sizeof(expected);) {
+					const ssize_t read = ::pread(fd_, reinterpret_cast<std::byte *>(&expected) + read_bytes, sizeof(expected) - read_bytes, off_t(size + read_bytes));
+					if (read < 0 and errno == EINTR)
+						continue;
+					if (read <= 0)
+						fail("could not read checkpoint", path_);
+					read_bytes += size_t(read);
+				}
+				if (expected != checksum)
+					throw std::runtime_error{fmt::format("checkpoint {} is corrupted", path_.string())};
+			}
+		};
+
+		template<size_t depth>
+		static void writeCompressedNode(Writer &out, const TensorHash &hash, const CompressedNode<depth, tri> &node) {
+			out.write(hash);
+			out.write(uint64_t(node.ref_count()));
+			NodeCodec<depth, tri>::write(out, node);
+		}
+
+		template<size_t depth>
+		static void writeUncompressedNode(Writer &out, const TensorHash &hash, const UncompressedNode<depth, tri> &node) {
+			out.write(hash);
+			out.write(uint64_t(node.ref_count()));
+			NodeCodec<depth, tri>::write(out, node);
+		}
+
+		template<size_t depth>
+		static void writeNode(Writer &out, NodeStorage_t &storage, const TensorHash &hash) {
+			if (hash.isCompressed()) {
+				if constexpr (has_compressed_nodes<depth>)
+					writeCompressedNode<depth>(out, hash, *storage.template getCompressedNode<depth>(hash).compressed_node());
+			} else {
+				writeUncompressedNode<depth>(out, hash, *storage.template getUncompressedNode<depth>(hash).uncompressed_node());
+			}
+		}
+
+		template<size_t depth>
+		static void writeLevel(Writer &out, NodeStorage_t &storage, bool full) {
+			if (full) {
+				out.write(uint64_t(0));// retired
+				auto &uncompressed_nodes = storage.template getNodeStorage<depth, NodeCompression::uncompressed>();
+				auto *pager = storage.pager();
+				size_t created = uncompressed_nodes.size();
+				if constexpr (has_compressed_nodes<depth>)
+					created += storage.template getNodeStorage<depth, NodeCompression::compressed>().size();
+				if (pager != nullptr)
+					created += pager->evictedNodes(depth);
+				out.write(uint64_t(created));
+				if constexpr (has_compressed_nodes<depth>)
+					for (const auto &[hash, node] : storage.template getNodeStorage<depth, NodeCompression::compressed>())
+						writeCompressedNode<depth>(out, hash, *node);
+				for (const auto &[hash, node] : uncompressed_nodes)
+					writeUncompressedNode<depth>(out, hash, *node);
+				if (pager != nullptr) {
+					// evicted nodes are copied from the page file without faulting them in
+					std::lock_guard lock{pager->mutex()};
+					pager->template forEachEvicted<depth>(
+							[&](const TensorHash &hash, const CompressedNode<depth, tri> &node) { writeCompressedNode<depth>(out, hash, node); },
+							[&](const TensorHash &hash, const UncompressedNode<depth, tri> &node) { writeUncompressedNode<depth>(out, hash, node); });
+				}
+				out.write(uint64_t(0));// recounted
+			} else {
+				const NodeJournal &journal = *storage.template journal<depth>();
+				out.write(uint64_t(journal.retired().size()));
+				for (const auto &hash : journal.retired())
+					out.write(hash);
+				out.write(uint64_t(journal.created().size()));
+				for (const auto &hash : journal.created())
+					writeNode<depth>(out, storage, hash);
+				out.write(uint64_t(journal.recounted().size()));
+				for (const auto &hash : journal.recounted()) {
+					out.write(hash);
+					out.write(uint64_t(storage.template getNode<depth>(hash).ref_count()));
+				}
+			}
+			if constexpr (depth < max_depth)
+				writeLevel<depth + 1>(out, storage, full);
+		}
+
+		template<size_t depth>
+		[[noreturn]] static void inconsistent(const TensorHash &hash, const char *what) {
+			throw std::invalid_argument{fmt::format("checkpoint does not match the node storage: node {} at depth {} {}", hash.hash(), depth, what)};
+		}
+
+		template<size_t depth>
+		static void readCompressedNode(Reader &in, NodeStorage_t &storage, const TensorHash &hash) {
+			const size_t ref_count = in.template read<uint64_t>();
+			auto *node = NodeCodec<depth, tri>::readCompressed(in, ref_count);
+			if (not storage.template getNodeStorage<depth, NodeCompression::compressed>().insert({hash, node}).second) {
+				delete node;
+				inconsistent<depth>(hash, "exists already");
+			}
+		}
+
+		template<size_t depth>
+		static void readUncompressedNode(Reader &in, NodeStorage_t &storage, const TensorHash &hash) {
+			const size_t ref_count = in.template read<uint64_t>();
+			auto *node = NodeCodec<depth, tri>::readUncompressed(in, ref_count);
+			if (not storage.template getNodeStorage<depth, NodeCompression::uncompressed>().insert({hash, node}).second) {
+				delete node;
+				inconsistent<depth>(hash, "exists already");
+			}
+		}
+
+		/**
+		 * Looks up a node that must exist in storage.
+		 */
+		template<size_t depth>
+		static NodeContainer<depth, tri> storedNode(NodeStorage_t &storage, const TensorHash &hash) {
+			if constexpr (not has_compressed_nodes<depth>)
+				if (hash.isCompressed())
+					inconsistent<depth>(hash, "cannot be stored");
+			auto nodec = storage.template getNode<depth>(hash);
+			if (nodec.null())
+				inconsistent<depth>(hash, "does not exist");
+			return nodec;
+		}
+
+		template<size_t depth>
+		static void readLevel(Reader &in, NodeStorage_t &storage) {
+			for (size_t retired = in.template read<uint64_t>(); retired > 0; --retired) {
+				const TensorHash hash = in.readHash();
+				storedNode<depth>(storage, hash);
+				storage.template deleteNode<depth>(hash);
+			}
+			for (size_t created = in.template read<uint64_t>(); created > 0; --created) {
+				const TensorHash hash = in.readHash();
+				if (hash.isCompressed()) {
+					if constexpr (has_compressed_nodes<depth>)
+						readCompressedNode<depth>(in, storage, hash);
+					else
+						inconsistent<depth>(hash, "cannot be stored");
+				} else {
+					readUncompressedNode<depth>(in, storage, hash);
+				}
+			}
+			for (size_t recounted = in.template read<uint64_t>(); recounted > 0; --recounted) {
+				auto nodec = storedNode<depth>(storage, in.readHash());
+				nodec.ref_count() = in.template read<uint64_t>();
+			}
+			if constexpr (depth < max_depth)
+				readLevel<depth + 1>(in, storage);
+		}
+
+		template<size_t depth = 1>
+		static bool isEmpty(NodeStorage_t &storage) {
+			if constexpr (depth == 1)
+				if (auto *pager = storage.pager(); pager != nullptr and pager->evictedNodes() != 0)
+					return false;
+			bool empty = storage.template getNodeStorage<depth, NodeCompression::uncompressed>().empty();
+			if constexpr (has_compressed_nodes<depth>)
+				empty = empty and storage.template getNodeStorage<depth, NodeCompression::compressed>().empty();
+			if constexpr (depth < max_depth)
+				return empty and isEmpty<depth + 1>(storage);
+			else
+				return empty;
+		}
+
+	public:
+		/**
+		 * Writes a checkpoint of storage. It is a full checkpoint if storage did not track its changes yet, otherwise it
+		 * contains the changes since the last checkpoint. Afterwards, storage tracks the changes to the new checkpoint.
+		 * @param storage the node storage
+		 * @param roots the roots of the hypertries to restore
+		 * @param path the checkpoint file, an existing file is replaced
+		 * @return true if the checkpoint is incremental
+		 */
+		static bool write(NodeStorage_t &storage, const std::vector<CheckpointRoot> &roots, const std::filesystem::path &path) {
+			const bool full = not storage.tracksChanges();
+			Writer out{path};
+			out.write(file_magic);
+			out.write(uint32_t(full));
+			out.write(uint64_t(max_depth));
+			writeLevel<1>(out, storage, full);
+			out.write(uint64_t(roots.size()));
+			for (const auto &root : roots) {
+				out.write(uint64_t(root.depth));
+				out.write(root.hash);
+			}
+			out.finish();
+			storage.clearJournals();
+			storage.trackChanges();
+			return not full;
+		}
+
+		/**
+		 * Restores a chain of checkpoints into an empty storage. Afterwards, storage tracks the changes to the last checkpoint.
+		 * The ref_counts of the restored nodes are those at the time of the last checkpoint, i.e. they include the
+		 * references held by the roots.
+		 * The checksums of all layers are checked before storage is changed. If a layer with a valid checksum does not
+		 * match the chain, restoring fails with std::invalid_argument and storage is left partially restored.
+		 * @param storage an empty node storage
+		 * @param layers a full checkpoint followed by the incremental checkpoints written after it, in order
+		 * @return the roots of the last checkpoint
+		 */
+		static std::vector<CheckpointRoot> restore(NodeStorage_t &storage, const std::vector<std::filesystem::path> &layers) {
+			if (layers.empty())
+				throw std::invalid_argument{"no checkpoint to restore"};
+			if (not isEmpty(storage))
+				throw std::invalid_argument{"checkpoints can only be restored into an empty node storage"};
+			// a corrupted layer must not change storage
+			for (const auto &layer : layers)
+				Reader{layer}.verify();
+			std::vector<CheckpointRoot> roots;
+			for (size_t layer = 0; layer < layers.size(); ++layer) {
+				Reader in{layers[layer]};
+				if (in.template read<uint32_t>() != file_magic)
+					throw std::invalid_argument{fmt::format("{} is not a checkpoint", layers[layer].string())};
+				const bool full = in.template read<uint32_t>();
+				if (full != (layer == 0))
+					throw std::invalid_argument{fmt::format("checkpoint {} must be {}", layers[layer].string(), (layer == 0) ? "full" : "incremental")};
+				if (in.template read<uint64_t>() != max_depth)
+					throw std::invalid_argument{fmt::format("checkpoint {} was written with a different max depth", layers[layer].string())};
+				readLevel<1>(in, storage);
+				roots.resize(in.template read<uint64_t>());
+				for (auto &root : roots) {
+					root.depth = in.template read<uint64_t>();
+					root.hash = in.template read<RawTensorHash>();
+				}
+			}
+			storage.clearJournals();
+			storage.trackChanges();
+			return roots;
+		}
+	};
+
+}// namespace hypertrie::internal::raw
+
+#endif//HYPERTRIE_NODESTORAGECHECKPOINT_HPP
@@ -2,6 +2,7 @@
 #define HYPERTRIE_REKNODEMODIFICATION_HPP
 
 #include "Dice/hypertrie/internal/Hypertrie_traits.hpp"
+#include "Dice/hypertrie/internal/container/SwissMap.hpp"
 #include "Dice/hypertrie/internal/raw/node/NodeContainer.hpp"
 #include "Dice/hypertrie/internal/raw/node/TensorHash.hpp"
 #include "Dice/hypertrie/internal/raw/storage/Entry.hpp"
@@ -49,11 +50,17 @@ namespace hypertrie::internal::raw {
 		template <size_t depth>
 		struct CountDiffAndNodePtr{ long count_diff; NodePtr<depth, tri> node_ptr; };
 
+		// short-lived and probed for every touched node, so a flat hash table is used instead of a memory-optimized sparse map
 		template <size_t depth>
-		using LevelRefChanges = tsl::sparse_map<TensorHash, CountDiffAndNodePtr<depth>>;
+		using LevelRefChanges = container::swiss_map<TensorHash, CountDiffAndNodePtr<depth>>;
 
 		using RefChanges = util::IntegralTemplatedTuple<LevelRefChanges, 1, update_depth>;
 
+		template <size_t depth>
+		using LevelUpdateCounts = std::vector<std::pair<Modification_t<depth>, size_t>>;
+
+		using UpdateCounts = util::IntegralTemplatedTuple<LevelUpdateCounts, 1, update_depth>;
+
 		template <size_t depth>
 		using re = RawEntry_t<depth, tri>;
 
@@ -70,6 +77,11 @@ namespace hypertrie::internal::raw {
 
 		RefChanges ref_changes{};
 
+		// work buffers of apply_update_rek. They are members, so that modifications of different hypertries, e.g. of the
+		// shards of a ShardedHypertrie, can run on different threads.
+		UpdateCounts moveable_updates{};
+		UpdateCounts unmoveable_updates{};
+
 		template<size_t updates_depth>
 		auto getRefChanges()
 				-> LevelRefChanges<updates_depth> & {
@@ -113,7 +125,7 @@ namespace hypertrie::internal::raw {
 			: node_storage(nodeStorage), nodec{nodec} {}
 
 		void apply_decrement_ref_count(const size_t decrement = 1) {
-			planChangeCount<update_depth>(nodec.hash(), decrement * DEC_COUNT_DIFF_AFTER);
+			planChangeCount<update_depth>(TensorHash(nodec.hash()), decrement * DEC_COUNT_DIFF_AFTER);
 			apply_update_rek<update_depth>();
 		}
 
@@ -244,6 +256,8 @@ namespace hypertrie::internal::raw {
 				if (not nodec.null()){
 					size_t &ref_count = nodec.ref_count();
 					ref_count += diff_u_ptr.count_diff;
+					if (auto *journal = node_storage.template journal<depth>())
+						journal->recounted(hash);
 
 					if (ref_count == 0) {
 						unreferenced_nodes_before.insert({hash, nodec.node()});
@@ -254,7 +268,7 @@ namespace hypertrie::internal::raw {
 				}
 			}
 
-			static std::vector<std::pair<Modification_t<depth>, size_t>> moveable_multi_updates{};
+			LevelUpdateCounts<depth> &moveable_multi_updates = moveable_updates.template get<depth>();
 			moveable_multi_updates.clear();
 			moveable_multi_updates.reserve(multi_updates.size());
 			// extract movables
@@ -274,7 +288,7 @@ namespace hypertrie::internal::raw {
 				}
 			}
 
-			static std::vector<std::pair<Modification_t<depth>, size_t>> unmoveable_multi_updates{};
+			LevelUpdateCounts<depth> &unmoveable_multi_updates = unmoveable_updates.template get<depth>();
 			unmoveable_multi_updates.clear();
 			unmoveable_multi_updates.reserve(multi_updates.size());
 			// extract unmovables
@@ -361,6 +375,8 @@ namespace hypertrie::internal::raw {
 					this->template updateChildrenCountDiff<depth>(node, children_count_diff);
 
 			node_storage.template deleteNode<depth>(hash);
+			if (auto *journal = node_storage.template journal<depth>())
+				journal->retired(hash);
 			if constexpr (depth == update_depth)
 				if (this->nodec.hash() == hash)
 					this->nodec = {};
@@ -399,9 +415,25 @@ namespace hypertrie::internal::raw {
 				default:
 					assert(false);
 			}
+			if (auto *journal = node_storage.template journal<depth>())
+				journalUpdate<depth, reuse_node_before>(*journal, update);
 			return node_before_children_count_diff;
 		}
 
+		/**
+		 * Journals the node created by an update and, if the node before was reused, its removal.
+		 */
+		template<size_t depth, bool reuse_node_before>
+		void journalUpdate(NodeJournal &journal, const Modification_t<depth> &update) {
+			if constexpr (reuse_node_before)
+				if (update.modOp() == ModificationOperations::CHANGE_VALUE or update.modOp() == ModificationOperations::INSERT_INTO_UNCOMPRESSED_NODE)
+					journal.retired(update.hashBefore());
+			if constexpr (depth == 1 and tri_t::is_lsb_unused and tri_t::is_bool_valued)
+				if (update.hashAfter().isCompressed())
+					return;// stored in the parent's edge, there is no node
+			journal.created(update.hashAfter());
+		}
+
 		template<size_t depth>
 		void insertCompressedNode(const Modification_t<depth> &update, const size_t after_count_diff) {
 
@@ -558,12 +590,12 @@ namespace hypertrie::internal::raw {
 
 		template<size_t depth>
 		void insertBulkIntoC(Modification_t<depth> &update, const long after_count_diff) {
-			auto &storage = node_storage.template getNodeStorage<depth, NodeCompression::compressed>();
-			assert(storage.find(update.hashBefore()) != storage.end());
+			// faults the node before in if it was evicted
+			CompressedNode<depth, tri> const *const node_before = node_storage.template getCompressedNode<depth>(update.hashBefore()).compressed_node();
+			assert(node_before != nullptr);
+			[[maybe_unused]] auto &storage = node_storage.template getNodeStorage<depth, NodeCompression::compressed>();
 			assert(storage.find(update.hashAfter()) == storage.end());
 
-			CompressedNode<depth, tri> const *const node_before = storage[update.hashBefore()];
-
 			update.modOp() = ModificationOperations::NEW_UNCOMPRESSED_NODE;
 			update.addEntry(node_before->key(), node_before->value());
 			update.hashBefore() = {};
@@ -578,12 +610,13 @@ namespace hypertrie::internal::raw {
 						(not reuse_node_before and depth > 1) ? INC_COUNT_DIFF_BEFORE : 0;
 
 				// move or copy the node from old_hash to new_hash
+				// faults the node before in if it was evicted
+				UncompressedNode<depth, tri> *node = node_storage.template getUncompressedNode<depth>(update.hashBefore()).uncompressed_node();
+				assert(node != nullptr);
 				auto &storage = node_storage.template getNodeStorage<depth, NodeCompression::uncompressed>();
-				auto node_it = storage.find(update.hashBefore());
-				assert(node_it != storage.end());
-				UncompressedNode<depth, tri> *node = node_it->second;
 				if constexpr (reuse_node_before) {// node before ref_count is zero -> maybe reused
-					storage.erase(node_it);
+					storage.erase(update.hashBefore());
+					node_storage.template discardPage<depth>(update.hashBefore());
 				} else {
 					node = new UncompressedNode<depth, tri>{*node};
 					node->ref_count() = 0;
@@ -659,10 +692,7 @@ namespace hypertrie::internal::raw {
 
 							// execute changes
 							if (key_part_exists)
-								if constexpr (not (depth == 2 and tri::is_bool_valued and tri::is_lsb_unused))
-									tri::template deref<key_part_type, TensorHash>(iter) = child_update.hashAfter();
-								else
-									tri::template deref<key_part_type, TaggedTensorHash<tri>>(iter) = child_update.hashAfter();
+								tri::template deref<typename UncompressedNode<depth, tri>::ChildrenType>(iter) = child_update.hashAfter();
 							else
 								node->edges(pos)[key_part] = child_update.hashAfter();
 
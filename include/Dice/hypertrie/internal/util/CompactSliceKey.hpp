@@ -0,0 +1,125 @@
+#ifndef HYPERTRIE_COMPACTSLICEKEY_HPP
+#define HYPERTRIE_COMPACTSLICEKEY_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "Dice/hypertrie/internal/ConfigHypertrieDepthLimit.hpp"
+#include "Dice/hypertrie/internal/util/Key.hpp"
+
+namespace hypertrie {
+
+	/**
+	 * A slice key that does not allocate. Instead of a vector of optionals it stores a bitmask of the fixed positions
+	 * and the fixed key parts packed in the order of their positions.
+	 * @tparam key_part_type type of the key parts
+	 */
+	template<typename key_part_type>
+	class CompactSliceKey {
+	public:
+		using FixedPositions = std::uint32_t;
+		static_assert(hypertrie_depth_limit <= sizeof(FixedPositions) * 8);
+
+	private:
+		std::array<key_part_type, hypertrie_depth_limit> fixed_key_parts_{};
+		FixedPositions fixed_positions_ = 0;
+		pos_type depth_ = 0;
+
+		[[nodiscard]] static constexpr FixedPositions bit(pos_type pos) noexcept { return FixedPositions(1) << pos; }
+
+		/**
+		 * Index of the key part for pos in fixed_key_parts_, i.e. the number of fixed positions before pos.
+		 */
+		[[nodiscard]] constexpr size_t index(pos_type pos) const noexcept {
+			return size_t(std::popcount(FixedPositions(fixed_positions_ & (bit(pos) - 1))));
+		}
+
+	public:
+		constexpr CompactSliceKey() noexcept = default;
+
+		/**
+		 * Creates a slice key with depth positions that are all unfixed.
+		 */
+		explicit constexpr CompactSliceKey(pos_type depth) noexcept : depth_(depth) {
+			assert(depth <= hypertrie_depth_limit);
+		}
+
+		explicit CompactSliceKey(const SliceKey<key_part_type> &slice_key) noexcept : CompactSliceKey(pos_type(slice_key.size())) {
+			size_t i = 0;
+			for (pos_type pos = 0; pos < depth_; ++pos)
+				if (slice_key[pos].has_value()) {
+					fixed_positions_ |= bit(pos);
+					fixed_key_parts_[i++] = slice_key[pos].value();
+				}
+		}
+
+		/**
+		 * Fixes pos to key_part. Positions may be fixed in any order.
+		 * @return reference to self
+		 */
+		constexpr CompactSliceKey &fix(pos_type pos, key_part_type key_part) noexcept {
+			assert(pos < depth_);
+			const size_t i = index(pos);
+			if (not isFixed(pos)) {
+				for (size_t j = fixedDepth(); j > i; --j)
+					fixed_key_parts_[j] = fixed_key_parts_[j - 1];
+				fixed_positions_ |= bit(pos);
+			}
+			fixed_key_parts_[i] = key_part;
+			return *this;
+		}
+
+		[[nodiscard]] constexpr pos_type depth() const noexcept { return depth_; }
+
+		[[nodiscard]] constexpr size_t fixedDepth() const noexcept { return size_t(std::popcount(fixed_positions_)); }
+
+		/**
+		 * Bitmask of the fixed positions. Bit i is set if position i is fixed.
+		 */
+		[[nodiscard]] constexpr FixedPositions fixedPositions() const noexcept { return fixed_positions_; }
+
+		[[nodiscard]] constexpr bool isFixed(pos_type pos) const noexcept { return fixed_positions_ & bit(pos); }
+
+		/**
+		 * The fixed key parts ordered by their positions. If all positions are fixed, this is the key.
+		 */
+		[[nodiscard]] std::span<const key_part_type> fixedKeyParts() const noexcept {
+			return {fixed_key_parts_.data(), fixedDepth()};
+		}
+
+		[[nodiscard]] constexpr std::optional<key_part_type> operator[](pos_type pos) const noexcept {
+			if (isFixed(pos))
+				return fixed_key_parts_[index(pos)];
+			return std::nullopt;
+		}
+
+		/**
+		 * Calls f(pos, key_part) for each fixed position in ascending order.
+		 */
+		template<typename F>
+		constexpr void forEachFixed(F &&f) const {
+			size_t i = 0;
+			for (FixedPositions remaining = fixed_positions_; remaining != 0; remaining &= remaining - 1)
+				f(pos_type(std::countr_zero(remaining)), fixed_key_parts_[i++]);
+		}
+
+		[[nodiscard]] SliceKey<key_part_type> sliceKey() const {
+			SliceKey<key_part_type> slice_key(depth_);
+			forEachFixed([&](pos_type pos, key_part_type key_part) { slice_key[pos] = key_part; });
+			return slice_key;
+		}
+
+		[[nodiscard]] constexpr bool operator==(const CompactSliceKey &other) const noexcept {
+			return depth_ == other.depth_ and fixed_positions_ == other.fixed_positions_ and
+				   std::equal(fixed_key_parts_.begin(), fixed_key_parts_.begin() + fixedDepth(), other.fixed_key_parts_.begin());
+		}
+	};
+
+}// namespace hypertrie
+
+#endif//HYPERTRIE_COMPACTSLICEKEY_HPP
@@ -0,0 +1,208 @@
+#ifndef HYPERTRIE_NUMA_HPP
+#define HYPERTRIE_NUMA_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <Dice/hash/DiceHash.hpp>
+
+namespace hypertrie::internal::util {
+
+	/**
+	 * Where the nodes of a NodeStorage that are created by bulk loads are allocated on a machine with several NUMA nodes.
+	 * Nodes created by setting single entries are allocated as with first_touch.
+	 */
+	enum struct NumaPlacement {
+		/**
+		 * The operating system places memory on the NUMA node of the thread that touches it first.
+		 */
+		first_touch,
+		/**
+		 * Memory of nodes is interleaved page-wise over all NUMA nodes.
+		 */
+		interleaved,
+		/**
+		 * Memory of the nodes created by setting a key is allocated on the NUMA node of the key's first key part
+		 * (see NumaTopology::nodeOf()). Nodes that are shared by several keys stay where they were created first.
+		 */
+		partitioned
+	};
+
+	/**
+	 * The NUMA nodes of the machine and their CPUs, read from /sys/devices/system/node. A machine without NUMA
+	 * information is a single node with all CPUs.
+	 */
+	class NumaTopology {
+		struct NumaNode {
+			unsigned long id;
+			std::vector<unsigned> cpus;
+		};
+
+		std::vector<NumaNode> nodes_;
+
+		/**
+		 * Parses a kernel list like "0-3,8,10-11".
+		 */
+		static std::vector<unsigned> parseList(const std::string &list) {
+			std::vector<unsigned> values;
+			size_t begin = 0;
+			while (begin < list.size()) {
+				size_t end = list.find(',', begin);
+				if (end == std::string::npos)
+					end = list.size();
+				const std::string item = list.substr(begin, end - begin);
+				if (const size_t dash = item.find('-'); dash != std::string::npos) {
+					for (unsigned value = std::stoul(item.substr(0, dash)); value <= std::stoul(item.substr(dash + 1)); ++value)
+						values.push_back(value);
+				} else if (not item.empty() and item != "\n") {
+					values.push_back(std::stoul(item));
+				}
+				begin = end + 1;
+			}
+			return values;
+		}
+
+		static std::string readLine(const std::filesystem::path &path) {
+			std::ifstream file{path};
+			std::string line;
+			std::getline(file, line);
+			return line;
+		}
+
+		NumaTopology() {
+			const std::filesystem::path sysfs{"/sys/devices/system/node"};
+			try {
+				for (unsigned id : parseList(readLine(sysfs / "online"))) {
+					auto cpus = parseList(readLine(sysfs / ("node" + std::to_string(id)) / "cpulist"));
+					if (not cpus.empty())// memory-only nodes run no threads
+						nodes_.push_back({id, std::move(cpus)});
+				}
+			} catch (const std::exception &) {
+				nodes_.clear();
+			}
+			if (nodes_.empty()) {
+				std::vector<unsigned> cpus(std::max(1U, std::thread::hardware_concurrency()));
+				for (unsigned cpu = 0; cpu < cpus.size(); ++cpu)
+					cpus[cpu] = cpu;
+				nodes_.push_back({0, std::move(cpus)});
+			}
+		}
+
+	public:
+		static const NumaTopology &instance() {
+			static const NumaTopology topology{};
+			return topology;
+		}
+
+		/**
+		 * @return number of NUMA nodes with CPUs. NUMA nodes are referred to by their index in [0, nodes()).
+		 */
+		[[nodiscard]] size_t nodes() const noexcept { return nodes_.size(); }
+
+		/**
+		 * @return the id of the NUMA node used by the operating system
+		 */
+		[[nodiscard]] unsigned long id(size_t node) const noexcept { return nodes_[node].id; }
+
+		[[nodiscard]] const std::vector<unsigned> &cpus(size_t node) const noexcept { return nodes_[node].cpus; }
+
+		/**
+		 * @return the NUMA node that owns the nodes of a key part with NumaPlacement::partitioned
+		 */
+		template<typename key_part_type>
+		[[nodiscard]] size_t nodeOf(const key_part_type &key_part) const noexcept {
+			if (nodes_.size() == 1)
+				return 0;
+			return Dice::hash::dice_hash(key_part) % nodes_.size();
+		}
+	};
+
+	/**
+	 * Restricts the calling thread to the CPUs of a NUMA node.
+	 * @return false if the affinity could not be set
+	 */
+	inline bool pinThreadToNumaNode(size_t node) {
+		cpu_set_t cpu_set;
+		CPU_ZERO(&cpu_set);
+		for (unsigned cpu : NumaTopology::instance().cpus(node))
+			if (cpu < CPU_SETSIZE)
+				CPU_SET(cpu, &cpu_set);
+		return ::sched_setaffinity(0, sizeof(cpu_set), &cpu_set) == 0;
+	}
+
+	/**
+	 * Sets the memory policy of the calling thread for its lifetime and restores the previous policy afterwards.
+	 * It is a no-op with NumaPlacement::first_touch and on machines with a single NUMA node. Failing system calls are
+	 * ignored, the placement is only a hint.
+	 *
+	 * The placement is best-effort: the kernel applies the policy to pages that are faulted in while it is active. Memory
+	 * that the allocator reuses from pages it mapped before, e.g. freed nodes, stays on its NUMA node.
+	 */
+	class ScopedMemoryPolicy {
+		static constexpr const size_t max_numa_nodes = 1024;
+		using NodeMask = std::array<unsigned long, max_numa_nodes / (8 * sizeof(unsigned long))>;
+
+		bool active_ = false;
+		int previous_mode_ = MPOL_DEFAULT;
+		NodeMask previous_mask_{};
+
+		static long setPolicy(int mode, const NodeMask *mask) noexcept {
+			// the kernel reads maxnode - 1 bits
+			return ::syscall(SYS_set_mempolicy, mode, (mask != nullptr) ? mask->data() : nullptr, (mask != nullptr) ? max_numa_nodes + 1 : 0);
+		}
+
+		static void addNode(NodeMask &mask, unsigned long id) noexcept {
+			if (id < max_numa_nodes)
+				mask[id / (8 * sizeof(unsigned long))] |= 1UL << (id % (8 * sizeof(unsigned long)));
+		}
+
+	public:
+		/**
+		 * @param placement the placement policy
+		 * @param node the NUMA node to allocate on with NumaPlacement::partitioned
+		 */
+		ScopedMemoryPolicy(NumaPlacement placement, size_t node = 0) noexcept {
+			const auto &topology = NumaTopology::instance();
+			if (placement == NumaPlacement::first_touch or topology.nodes() == 1)
+				return;
+			if (::syscall(SYS_get_mempolicy, &previous_mode_, previous_mask_.data(), max_numa_nodes + 1, nullptr, 0) != 0)
+				return;
+			NodeMask mask{};
+			if (placement == NumaPlacement::interleaved) {
+				for (size_t i = 0; i < topology.nodes(); ++i)
+					addNode(mask, topology.id(i));
+				active_ = setPolicy(MPOL_INTERLEAVE, &mask) == 0;
+			} else {
+				addNode(mask, topology.id(node));
+				active_ = setPolicy(MPOL_PREFERRED, &mask) == 0;
+			}
+		}
+
+		ScopedMemoryPolicy(const ScopedMemoryPolicy &) = delete;
+		ScopedMemoryPolicy &operator=(const ScopedMemoryPolicy &) = delete;
+
+		~ScopedMemoryPolicy() {
+			if (active_)
+				setPolicy(previous_mode_, (previous_mode_ == MPOL_DEFAULT) ? nullptr : &previous_mask_);
+		}
+
+		/**
+		 * @return true if the policy was changed
+		 */
+		[[nodiscard]] bool active() const noexcept { return active_; }
+	};
+
+}// namespace hypertrie::internal::util
+
+#endif//HYPERTRIE_NUMA_HPP
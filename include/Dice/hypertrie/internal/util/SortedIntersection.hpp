@@ -0,0 +1,129 @@
+#ifndef HYPERTRIE_SORTEDINTERSECTION_HPP
+#define HYPERTRIE_SORTEDINTERSECTION_HPP
+
+#include <bit>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace hypertrie::internal::util::sorted_intersection {
+
+	/**
+	 * Ratio of the sizes of two sorted ranges above which galloping through the larger range beats merging.
+	 */
+	constexpr static const size_t gallop_ratio = 32;
+
+	/**
+	 * Exponential search for the first element in [first, last) that is not less than value.
+	 */
+	template<typename T>
+	const T *gallop(const T *first, const T *last, const T &value) noexcept {
+		size_t step = 1;
+		const T *low = first;
+		const T *high = first;
+		while (high < last and *high < value) {
+			low = high + 1;
+			high = (size_t(last - high) > step) ? high + step : last;
+			step *= 2;
+		}
+		// binary search in [low, high)
+		while (low < high) {
+			const T *mid = low + (high - low) / 2;
+			if (*mid < value)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+		return low;
+	}
+
+	/**
+	 * Writes the elements of small that are contained in large to out. Every element of small is looked up in large by galloping.
+	 * @return number of elements written
+	 */
+	template<typename T>
+	size_t intersect_gallop(std::span<const T> small, std::span<const T> large, T *out) noexcept {
+		size_t written = 0;
+		const T *large_pos = large.data();
+		const T *const large_end = large.data() + large.size();
+		for (const T &value : small) {
+			large_pos = gallop(large_pos, large_end, value);
+			if (large_pos == large_end)
+				break;
+			if (*large_pos == value)
+				out[written++] = value;
+		}
+		return written;
+	}
+
+	/**
+	 * Writes the elements contained in both a and b to out by merging them.
+	 * With AVX2, blocks of four 64-bit elements of both ranges are compared all-against-all at once. The AVX2 kernel is
+	 * only compiled if the build enables it, e.g. with -mavx2 (for the tests: -Dhypertrie_ENABLE_AVX2=ON).
+	 * @return number of elements written
+	 */
+	template<typename T>
+	size_t intersect_merge(std::span<const T> a, std::span<const T> b, T *out) noexcept {
+		size_t written = 0;
+		size_t i = 0;
+		size_t j = 0;
+#if defined(__AVX2__)
+		if constexpr (std::is_integral_v<T> and sizeof(T) == 8) {
+			constexpr const size_t block = 4;
+			while (i + block <= a.size() and j + block <= b.size()) {
+				const __m256i a_block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a.data() + i));
+				__m256i b_block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b.data() + j));
+				__m256i matches = _mm256_cmpeq_epi64(a_block, b_block);
+				for (size_t rotation = 1; rotation < block; ++rotation) {
+					b_block = _mm256_permute4x64_epi64(b_block, _MM_SHUFFLE(0, 3, 2, 1));
+					matches = _mm256_or_si256(matches, _mm256_cmpeq_epi64(a_block, b_block));
+				}
+				const T a_max = a[i + block - 1];
+				const T b_max = b[j + block - 1];
+				// the matching elements of the a block, in order
+				for (auto mask = unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(matches))); mask != 0; mask &= mask - 1)
+					out[written++] = a[i + size_t(std::countr_zero(mask))];
+				if (a_max <= b_max)
+					i += block;
+				if (b_max <= a_max)
+					j += block;
+			}
+		}
+#endif
+		while (i < a.size() and j < b.size()) {
+			if (a[i] < b[j])
+				++i;
+			else if (b[j] < a[i])
+				++j;
+			else {
+				out[written++] = a[i];
+				++i;
+				++j;
+			}
+		}
+		return written;
+	}
+
+	/**
+	 * Writes the elements contained in both a and b to out. a and b must be sorted and free of duplicates.
+	 * out may point to the data of a or b, the result is written in ascending order and never ahead of the read position.
+	 * @return number of elements written
+	 */
+	template<typename T>
+	size_t intersect(std::span<const T> a, std::span<const T> b, T *out) noexcept {
+		if (a.size() > b.size())
+			std::swap(a, b);
+		if (a.size() * gallop_ratio < b.size())
+			return intersect_gallop(a, b, out);
+		else
+			return intersect_merge(a, b, out);
+	}
+
+}// namespace hypertrie::internal::util::sorted_intersection
+
+#endif//HYPERTRIE_SORTEDINTERSECTION_HPP
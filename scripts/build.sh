@@ -10,6 +10,7 @@ mkdir -p build
 cd build
 ~/.local/bin/conan install .. --build=missing
 #cmake -Dhypertrie_BUILD_TESTS=ON -Dhypertrie_LIBTORCH_PATH=../libtorch -DCMAKE_BUILD_TYPE=Debug ..
-cmake -Dhypertrie_BUILD_TESTS=ON -Dhypertrie_LIBTORCH_PATH=../libtorch -DCMAKE_BUILD_TYPE=Release ..
+# additional arguments are passed on to cmake, e.g. -Dhypertrie_SANITIZER=thread
+cmake -Dhypertrie_BUILD_TESTS=ON -Dhypertrie_LIBTORCH_PATH=../libtorch -DCMAKE_BUILD_TYPE=Release "$@" ..
 make
 
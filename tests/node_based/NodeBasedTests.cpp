@@ -14,5 +14,24 @@
 #include "TestNodeContextRandomized.hpp"
 #include "TestTaggedNodeHash.hpp"
 #include "TestSlicing.hpp"
+#include "TestSetOperations.hpp"
+#include "TestDiff.hpp"
+#include "TestParallelIteration.hpp"
+#include "TestStaticHypertrie.hpp"
+#include "TestCompactSliceKey.hpp"
+#include "TestSliceCache.hpp"
+#include "TestOrderedIterator.hpp"
+#include "TestRoaringBitmapSet.hpp"
+#include "TestSortedIntersection.hpp"
+#include "TestSwissTable.hpp"
+#include "TestWriteAheadLog.hpp"
+#include "TestCheckpoint.hpp"
+#include "TestNodePaging.hpp"
+#include "TestNuma.hpp"
+#include "TestShardedHypertrie.hpp"
+#include "TestAsyncEinsum.hpp"
+#include "TestHashJoin.hpp"
+#include "TestGenericJoin.hpp"
+#include "TestStaticEinsum.hpp"
 
 #endif//NODEBASED_HYPERTRIE_TESTS_H
@@ -0,0 +1,117 @@
+#ifndef HYPERTRIE_TESTASYNCEINSUM_HPP
+#define HYPERTRIE_TESTASYNCEINSUM_HPP
+
+#include <atomic>
+#include <coroutine>
+
+#include <Dice/hypertrie/hypertrie.hpp>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+
+
+namespace hypertrie::tests::async_einsum {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+
+	using tr = default_bool_Hypertrie_t;
+
+	template<typename value_type>
+	using Results = decltype(einsum2map<value_type, tr>({}, {}));
+
+	template<typename value_type>
+	Results<value_type> collect(AsyncGenerator<std::vector<EinsumEntry<value_type, tr>>> generator, size_t batch_size) {
+		Results<value_type> results;
+		size_t count = 0;
+		while (auto batch = generator.waitNext()) {
+			REQUIRE(not batch->empty());
+			REQUIRE(batch->size() <= batch_size);
+			for (const auto &entry : *batch) {
+				results[entry.key] += entry.value;
+				++count;
+			}
+		}
+		if constexpr (std::is_same_v<value_type, bool>)
+			REQUIRE(count == results.size());
+		return results;
+	}
+
+	template<typename value_type>
+	void test_async_einsum(const std::string &subscript_string, const Hypertrie<tr> &hypertrie, Executor &executor) {
+		SECTION("{} {}"_format(subscript_string, (std::is_same_v<value_type, bool>) ? "bool" : "size_t")) {
+			auto subscript = std::make_shared<Subscript>(subscript_string);
+			std::vector<const_Hypertrie<tr>> operands(subscript->getRawSubscript().operands.size(), hypertrie);
+			const auto expected = einsum2map<value_type, tr>(subscript, operands);
+
+			// without executor the query does not yield
+			REQUIRE(collect<value_type>(asyncEinsum<value_type, tr>(subscript, operands, {nullptr, 7}), 7) == expected);
+			// yielding in every loop iteration resumes every operator at every yield point
+			for (size_t yield_interval : {1, 3, 100})
+				REQUIRE(collect<value_type>(asyncEinsum<value_type, tr>(subscript, operands, {&executor, 5, yield_interval}), 5) == expected);
+		}
+	}
+
+	TEST_CASE("einsum results are generated asynchronously in batches", "[AsyncEinsum]") {
+		utils::EntryGenerator<unsigned long, bool, false> gen{1, 8};
+		HypertrieContext<tr> context;
+		Hypertrie<tr> hypertrie{3, context};
+		for (const auto &key : gen.keys(150, 3))
+			hypertrie.set(key, true);
+		Executor executor{2};
+
+		// projection, joins, cycle and cartesian products
+		for (const auto &subscript : {"abc->a", "abc->", "abc,ade->bcde", "abc,cde->ae", "abc,cde,efa->ace", "abc,def->af", "abc,def->", "abc,cde,fgh->aefh"}) {
+			test_async_einsum<size_t>(subscript, hypertrie, executor);
+			test_async_einsum<bool>(subscript, hypertrie, executor);
+		}
+	}
+
+	struct DetachedTask {
+		struct promise_type {
+			DetachedTask get_return_object() noexcept { return {}; }
+			std::suspend_never initial_suspend() const noexcept { return {}; }
+			std::suspend_never final_suspend() const noexcept { return {}; }
+			void return_void() const noexcept {}
+			void unhandled_exception() const noexcept { std::terminate(); }
+		};
+	};
+
+	DetachedTask countQuery(Executor &executor, std::shared_ptr<Subscript> subscript, std::vector<const_Hypertrie<tr>> operands,
+							std::atomic<size_t> &entries, std::atomic<size_t> &finished) {
+		co_await executor.schedule();
+		auto generator = asyncEinsum<size_t, tr>(subscript, operands, {&executor, 16, 8});
+		while (auto batch = co_await generator.next())
+			for (const auto &entry : *batch)
+				entries += entry.value;
+		++finished;
+	}
+
+	TEST_CASE("many queries are multiplexed on few threads", "[AsyncEinsum]") {
+		utils::EntryGenerator<unsigned long, bool, false> gen{1, 8};
+		HypertrieContext<tr> context;
+		Hypertrie<tr> hypertrie{3, context};
+		for (const auto &key : gen.keys(150, 3))
+			hypertrie.set(key, true);
+		auto subscript = std::make_shared<Subscript>("abc,cde->ae");
+		std::vector<const_Hypertrie<tr>> operands{hypertrie, hypertrie};
+		size_t expected = 0;
+		for (const auto &[key, value] : einsum2map<size_t, tr>(subscript, operands))
+			expected += value;
+
+		constexpr size_t queries = 200;
+		std::atomic<size_t> entries = 0;
+		std::atomic<size_t> finished = 0;
+		{
+			Executor executor{2};
+			for (size_t i = 0; i < queries; ++i)
+				countQuery(executor, subscript, operands, entries, finished);
+			while (finished < queries)
+				std::this_thread::yield();
+		}
+		REQUIRE(entries == queries * expected);
+	}
+
+};// namespace hypertrie::tests::async_einsum
+
+#endif//HYPERTRIE_TESTASYNCEINSUM_HPP
@@ -0,0 +1,177 @@
+#ifndef HYPERTRIE_TESTCHECKPOINT_HPP
+#define HYPERTRIE_TESTCHECKPOINT_HPP
+
+#include <filesystem>
+#include <fstream>
+#include <optional>
+
+#include <Dice/hypertrie/internal/Checkpoint.hpp>
+#include <Dice/hypertrie/internal/Hypertrie.hpp>
+#include <Dice/hypertrie/internal/HypertrieContext.hpp>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+#include "../utils/TemporaryFile.hpp"
+
+
+namespace hypertrie::tests::checkpoint {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+
+	template<HypertrieTrait tr>
+	void require_equal(const const_Hypertrie<tr> &actual, const const_Hypertrie<tr> &expected) {
+		REQUIRE(actual.depth() == expected.depth());
+		REQUIRE(actual.size() == expected.size());
+		REQUIRE(actual.hash() == expected.hash());
+	}
+
+	template<HypertrieTrait tr, size_t depth>
+	void test_checkpoint_chain() {
+		using key_part_type = typename tr::key_part_type;
+		using value_type = typename tr::value_type;
+		using Key = typename tr::Key;
+		SECTION("depth {}"_format(depth)) {
+			TemporaryFile full{"full", "ckpt"};
+			TemporaryFile incremental{"incremental", "ckpt"};
+			TemporaryFile incremental2{"incremental2", "ckpt"};
+			utils::RawGenerator<depth, key_part_type, value_type, size_t(tr::lsb_unused)> gen{1, 30, value_type(1), value_type(5)};
+			auto set_random = [&](Hypertrie<tr> &hypertrie, size_t count) {
+				for (size_t i = 0; i < count; ++i) {
+					auto raw_key = gen.key();
+					hypertrie.set(Key{raw_key.begin(), raw_key.end()}, gen.value());
+				}
+			};
+
+			HypertrieContext<tr> context;
+			Hypertrie<tr> hypertrie{depth, context};
+			std::optional<Hypertrie<tr>> other{std::in_place, depth, context};
+			Hypertrie<tr> single{depth, context};
+			Hypertrie<tr> empty{depth, context};
+			set_random(hypertrie, 2'000);
+			set_random(*other, 50);
+			set_random(single, 1);
+			REQUIRE(not HypertrieCheckpoint<tr>::write(context, {hypertrie, *other, single, empty}, full.path));
+
+			set_random(hypertrie, 20);
+			auto snapshot = hypertrie.snapshot();
+			set_random(hypertrie, 20);
+			REQUIRE(HypertrieCheckpoint<tr>::write(context, {hypertrie, *other, single, empty, snapshot}, incremental.path));
+			if constexpr (depth > 1)// a depth 1 hypertrie is a single node that is rewritten on every change
+				REQUIRE(std::filesystem::file_size(incremental.path) < std::filesystem::file_size(full.path));
+
+			// other is dropped, its nodes are retired
+			other.reset();
+			set_random(single, 1);
+			REQUIRE(HypertrieCheckpoint<tr>::write(context, {hypertrie, single, snapshot}, incremental2.path));
+
+			{
+				HypertrieContext<tr> restored_context;
+				auto restored = HypertrieCheckpoint<tr>::restore(restored_context, {full.path, incremental.path});
+				REQUIRE(restored.size() == 5);
+				REQUIRE(restored[3].size() == 0);
+				require_equal<tr>(restored[4], snapshot);
+			}
+
+			HypertrieContext<tr> restored_context;
+			auto restored = HypertrieCheckpoint<tr>::restore(restored_context, {full.path, incremental.path, incremental2.path});
+			REQUIRE(restored.size() == 3);
+			require_equal<tr>(restored[0], hypertrie);
+			require_equal<tr>(restored[1], single);
+			require_equal<tr>(restored[2], snapshot);
+
+			// the restored context can be modified and checkpointed incrementally
+			auto raw_key = gen.key();
+			restored[0].set(Key{raw_key.begin(), raw_key.end()}, value_type(7));
+			hypertrie.set(Key{raw_key.begin(), raw_key.end()}, value_type(7));
+			require_equal<tr>(restored[0], hypertrie);
+			REQUIRE(HypertrieCheckpoint<tr>::write(restored_context, {restored[0]}, incremental.path));
+		}
+	}
+
+	TEMPLATE_TEST_CASE("restoring a chain of incremental checkpoints", "[Checkpoint]", default_bool_Hypertrie_t, lsbunused_bool_Hypertrie_t, default_long_Hypertrie_t) {
+		test_checkpoint_chain<TestType, 1>();
+		test_checkpoint_chain<TestType, 2>();
+		test_checkpoint_chain<TestType, 3>();
+	}
+
+	TEST_CASE("references of the slice cache are not checkpointed", "[Checkpoint]") {
+		using tr = default_bool_Hypertrie_t;
+		using namespace hypertrie::internal::raw;
+		TemporaryFile full{"slice_cache", "ckpt"};
+
+		HypertrieContext<tr> context{10};
+		Hypertrie<tr> hypertrie{2, context};
+		for (unsigned long i = 1; i <= 5; ++i) {
+			hypertrie.set({i, i}, true);
+			hypertrie.set({i, i + 100}, true);
+		}
+		// the cache holds references on the hypertrie and on its rows
+		for (unsigned long i = 1; i <= 5; ++i)
+			REQUIRE(std::get<0>(hypertrie[typename tr::SliceKey{i, std::nullopt}]).size() == 2);
+		REQUIRE(context.sliceCache()->size() == 5);
+		HypertrieCheckpoint<tr>::write(context, {hypertrie}, full.path);
+		REQUIRE(context.sliceCache()->size() == 0);
+
+		HypertrieContext<tr> restored_context;
+		auto &storage = restored_context.rawContext().storage;
+		{
+			auto restored = HypertrieCheckpoint<tr>::restore(restored_context, {full.path});
+			require_equal<tr>(restored[0], hypertrie);
+			REQUIRE(storage.template getNodeStorage<1, NodeCompression::uncompressed>().size() == 5);
+		}
+		// no node outlives the restored hypertrie
+		REQUIRE(storage.template getNodeStorage<2, NodeCompression::uncompressed>().size() == 0);
+		REQUIRE(storage.template getNodeStorage<1, NodeCompression::uncompressed>().size() == 0);
+	}
+
+	TEST_CASE("invalid checkpoint chains are rejected", "[Checkpoint]") {
+		using tr = default_bool_Hypertrie_t;
+		TemporaryFile full{"invalid_full", "ckpt"};
+		TemporaryFile incremental{"invalid_incremental", "ckpt"};
+
+		HypertrieContext<tr> context;
+		Hypertrie<tr> hypertrie{2, context};
+		hypertrie.set({1, 2}, true);
+		hypertrie.set({1, 3}, true);
+		HypertrieCheckpoint<tr>::write(context, {hypertrie}, full.path);
+		hypertrie.set({4, 5}, true);
+		HypertrieCheckpoint<tr>::write(context, {hypertrie}, incremental.path);
+
+		{
+			HypertrieContext<tr> restored_context;
+			REQUIRE_THROWS_AS(HypertrieCheckpoint<tr>::restore(restored_context, {incremental.path}), std::invalid_argument);
+		}
+		{
+			HypertrieContext<tr> restored_context;
+			REQUIRE_THROWS_AS(HypertrieCheckpoint<tr>::restore(restored_context, {full.path, full.path}), std::invalid_argument);
+		}
+		{
+			HypertrieContext<tr> other_context;
+			Hypertrie<tr> foreign{2, other_context};
+			REQUIRE_THROWS_AS(HypertrieCheckpoint<tr>::write(context, {foreign}, incremental.path), std::invalid_argument);
+		}
+
+		// corrupt the ref_count of the first node, it follows the header (16 bytes), the numbers of retired and created
+		// nodes at depth 1 and the hash of the node
+		const auto corrupt = [](const std::filesystem::path &path) {
+			std::fstream file{path, std::ios::in | std::ios::out | std::ios::binary};
+			file.seekp(41);
+			file.put(char(0x7f));
+		};
+		{
+			// a corrupted incremental layer is rejected before the full layer changed the context
+			corrupt(incremental.path);
+			HypertrieContext<tr> restored_context;
+			REQUIRE_THROWS_AS(HypertrieCheckpoint<tr>::restore(restored_context, {full.path, incremental.path}), std::runtime_error);
+			auto restored = HypertrieCheckpoint<tr>::restore(restored_context, {full.path});
+			REQUIRE(restored[0].size() == 2);
+		}
+		corrupt(full.path);
+		HypertrieContext<tr> restored_context;
+		REQUIRE_THROWS_AS(HypertrieCheckpoint<tr>::restore(restored_context, {full.path}), std::runtime_error);
+	}
+
+};// namespace hypertrie::tests::checkpoint
+
+#endif//HYPERTRIE_TESTCHECKPOINT_HPP
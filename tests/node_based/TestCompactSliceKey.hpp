@@ -0,0 +1,99 @@
+#ifndef HYPERTRIE_TESTCOMPACTSLICEKEY_HPP
+#define HYPERTRIE_TESTCOMPACTSLICEKEY_HPP
+
+#include <array>
+
+#include <Dice/hypertrie/internal/Hypertrie.hpp>
+#include <Dice/hypertrie/internal/HypertrieContext.hpp>
+#include <Dice/hypertrie/internal/util/CompactSliceKey.hpp>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+
+
+namespace hypertrie::tests::compact_slice_key {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+
+	TEST_CASE("fix positions in any order", "[CompactSliceKey]") {
+		CompactSliceKey<unsigned long> slice_key{4};
+		REQUIRE(slice_key.fixedDepth() == 0);
+		slice_key.fix(3, 30).fix(0, 5).fix(2, 20);
+		REQUIRE(slice_key.fixedDepth() == 3);
+		REQUIRE(slice_key.fixedPositions() == 0b1101);
+		REQUIRE(not slice_key[1].has_value());
+		REQUIRE(slice_key[2] == 20ul);
+		auto fixed_key_parts = slice_key.fixedKeyParts();
+		REQUIRE(std::vector<unsigned long>(fixed_key_parts.begin(), fixed_key_parts.end()) == std::vector<unsigned long>{5, 20, 30});
+
+		// refixing a position replaces its key part
+		slice_key.fix(2, 21);
+		REQUIRE(slice_key.fixedDepth() == 3);
+		REQUIRE(slice_key[2] == 21ul);
+
+		const SliceKey<unsigned long> expected{5, std::nullopt, 21, 30};
+		REQUIRE(slice_key.sliceKey() == expected);
+		REQUIRE(CompactSliceKey<unsigned long>{expected} == slice_key);
+	}
+
+	template<HypertrieTrait tr, size_t depth>
+	void test_allocation_free_keys() {
+		using key_part_type = typename tr::key_part_type;
+		using value_type = typename tr::value_type;
+		using Key = typename tr::Key;
+
+		SECTION("depth {}"_format(depth)) {
+			utils::EntryGenerator<key_part_type, value_type, tr::lsb_unused> gen{1, 15};
+			auto keys = gen.keys((depth == 1) ? 5 : 100, depth);
+
+			HypertrieContext<tr> context;
+			Hypertrie<tr> t{depth, context};
+			Hypertrie<tr> expected{depth, context};
+			for (const auto &key : keys) {
+				std::array<key_part_type, depth> array_key;
+				std::copy(key.begin(), key.end(), array_key.begin());
+				t.set(array_key, true);
+				expected.set(key, true);
+				REQUIRE(t[array_key]);
+			}
+			REQUIRE(t == expected);
+
+			for (const auto &key : keys) {
+				// every combination of fixed positions
+				for (size_t mask = 0; mask < (size_t(1) << depth); ++mask) {
+					typename tr::SliceKey slice_key(depth);
+					CompactSliceKey<key_part_type> compact_slice_key{depth};
+					for (pos_type pos = 0; pos < depth; ++pos)
+						if (mask & (size_t(1) << pos)) {
+							slice_key[pos] = key[pos];
+							compact_slice_key.fix(pos, key[pos]);
+						}
+					REQUIRE(compact_slice_key.fixedDepth() == internal::raw::Hypertrie_internal_t<tr>::sliceKeyFixedDepth(slice_key));
+					REQUIRE(expected[slice_key] == t[compact_slice_key]);
+				}
+			}
+
+			if constexpr (depth > 1) {
+				const Key &first_key = *keys.begin();
+				std::array<pos_type, 1> diagonal_positions{0};
+				HashDiagonal<tr> from_vector{expected, typename tr::KeyPositions{0}};
+				HashDiagonal<tr> from_array{t, diagonal_positions};
+				REQUIRE(from_vector.size() == from_array.size());
+				REQUIRE(from_array.find(first_key[0]));
+				REQUIRE(from_vector.find(first_key[0]));
+				REQUIRE(from_array.currentHypertrie() == from_vector.currentHypertrie());
+			}
+		}
+	}
+
+	TEMPLATE_TEST_CASE("allocation-free keys and slice keys", "[CompactSliceKey]", lsbunused_bool_Hypertrie_t, default_bool_Hypertrie_t) {
+		test_allocation_free_keys<TestType, 1>();
+		test_allocation_free_keys<TestType, 2>();
+		test_allocation_free_keys<TestType, 3>();
+		test_allocation_free_keys<TestType, 4>();
+	}
+
+};// namespace hypertrie::tests::compact_slice_key
+
+#endif//HYPERTRIE_TESTCOMPACTSLICEKEY_HPP
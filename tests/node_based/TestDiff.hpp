@@ -0,0 +1,105 @@
+#ifndef HYPERTRIE_TESTDIFF_HPP
+#define HYPERTRIE_TESTDIFF_HPP
+
+#include <algorithm>
+
+#include <Dice/hypertrie/internal/Diff.hpp>
+#include <Dice/hypertrie/internal/Hypertrie.hpp>
+#include <Dice/hypertrie/internal/HypertrieContext.hpp>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+
+
+namespace hypertrie::tests::hypertrie_diff {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+
+	template<HypertrieTrait tr, size_t depth>
+	void test_diff() {
+		using key_part_type = typename tr::key_part_type;
+		using value_type = typename tr::value_type;
+		using Key = typename tr::Key;
+
+		SECTION("depth {}"_format(depth)) {
+			utils::EntryGenerator<key_part_type, value_type, tr::lsb_unused> gen{1, 100};
+			auto keys = gen.keys(80, depth);
+			std::set<Key> added_keys;
+			while (added_keys.size() < 10)
+				if (auto key = gen.key(depth); not keys.count(key))
+					added_keys.insert(key);
+
+			HypertrieContext<tr> context;
+			Hypertrie<tr> yesterday{depth, context};
+			for (const auto &key : keys)
+				yesterday.set(key, true);
+			Hypertrie<tr> today{yesterday};
+			for (const auto &key : added_keys)
+				today.set(key, true);
+
+			REQUIRE(diff<tr>(yesterday, yesterday).empty());
+
+			std::set<Key> actual_added;
+			for (const auto &entry : diff<tr>(yesterday, today)) {
+				REQUIRE(entry.added);
+				REQUIRE(entry.value);
+				actual_added.insert(entry.key);
+			}
+			REQUIRE(actual_added == added_keys);
+			const auto collected = diff<tr>(yesterday, today).collect();
+			REQUIRE(collected.size() == added_keys.size());
+			REQUIRE(std::all_of(collected.begin(), collected.end(), [&](const auto &entry) { return added_keys.count(entry.key); }));
+
+			std::set<Key> actual_removed;
+			for (const auto &entry : diff<tr>(today, yesterday)) {
+				REQUIRE(not entry.added);
+				actual_removed.insert(entry.key);
+			}
+			REQUIRE(actual_removed == actual_added);
+
+			// the Diff keeps the versions it was created from, also if their nodes are released by later modifications
+			{
+				Hypertrie<tr> changing{depth, context};
+				for (const auto &key : added_keys)
+					changing.set(key, true);
+				const auto pending = diff<tr>(changing, yesterday);
+				for (const auto &key : added_keys)
+					changing.set(key, false);
+				REQUIRE(changing.size() == 0);
+				std::set<Key> pending_removed;
+				std::set<Key> pending_added;
+				for (const auto &entry : pending)
+					((entry.added) ? pending_added : pending_removed).insert(entry.key);
+				REQUIRE(pending_removed == added_keys);
+				REQUIRE(pending_added == keys);
+			}
+
+			// entries on both sides
+			Hypertrie<tr> other{depth, context};
+			for (const auto &key : added_keys)
+				other.set(key, true);
+			other.set(*keys.begin(), true);
+			size_t added = 0;
+			size_t removed = 0;
+			for (const auto &entry : diff<tr>(yesterday, other)) {
+				REQUIRE(yesterday[entry.key] != entry.added);
+				REQUIRE(other[entry.key] == entry.added);
+				(entry.added) ? ++added : ++removed;
+			}
+			REQUIRE(added == added_keys.size());
+			REQUIRE(removed == keys.size() - 1);
+		}
+	}
+
+	TEMPLATE_TEST_CASE("test_diff", "[Diff]", lsbunused_bool_Hypertrie_t, default_bool_Hypertrie_t) {
+		using tr = TestType;
+		test_diff<tr, 1>();
+		test_diff<tr, 2>();
+		test_diff<tr, 3>();
+		test_diff<tr, 4>();
+	}
+
+};// namespace hypertrie::tests::hypertrie_diff
+
+#endif//HYPERTRIE_TESTDIFF_HPP
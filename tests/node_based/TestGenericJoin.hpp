@@ -0,0 +1,76 @@
+#ifndef HYPERTRIE_TESTGENERICJOIN_HPP
+#define HYPERTRIE_TESTGENERICJOIN_HPP
+
+#include <Dice/hypertrie/hypertrie.hpp>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+
+
+namespace hypertrie::tests::generic_join {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+
+	using tr = default_bool_Hypertrie_t;
+
+	TEST_CASE("cyclic subscripts are detected", "[GenericJoin]") {
+		for (const auto &subscript : {"ab,bc,ca->", "ab,bc,cd,da->abcd", "abc,cde,efa->ace", "abx,bcy,caz->"})
+			REQUIRE(Subscript{subscript}.isCyclic());
+		for (const auto &subscript : {"abc->a", "abc,ade->bcde", "abc,cde->ae", "ab,bc,cd->ad", "abc,ab,bc,ca->", "ab,cd->abcd"})
+			REQUIRE(not Subscript{subscript}.isCyclic());
+	}
+
+	template<typename value_type>
+	void test_generic_join(const std::string &subscript_string, const Hypertrie<tr> &hypertrie, const Hypertrie<tr> &graph) {
+		SECTION("{} {}"_format(subscript_string, (std::is_same_v<value_type, bool>) ? "bool" : "size_t")) {
+			auto subscript = std::make_shared<Subscript>(subscript_string);
+			std::vector<const_Hypertrie<tr>> operands;
+			for (const auto &operand : subscript->getRawSubscript().operands)
+				operands.push_back((operand.size() == 2) ? graph : hypertrie);
+			const auto expected = einsum2map<value_type, tr>(subscript, operands);
+
+			for (auto join_strategy : {JoinStrategy::generic_join, JoinStrategy::generic_join_if_cyclic})
+				REQUIRE(einsum2map<value_type, tr>(subscript, operands, TimePoint::max(), join_strategy) == expected);
+
+			// every entry is produced once for bool
+			size_t count = 0;
+			Einsum<value_type, tr> einsum{subscript, operands, TimePoint::max(), JoinStrategy::generic_join};
+			for ([[maybe_unused]] auto &&entry : einsum)
+				++count;
+			if constexpr (std::is_same_v<value_type, bool>)
+				REQUIRE(count == expected.size());
+
+			// resumed at every yield point
+			Executor executor{1};
+			decltype(einsum2map<value_type, tr>(subscript, operands)) actual;
+			auto generator = asyncEinsum<value_type, tr>(subscript, operands, {&executor, 16, 1, TimePoint::max(), JoinStrategy::generic_join});
+			while (auto batch = generator.waitNext())
+				for (const auto &entry : *batch)
+					actual[entry.key] += entry.value;
+			REQUIRE(actual == expected);
+		}
+	}
+
+	TEST_CASE("generic join computes the same results as label-at-a-time join", "[GenericJoin]") {
+		utils::EntryGenerator<unsigned long, bool, false> gen{1, 10};
+		HypertrieContext<tr> context;
+		Hypertrie<tr> hypertrie{3, context};
+		for (const auto &key : gen.keys(200, 3))
+			hypertrie.set(key, true);
+		Hypertrie<tr> graph{2, context};
+		for (const auto &key : gen.keys(40, 2))
+			graph.set(key, true);
+
+		// triangle, 4-cycle, cycles over triples, acyclic joins, diagonal and a join that leaves a Cartesian product
+		for (const auto &subscript : {"ab,bc,ca->", "ab,bc,ca->abc", "ab,bc,ca->a", "ab,bc,cd,da->", "ab,bc,cd,da->ac",
+									  "abx,bcy,caz->", "abc,cde,efa->ace", "abc,ade->bcde", "abc,cde->ae", "aab,bc->c",
+									  "ab,bc,cd->ad", "abc,bd,be->ade"}) {
+			test_generic_join<size_t>(subscript, hypertrie, graph);
+			test_generic_join<bool>(subscript, hypertrie, graph);
+		}
+	}
+
+};// namespace hypertrie::tests::generic_join
+
+#endif//HYPERTRIE_TESTGENERICJOIN_HPP
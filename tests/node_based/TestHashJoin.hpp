@@ -0,0 +1,146 @@
+#ifndef HYPERTRIE_TESTHASHJOIN_HPP
+#define HYPERTRIE_TESTHASHJOIN_HPP
+
+#include <map>
+#include <memory_resource>
+#include <set>
+
+#include <Dice/hypertrie/internal/HashJoin.hpp>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+
+
+namespace hypertrie::tests::hash_join {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+
+	template<HypertrieTrait tr>
+	using Join = HashJoin<tr>;
+	using poss_type = typename HashJoin<>::poss_type;
+
+	/**
+	 * The entries of every operand that remains for a join key part.
+	 */
+	template<HypertrieTrait tr>
+	using Results = std::map<typename tr::key_part_type, std::vector<std::set<typename tr::Key>>>;
+
+	template<HypertrieTrait tr>
+	std::set<typename tr::Key> entries(const const_Hypertrie<tr> &hypertrie) {
+		std::set<typename tr::Key> result;
+		for (const auto &key : hypertrie)
+			result.insert(key);
+		return result;
+	}
+
+	template<HypertrieTrait tr>
+	Results<tr> collect(typename Join<tr>::iterator &it) {
+		Results<tr> results;
+		for (; it; ++it) {
+			std::vector<std::set<typename tr::Key>> operands;
+			for (const auto &operand : it.operands())
+				operands.push_back(entries<tr>(operand));
+			// every key part is produced once
+			REQUIRE(results.emplace(it.keyPart(), std::move(operands)).second);
+		}
+		return results;
+	}
+
+	/**
+	 * Computes the join from the entries of the operands, without HashJoin or HashDiagonal.
+	 */
+	template<HypertrieTrait tr>
+	Results<tr> bruteForce(const std::vector<const_Hypertrie<tr>> &operands, const std::vector<poss_type> &positions) {
+		using key_part_type = typename tr::key_part_type;
+		using Key = typename tr::Key;
+		// for each joined operand: key part -> remaining keys of the entries that have the key part at all join positions
+		std::vector<std::map<key_part_type, std::set<Key>>> slices;
+		for (const auto &[operand, join_poss] : iter::zip(operands, positions)) {
+			if (join_poss.empty())
+				continue;
+			auto &slice = slices.emplace_back();
+			for (const auto &key : entries<tr>(operand)) {
+				const key_part_type key_part = key[join_poss.front()];
+				if (not std::all_of(join_poss.begin(), join_poss.end(), [&](pos_type pos) { return key[pos] == key_part; }))
+					continue;
+				Key rest;
+				for (pos_type pos = 0; pos < key.size(); ++pos)
+					if (std::find(join_poss.begin(), join_poss.end(), pos) == join_poss.end())
+						rest.push_back(key[pos]);
+				slice[key_part].insert(std::move(rest));
+			}
+		}
+
+		Results<tr> results;
+		for (const auto &[key_part, ignored] : slices.front()) {
+			if (not std::all_of(slices.begin(), slices.end(), [&](const auto &slice) { return slice.count(key_part); }))
+				continue;
+			auto &result = results[key_part];
+			size_t joined_operand = 0;
+			for (const auto &[operand, join_poss] : iter::zip(operands, positions)) {
+				if (join_poss.empty()) {
+					result.push_back(entries<tr>(operand));
+					continue;
+				}
+				// operands that are joined at all their positions do not remain
+				if (join_poss.size() < operand.depth())
+					result.push_back(slices[joined_operand].at(key_part));
+				++joined_operand;
+			}
+		}
+		return results;
+	}
+
+	template<HypertrieTrait tr>
+	void test_reloaded_join() {
+		utils::EntryGenerator<unsigned long, bool, false> gen{1, 30};
+		HypertrieContext<tr> context;
+		auto make = [&](size_t depth, size_t size) {
+			Hypertrie<tr> hypertrie{depth, context};
+			for (const auto &key : gen.keys(size, depth))
+				hypertrie.set(key, true);
+			return hypertrie;
+		};
+		const Hypertrie<tr> depth_1 = make(1, 20);
+		const Hypertrie<tr> other_depth_1 = make(1, 20);
+		const Hypertrie<tr> third_depth_1 = make(1, 15);
+		const Hypertrie<tr> tiny_depth_1 = make(1, 2);
+		const Hypertrie<tr> depth_2 = make(2, 100);
+		const Hypertrie<tr> depth_3 = make(3, 300);
+
+		// diagonals, depth 1 joins of similar size (sorted or bitmap intersection), a skewed depth 1 join, an operand that
+		// is not joined and a join of two positions of the same operand
+		const std::vector<std::pair<std::vector<const_Hypertrie<tr>>, std::vector<poss_type>>> joins{
+				{{depth_3, depth_3}, {{0}, {2}}},
+				{{depth_1, other_depth_1}, {{0}, {0}}},
+				{{depth_1, other_depth_1, third_depth_1}, {{0}, {0}, {0}}},
+				{{depth_1, depth_2, other_depth_1}, {{0}, {}, {0}}},
+				{{tiny_depth_1, depth_1}, {{0}, {0}}},
+				{{depth_3, depth_1, depth_3}, {{1}, {0}, {}}},
+				{{depth_3}, {{0, 1}}},
+				{{depth_2, depth_3}, {{0, 1}, {2}}},
+				{{depth_3, depth_3}, {{0}, {2}}}};
+
+		std::pmr::unsynchronized_pool_resource memory;
+		typename Join<tr>::iterator reloaded{&memory};
+		REQUIRE(not reloaded);
+		for (const auto &[operands, positions] : joins) {
+			const auto expected = bruteForce<tr>(operands, positions);
+			Join<tr> join{operands, positions};
+			auto fresh = join.begin();
+			REQUIRE(collect<tr>(fresh) == expected);
+			reloaded.load(operands, positions);
+			REQUIRE(collect<tr>(reloaded) == expected);
+		}
+		reloaded.clear();
+		REQUIRE(not reloaded);
+	}
+
+	TEMPLATE_TEST_CASE("a join iterator is reloaded", "[HashJoin]", default_bool_Hypertrie_t, bitmap_bool_Hypertrie_t) {
+		test_reloaded_join<TestType>();
+	}
+
+};// namespace hypertrie::tests::hash_join
+
+#endif//HYPERTRIE_TESTHASHJOIN_HPP
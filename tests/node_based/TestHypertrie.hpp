@@ -37,7 +37,7 @@ namespace hypertrie::tests::node_context {
 		}
 	}
 
-	TEMPLATE_TEST_CASE("test_single_write_read", "[Hypertrie]", lsbunused_bool_Hypertrie_t, default_bool_Hypertrie_t, default_long_Hypertrie_t, default_double_Hypertrie_t) {
+	TEMPLATE_TEST_CASE("test_single_write_read", "[Hypertrie]", lsbunused_bool_Hypertrie_t, default_bool_Hypertrie_t, default_long_Hypertrie_t, default_double_Hypertrie_t, swiss_bool_Hypertrie_t, depth_tuned_bool_Hypertrie_t) {
 		using tr = TestType;
 		test_single_write<tr, 1>();
 		test_single_write<tr, 2>();
@@ -46,7 +46,7 @@ namespace hypertrie::tests::node_context {
 		test_single_write<tr, 5>();
 	}
 
-	TEMPLATE_TEST_CASE("test_iterator", "[Hypertrie]", lsbunused_bool_Hypertrie_t, default_bool_Hypertrie_t) {
+	TEMPLATE_TEST_CASE("test_iterator", "[Hypertrie]", lsbunused_bool_Hypertrie_t, default_bool_Hypertrie_t, swiss_bool_Hypertrie_t, depth_tuned_bool_Hypertrie_t) {
 		using tr = TestType;
 		constexpr const size_t depth = 4;
 		using key_part_type = typename tr::key_part_type;
@@ -78,7 +78,7 @@ namespace hypertrie::tests::node_context {
 		}
 	}
 
-	TEMPLATE_TEST_CASE("test_diagonal", "[Hypertrie]", lsbunused_bool_Hypertrie_t, default_bool_Hypertrie_t) {
+	TEMPLATE_TEST_CASE("test_diagonal", "[Hypertrie]", lsbunused_bool_Hypertrie_t, default_bool_Hypertrie_t, swiss_bool_Hypertrie_t, depth_tuned_bool_Hypertrie_t) {
 		using tr = TestType;
 		constexpr const size_t depth = 4;
 		using key_part_type = typename tr::key_part_type;
@@ -130,8 +130,8 @@ namespace hypertrie::tests::node_context {
 		}
 	}
 
-	TEMPLATE_TEST_CASE("test_slice", "[Hypertrie]", lsbunused_bool_Hypertrie_t, default_bool_Hypertrie_t) {
-		using tr = lsbunused_bool_Hypertrie_t;
+	TEMPLATE_TEST_CASE("test_slice", "[Hypertrie]", lsbunused_bool_Hypertrie_t, default_bool_Hypertrie_t, swiss_bool_Hypertrie_t, depth_tuned_bool_Hypertrie_t) {
+		using tr = TestType;
 		constexpr const size_t depth = 4;
 
 		HypertrieContext<tr> context;
@@ -151,6 +151,56 @@ namespace hypertrie::tests::node_context {
 		WARN((std::string) sliced_hypertrie);
 	}
 
+	TEMPLATE_TEST_CASE("test_snapshot", "[Hypertrie]", lsbunused_bool_Hypertrie_t, default_bool_Hypertrie_t) {
+		using tr = TestType;
+		constexpr const size_t depth = 3;
+		using key_part_type = typename tr::key_part_type;
+		using value_type = typename tr::value_type;
+
+		utils::EntryGenerator<key_part_type, value_type, tr::lsb_unused> gen{1, 15};
+		auto keys = gen.keys(100, depth);
+		auto more_keys = gen.keys(100, depth);
+
+		HypertrieContext<tr> context;
+		Hypertrie<tr> t{depth, context};
+		for (const auto &key : keys)
+			t.set(key, true);
+
+		const_Hypertrie<tr> snapshot = t.snapshot();
+		REQUIRE(snapshot.pinned());
+		REQUIRE(snapshot == t);
+		const_Hypertrie<tr> snapshot_copy = snapshot;
+		REQUIRE(snapshot_copy.pinned());
+
+		for (const auto &key : more_keys)
+			t.set(key, true);
+
+		REQUIRE(snapshot.size() == keys.size());
+		REQUIRE(snapshot_copy.size() == keys.size());
+		for (const auto &key : keys)
+			REQUIRE(snapshot[key]);
+		size_t count = 0;
+		for ([[maybe_unused]] const auto &key : snapshot)
+			++count;
+		REQUIRE(count == keys.size());
+
+		for (const auto &key : more_keys)
+			REQUIRE(t[key]);
+	}
+
+	TEST_CASE("containers are selected per depth", "[Hypertrie]") {
+		using namespace hypertrie::internal::container;
+		using hypertrie::internal::raw::CompressedNode;
+		using hypertrie::internal::raw::LevelNodeStorage;
+		using hypertrie::internal::raw::TensorHash;
+		using hypertrie::internal::raw::UncompressedNode;
+		using tri = hypertrie::internal::raw::Hypertrie_internal_t<depth_tuned_bool_Hypertrie_t>;
+		STATIC_REQUIRE(std::is_same_v<UncompressedNode<1, tri>::ChildrenType, tsl_sparse_set<unsigned long>>);
+		STATIC_REQUIRE(std::is_same_v<UncompressedNode<2, tri>::ChildrenType, swiss_map<unsigned long, TensorHash>>);
+		STATIC_REQUIRE(std::is_same_v<LevelNodeStorage<1, tri>::UncompressedNodeMap, swiss_map<TensorHash, UncompressedNode<1, tri> *>>);
+		STATIC_REQUIRE(std::is_same_v<LevelNodeStorage<3, tri>::CompressedNodeMap, swiss_map<TensorHash, CompressedNode<3, tri> *>>);
+	}
+
 };// namespace hypertrie::tests::node_context
 
 #endif//HYPERTRIE_TESTHYPERTRIE_H
@@ -4,7 +4,9 @@
 #include <boost/type_index.hpp>
 #include <enumerate.hpp>
 #include <fmt/format.h>
+#include <thread>
 
+#include <Dice/hypertrie/internal/raw/node/ContextlessNodePool.hpp>
 #include <Dice/hypertrie/internal/raw/node/Node.hpp>
 
 #include "../utils/AssetGenerator.hpp"
@@ -86,6 +88,30 @@ namespace hypertrie::tests::raw::node {
 		createEmptyUncompressed<default_double_Hypertrie_internal_t, 3>();
 	}
 
+	TEST_CASE("contextless compressed nodes are recycled", "[Node]") {
+		using tri = default_long_Hypertrie_internal_t;
+		using Pool = ContextlessNodePool<2, tri>;
+		using Node = Pool::Node;
+
+		const Node original{Key<2, unsigned long>{3, 5}, 7};
+		Node *node = Pool::acquire(original);
+		REQUIRE(node->key() == original.key());
+		REQUIRE(node->value() == 7);
+		Pool::release(node);
+
+		// the released node is handed out again with the new content
+		Node *recycled = Pool::acquire();
+		REQUIRE(recycled == node);
+		REQUIRE(recycled->key() == Key<2, unsigned long>{});
+		REQUIRE(recycled->value() == 0);
+
+		// nodes may be released on another thread
+		std::thread{[&]() { Pool::release(recycled); }}.join();
+		Node *fresh = Pool::acquire(original);
+		REQUIRE(fresh->key() == original.key());
+		Pool::release(fresh);
+	}
+
 };// namespace hypertrie::tests::node
 
 #endif//HYPERTRIE_TESTNODE_HPP
@@ -0,0 +1,190 @@
+#ifndef HYPERTRIE_TESTNODEPAGING_HPP
+#define HYPERTRIE_TESTNODEPAGING_HPP
+
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <vector>
+
+#include <Dice/hypertrie/internal/Checkpoint.hpp>
+#include <Dice/hypertrie/internal/Hypertrie.hpp>
+#include <Dice/hypertrie/internal/HypertrieContext.hpp>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+#include "../utils/TemporaryFile.hpp"
+
+
+namespace hypertrie::tests::node_paging {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+
+	template<HypertrieTrait tr, size_t depth>
+	void test_paged_hypertrie() {
+		using key_part_type = typename tr::key_part_type;
+		using value_type = typename tr::value_type;
+		using Key = typename tr::Key;
+		SECTION("depth {}"_format(depth)) {
+			const TemporaryFile page_file{"paged", "pages"};
+			const TemporaryFile checkpoint_file{"checkpoint", "ckpt"};
+			utils::RawGenerator<depth, key_part_type, value_type, size_t(tr::lsb_unused)> gen{1, 30, value_type(1), value_type(5)};
+			std::map<Key, value_type> entries;
+
+			HypertrieContext<tr> context;
+			context.enableNodePaging({page_file.path, 20, depth});
+			Hypertrie<tr> paged{depth, context};
+			HypertrieContext<tr> reference_context;
+			Hypertrie<tr> reference{depth, reference_context};
+
+			auto set_random = [&](size_t count) {
+				for (size_t i = 0; i < count; ++i) {
+					auto raw_key = gen.key();
+					Key key{raw_key.begin(), raw_key.end()};
+					const value_type value = gen.value();
+					paged.set(key, value);
+					reference.set(key, value);
+					entries[key] = value;
+				}
+			};
+			auto require_equal = [&]() {
+				REQUIRE(paged.size() == reference.size());
+				REQUIRE(paged.hash() == reference.hash());
+				for (const auto &[key, value] : entries)
+					REQUIRE(paged[key] == value);
+			};
+
+			set_random(1'000);
+			if constexpr (depth > 1)// a depth 1 hypertrie consists of its pinned root only
+				REQUIRE(context.evictNodes() > 0);
+			else
+				REQUIRE(context.evictNodes() == 0);
+			require_equal();
+
+			// modifying faults in the evicted nodes on the modified paths
+			set_random(200);
+			context.evictNodes();
+			require_equal();
+
+			// a full checkpoint contains the evicted nodes
+			REQUIRE(not HypertrieCheckpoint<tr>::write(context, {paged}, checkpoint_file.path));
+			{
+				HypertrieContext<tr> restored_context;
+				auto restored = HypertrieCheckpoint<tr>::restore(restored_context, {checkpoint_file.path});
+				REQUIRE(restored[0].hash() == reference.hash());
+			}
+		}
+	}
+
+	// edge containers without reserve
+	using std_map_bool_Hypertrie_t = Hypertrie_t<unsigned long, bool, internal::container::std_map, internal::container::std_set>;
+
+	TEMPLATE_TEST_CASE("nodes are evicted to a page file and faulted in on access", "[NodePaging]", default_bool_Hypertrie_t, lsbunused_bool_Hypertrie_t, default_long_Hypertrie_t, std_map_bool_Hypertrie_t) {
+		test_paged_hypertrie<TestType, 1>();
+		test_paged_hypertrie<TestType, 2>();
+		test_paged_hypertrie<TestType, 3>();
+	}
+
+	TEST_CASE("recently used nodes stay resident", "[NodePaging]") {
+		using tr = default_bool_Hypertrie_t;
+		using namespace hypertrie::internal::raw;
+		const TemporaryFile page_file{"lru", "pages"};
+		HypertrieContext<tr> context;
+		context.enableNodePaging({page_file.path, 2, 2});
+		Hypertrie<tr> hypertrie{2, context};
+		// every row is a distinct uncompressed depth 1 node
+		for (unsigned long i = 1; i <= 10; ++i) {
+			hypertrie.set({i, i}, true);
+			hypertrie.set({i, i + 100}, true);
+		}
+		auto &storage = context.rawContext().storage;
+		auto &rows = storage.template getNodeStorage<1, NodeCompression::uncompressed>();
+		REQUIRE(context.evictNodes() > 0);
+		REQUIRE(std::filesystem::file_size(page_file.path) > 0);
+
+		// slicing faults the rows in, row 7 is accessed last
+		std::vector<TensorHash> row_hashes;
+		for (unsigned long i : {1, 2, 3, 4, 5, 6, 8, 9, 10, 7}) {
+			const_Hypertrie<tr> row = std::get<0>(hypertrie[typename tr::SliceKey{i, std::nullopt}]);
+			REQUIRE(row.size() == 2);
+			row_hashes.emplace_back(row.hash());
+			REQUIRE(rows.find(row_hashes.back()) != rows.end());
+		}
+		REQUIRE(context.evictNodes() > 0);
+		REQUIRE(rows.find(row_hashes[9]) != rows.end());
+		REQUIRE(rows.find(row_hashes[8]) != rows.end());
+		REQUIRE(rows.find(row_hashes[0]) == rows.end());
+
+		// evicted rows are faulted in again
+		REQUIRE(std::get<0>(hypertrie[typename tr::SliceKey{1, std::nullopt}]).size() == 2);
+		REQUIRE(rows.find(row_hashes[0]) != rows.end());
+
+		REQUIRE_THROWS_AS(context.enableNodePaging({page_file.path, 2, 2}), std::logic_error);
+	}
+
+	TEST_CASE("pinned hypertries stay valid when nodes are evicted", "[NodePaging]") {
+		using tr = default_bool_Hypertrie_t;
+		using Key = typename tr::Key;
+		using SliceKey = typename tr::SliceKey;
+		const TemporaryFile page_file{"pinned", "pages"};
+		HypertrieContext<tr> context;
+		context.enableNodePaging({page_file.path, 0, 3});
+		Hypertrie<tr> hypertrie{3, context};
+		std::vector<Key> keys;
+		for (unsigned long i = 1; i <= 10; ++i)
+			for (unsigned long j = 1; j <= 3; ++j)
+				keys.push_back({i, j, i + j});
+		for (const auto &key : keys)
+			hypertrie.set(key, true);
+
+		const auto snapshot = hypertrie.snapshot();
+		const auto snapshot_hash = snapshot.hash();
+		// a pinned slice has its root at an unpinned depth
+		const auto slice = std::get<0>(hypertrie[SliceKey{1, std::nullopt, std::nullopt}]).pinnedCopy();
+		const auto slice_hash = slice.hash();
+		REQUIRE(slice.size() == 3);
+
+		// the versions the pinned hypertries refer to are replaced
+		for (const auto &key : keys)
+			if (key[0] <= 5)
+				hypertrie.set(key, false);
+		REQUIRE(context.evictNodes() > 0);
+
+		REQUIRE(snapshot.hash() == snapshot_hash);
+		REQUIRE(snapshot.size() == keys.size());
+		for (const auto &key : keys)
+			REQUIRE(snapshot[key]);
+		size_t iterated = 0;
+		for (const auto &key : snapshot) {
+			REQUIRE(std::find(keys.begin(), keys.end(), key) != keys.end());
+			++iterated;
+		}
+		REQUIRE(iterated == keys.size());
+
+		REQUIRE(slice.hash() == slice_hash);
+		REQUIRE(slice.size() == 3);
+		for (unsigned long j = 1; j <= 3; ++j)
+			REQUIRE(slice[Key{j, 1 + j}]);
+		REQUIRE(std::get<0>(slice[SliceKey{2, std::nullopt}]).size() == 1);
+
+		REQUIRE(hypertrie.size() == keys.size() / 2);
+	}
+
+	TEST_CASE("the page file is removed with the context", "[NodePaging]") {
+		using tr = default_bool_Hypertrie_t;
+		const TemporaryFile page_file{"removed", "pages"};
+		{
+			HypertrieContext<tr> context;
+			context.enableNodePaging({page_file.path, 0, 3});
+			Hypertrie<tr> hypertrie{3, context};
+			hypertrie.set({1, 2, 3}, true);
+			hypertrie.set({1, 2, 4}, true);
+			context.evictNodes();
+			REQUIRE(std::filesystem::exists(page_file.path));
+		}
+		REQUIRE(not std::filesystem::exists(page_file.path));
+	}
+
+};// namespace hypertrie::tests::node_paging
+
+#endif//HYPERTRIE_TESTNODEPAGING_HPP
@@ -0,0 +1,110 @@
+#ifndef HYPERTRIE_TESTNUMA_HPP
+#define HYPERTRIE_TESTNUMA_HPP
+
+#include <mutex>
+#include <set>
+
+#include <Dice/hypertrie/internal/BulkInserter.hpp>
+#include <Dice/hypertrie/internal/Hypertrie.hpp>
+#include <Dice/hypertrie/internal/HypertrieContext.hpp>
+#include <Dice/hypertrie/internal/ParallelIteration.hpp>
+#include <Dice/hypertrie/internal/util/Numa.hpp>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+
+
+namespace hypertrie::tests::numa {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+	using namespace hypertrie::internal::util;
+
+	TEST_CASE("the NUMA topology has a node with CPUs", "[Numa]") {
+		const auto &topology = NumaTopology::instance();
+		REQUIRE(topology.nodes() >= 1);
+		for (size_t node = 0; node < topology.nodes(); ++node)
+			REQUIRE(not topology.cpus(node).empty());
+		for (unsigned long key_part = 0; key_part < 100; ++key_part)
+			REQUIRE(topology.nodeOf(key_part) < topology.nodes());
+	}
+
+	template<HypertrieTrait tr, size_t depth>
+	void test_numa_placement() {
+		using key_part_type = typename tr::key_part_type;
+		using value_type = typename tr::value_type;
+		using Key = typename tr::Key;
+
+		SECTION("depth {}"_format(depth)) {
+			utils::EntryGenerator<key_part_type, value_type, tr::lsb_unused> gen{1, 30};
+			auto keys = gen.keys(200, depth);
+
+			HypertrieContext<tr> reference_context;
+			Hypertrie<tr> reference{depth, reference_context};
+			for (const auto &key : keys)
+				reference.set(key, true);
+
+			for (auto placement : {NumaPlacement::interleaved, NumaPlacement::partitioned}) {
+				HypertrieContext<tr> context;
+				context.setNumaPlacement(placement);
+				Hypertrie<tr> t{depth, context};
+				for (const auto &key : keys)
+					t.set(key, true);
+				REQUIRE(t.hash() == reference.hash());
+
+				Hypertrie<tr> bulk{depth, context};
+				{
+					BulkInserter<tr> inserter{bulk, 50};
+					for (const auto &key : keys)
+						inserter.add(key);
+				}
+				REQUIRE(bulk.hash() == reference.hash());
+
+				std::mutex mutex;
+				std::set<Key> actual_keys;
+				size_t count = 0;
+				parallel_for_each<tr>(t, [&](const Key &key) {
+					std::lock_guard<std::mutex> lock{mutex};
+					actual_keys.insert(key);
+					++count;
+				}, 4, 0, true);
+				REQUIRE(count == keys.size());
+				REQUIRE(actual_keys == keys);
+			}
+		}
+	}
+
+	TEMPLATE_TEST_CASE("nodes are placed on NUMA nodes and iterated by pinned threads", "[Numa]", default_bool_Hypertrie_t, lsbunused_bool_Hypertrie_t) {
+		using tr = TestType;
+		test_numa_placement<tr, 2>();
+		test_numa_placement<tr, 3>();
+	}
+
+	/**
+	 * @return the memory policy mode of the calling thread
+	 */
+	int memoryPolicyMode() {
+		int mode = -1;
+		REQUIRE(::syscall(SYS_get_mempolicy, &mode, nullptr, 0, nullptr, 0) == 0);
+		return mode;
+	}
+
+	TEST_CASE("scoped memory policies are restored", "[Numa]") {
+		const int default_mode = memoryPolicyMode();
+		for (auto placement : {NumaPlacement::first_touch, NumaPlacement::interleaved, NumaPlacement::partitioned}) {
+			{
+				ScopedMemoryPolicy policy{placement, NumaTopology::instance().nodes() - 1};
+				if (placement == NumaPlacement::first_touch or NumaTopology::instance().nodes() == 1)
+					REQUIRE(not policy.active());
+				if (policy.active())
+					REQUIRE(memoryPolicyMode() == ((placement == NumaPlacement::interleaved) ? MPOL_INTERLEAVE : MPOL_PREFERRED));
+				else
+					REQUIRE(memoryPolicyMode() == default_mode);
+			}
+			REQUIRE(memoryPolicyMode() == default_mode);
+		}
+	}
+
+};// namespace hypertrie::tests::numa
+
+#endif//HYPERTRIE_TESTNUMA_HPP
@@ -0,0 +1,96 @@
+#ifndef HYPERTRIE_TESTORDEREDITERATOR_HPP
+#define HYPERTRIE_TESTORDEREDITERATOR_HPP
+
+#include <Dice/hypertrie/internal/Hypertrie.hpp>
+#include <Dice/hypertrie/internal/HypertrieContext.hpp>
+#include <Dice/hypertrie/internal/OrderedIterator.hpp>
+
+#include <numeric>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+
+
+namespace hypertrie::tests::ordered_iterator {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+
+	template<HypertrieTrait tr, size_t depth>
+	void test_ordered_iterator() {
+		using key_part_type = typename tr::key_part_type;
+		using value_type = typename tr::value_type;
+		using Key = typename tr::Key;
+		using KeyPositions = typename tr::KeyPositions;
+
+		SECTION("depth {}"_format(depth)) {
+			utils::EntryGenerator<key_part_type, value_type, tr::lsb_unused> gen{1, 15, value_type(1), value_type(9)};
+			auto entries = gen.entries((depth == 1) ? 10 : 200, depth);
+
+			HypertrieContext<tr> context;
+			Hypertrie<tr> t{depth, context};
+			for (const auto &[key, value] : entries)
+				t.set(key, value);
+
+			KeyPositions permutation(depth);
+			std::iota(permutation.begin(), permutation.end(), 0);
+			do {
+				std::string permutation_name;
+				for (auto pos : permutation)
+					permutation_name += char('0' + pos);
+				SECTION("permutation {}"_format(permutation_name)) {
+					// the expected order: entries sorted by their permuted keys
+					std::vector<std::pair<Key, value_type>> expected(entries.begin(), entries.end());
+					auto permuted = [&](const Key &key) {
+						Key result(depth);
+						for (size_t i = 0; i < depth; ++i)
+							result[i] = key[permutation[i]];
+						return result;
+					};
+					std::sort(expected.begin(), expected.end(),
+							  [&](const auto &left, const auto &right) { return permuted(left.first) < permuted(right.first); });
+
+					size_t count = 0;
+					for (OrderedIterator<tr> it{t, permutation}; it; ++it, ++count) {
+						REQUIRE(count < expected.size());
+						if constexpr (tr::is_bool_valued) {
+							REQUIRE(*it == expected[count].first);
+						} else {
+							REQUIRE(it->first == expected[count].first);
+							REQUIRE(it->second == expected[count].second);
+						}
+					}
+					REQUIRE(count == expected.size());
+				}
+			} while (std::next_permutation(permutation.begin(), permutation.end()));
+		}
+	}
+
+	TEMPLATE_TEST_CASE("iterating hypertrie entries in the order of a permutation", "[OrderedIterator]", lsbunused_bool_Hypertrie_t, default_bool_Hypertrie_t, default_long_Hypertrie_t) {
+		test_ordered_iterator<TestType, 1>();
+		test_ordered_iterator<TestType, 2>();
+		test_ordered_iterator<TestType, 3>();
+		test_ordered_iterator<TestType, 4>();
+	}
+
+	TEST_CASE("ordered iteration of empty hypertries and invalid permutations", "[OrderedIterator]") {
+		using tr = default_bool_Hypertrie_t;
+		HypertrieContext<tr> context;
+		Hypertrie<tr> t{3, context};
+		REQUIRE_FALSE(OrderedIterator<tr>{t, {2, 0, 1}});
+
+		t.set({1, 2, 3}, true);
+		OrderedIterator<tr> it{t, {2, 0, 1}};
+		REQUIRE(it);
+		REQUIRE(*it == tr::Key{1, 2, 3});
+		++it;
+		REQUIRE(it.ended());
+
+		REQUIRE_THROWS_AS((OrderedIterator<tr>{t, {0, 1}}), std::invalid_argument);
+		REQUIRE_THROWS_AS((OrderedIterator<tr>{t, {0, 1, 1}}), std::invalid_argument);
+		REQUIRE_THROWS_AS((OrderedIterator<tr>{t, {0, 1, 3}}), std::invalid_argument);
+	}
+
+};// namespace hypertrie::tests::ordered_iterator
+
+#endif//HYPERTRIE_TESTORDEREDITERATOR_HPP
@@ -0,0 +1,84 @@
+#ifndef HYPERTRIE_TESTPARALLELITERATION_HPP
+#define HYPERTRIE_TESTPARALLELITERATION_HPP
+
+#include <mutex>
+
+#include <Dice/hypertrie/internal/Hypertrie.hpp>
+#include <Dice/hypertrie/internal/HypertrieContext.hpp>
+#include <Dice/hypertrie/internal/ParallelIteration.hpp>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+
+
+namespace hypertrie::tests::parallel_iteration {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+
+	template<HypertrieTrait tr, size_t depth>
+	void test_split() {
+		using key_part_type = typename tr::key_part_type;
+		using value_type = typename tr::value_type;
+		using Key = typename tr::Key;
+
+		SECTION("depth {}"_format(depth)) {
+			utils::EntryGenerator<key_part_type, value_type, tr::lsb_unused> gen{1, 30};
+			auto keys = gen.keys((depth == 1) ? 20 : 200, depth);
+
+			HypertrieContext<tr> context;
+			Hypertrie<tr> t{depth, context};
+			for (const auto &key : keys)
+				t.set(key, true);
+
+			for (pos_type pos = 0; pos < depth; ++pos) {
+				for (size_t k : {1, 3, 8}) {
+					auto ranges = split<tr>(t, k, pos);
+					REQUIRE(ranges.size() <= k);
+					std::set<Key> actual_keys;
+					size_t count = 0;
+					for (const auto &range : ranges) {
+						REQUIRE(not range.empty());
+						range.for_each([&](const Key &key) {
+							actual_keys.insert(key);
+							++count;
+						});
+					}
+					REQUIRE(count == keys.size());
+					REQUIRE(actual_keys == keys);
+				}
+
+				std::mutex mutex;
+				std::set<Key> actual_keys;
+				parallel_for_each<tr>(t, [&](const Key &key) {
+					std::lock_guard<std::mutex> lock{mutex};
+					actual_keys.insert(key);
+				}, 4, pos);
+				REQUIRE(actual_keys == keys);
+			}
+
+			// a single entry is not split
+			Hypertrie<tr> single{depth, context};
+			single.set(*keys.begin(), true);
+			auto ranges = split<tr>(single, 4);
+			REQUIRE(ranges.size() == 1);
+			size_t count = 0;
+			ranges[0].for_each([&](const Key &key) {
+				REQUIRE(key == *keys.begin());
+				++count;
+			});
+			REQUIRE(count == 1);
+		}
+	}
+
+	TEMPLATE_TEST_CASE("test_split", "[ParallelIteration]", lsbunused_bool_Hypertrie_t, default_bool_Hypertrie_t) {
+		using tr = TestType;
+		test_split<tr, 1>();
+		test_split<tr, 2>();
+		test_split<tr, 3>();
+		test_split<tr, 4>();
+	}
+
+};// namespace hypertrie::tests::parallel_iteration
+
+#endif//HYPERTRIE_TESTPARALLELITERATION_HPP
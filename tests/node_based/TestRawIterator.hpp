@@ -95,6 +95,68 @@ namespace hypertrie::tests::raw::node_context::iterator_test {
 	TEMPLATE_TEST_CASE_SIG("iterating hypertrie entries [double]", "[RawIterator]", ((size_t depth), depth), 1, 2, 3, 4, 5) {
 		randomized_iterator_test<default_double_Hypertrie_internal_t, depth>();
 	}
+
+	template<HypertrieInternalTrait tri, size_t depth>
+	void raw_key_iterator_test() {
+		using key_part_type = typename tri::key_part_type;
+		using value_type = typename tri::value_type;
+		using Key = typename tri::template RawKey<depth>;
+		using Entry = typename tri::template RawIteratorEntry<depth>;
+
+		const auto key_of = [](const Entry &entry) -> const Key & {
+			if constexpr (tri::is_bool_valued) return entry;
+			else
+				return entry.first;
+		};
+		const auto value_of = [](const Entry &entry) -> value_type {
+			if constexpr (tri::is_bool_valued) return true;
+			else
+				return entry.second;
+		};
+
+		utils::RawGenerator<depth, key_part_type, value_type, size_t(tri::is_lsb_unused)> gen{};
+		gen.setKeyPartMinMax(0, 2000);
+		gen.setValueMinMax(value_type(1), value_type(5));
+
+		for (size_t count : {1, 2, 50, 500}) {
+			SECTION("{} entries"_format(count)) {
+				NodeContext<depth, tri> context{};
+				UncompressedNodeContainer<depth, tri> nodec{};
+				std::map<Key, value_type> entries;
+				for (const auto &[key, value] : gen.entries(count))
+					entries[key] = value;
+				for (const auto &[key, value] : entries)
+					context.template set<depth>(nodec, key, value);
+
+				std::map<Key, value_type> found;
+				for (auto iter = raw_key_iterator<depth, tri>(nodec, context); iter; ++iter)
+					found[key_of(*iter)] = value_of(*iter);
+				REQUIRE(found == entries);
+
+				// export block-wise
+				std::map<Key, value_type> filled;
+				std::array<Entry, 7> block;
+				auto iter = raw_key_iterator<depth, tri>(nodec, context);
+				for (size_t written = iter.fill(block); written > 0; written = iter.fill(block))
+					for (const auto &entry : std::span{block.data(), written})
+						filled[key_of(entry)] = value_of(entry);
+				REQUIRE(not iter);
+				REQUIRE(filled == entries);
+			}
+		}
+	}
+
+	TEMPLATE_TEST_CASE_SIG("iterating hypertrie entries with raw keys [bool]", "[RawIterator]", ((size_t depth), depth), 1, 2, 3, 4, 5) {
+		raw_key_iterator_test<default_bool_Hypertrie_internal_t, depth>();
+	}
+
+	TEMPLATE_TEST_CASE_SIG("iterating hypertrie entries with raw keys [bool lsb-unused]", "[RawIterator]", ((size_t depth), depth), 1, 2, 3, 4, 5) {
+		raw_key_iterator_test<lsbunused_bool_Hypertrie_internal_t, depth>();
+	}
+
+	TEMPLATE_TEST_CASE_SIG("iterating hypertrie entries with raw keys [long]", "[RawIterator]", ((size_t depth), depth), 1, 2, 3, 4, 5) {
+		raw_key_iterator_test<default_long_Hypertrie_internal_t, depth>();
+	}
 }// namespace hypertrie::tests::raw::node_context::iterator_test
 
 #endif//HYPERTRIE_TESTRAWITERATOR_HPP
@@ -0,0 +1,195 @@
+#ifndef HYPERTRIE_TESTROARINGBITMAPSET_HPP
+#define HYPERTRIE_TESTROARINGBITMAPSET_HPP
+
+#include <Dice/hypertrie/internal/HashJoin.hpp>
+#include <Dice/hypertrie/internal/Hypertrie.hpp>
+#include <Dice/hypertrie/internal/HypertrieContext.hpp>
+#include <Dice/hypertrie/internal/container/RoaringBitmapSet.hpp>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+
+
+namespace hypertrie::tests::roaring_bitmap_set {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+	using hypertrie::internal::container::roaring_bitmap_set;
+
+	using key_part_type = unsigned long;
+
+	/**
+	 * Key parts of a sparse range, a dense range that is stored in bitmap chunks, and a range spanning several chunks.
+	 */
+	std::vector<std::pair<key_part_type, key_part_type>> key_part_ranges() {
+		return {{1, 1'000'000'000}, {1, 10'000}, {60'000, 200'000}};
+	}
+
+	TEST_CASE("roaring bitmap set behaves like std::set", "[RoaringBitmapSet]") {
+		for (const auto &[min, max] : key_part_ranges()) {
+			SECTION("key parts {} to {}"_format(min, max)) {
+				utils::RawGenerator<1, key_part_type, bool> gen{min, max};
+				std::set<key_part_type> expected;
+				roaring_bitmap_set<key_part_type> set;
+				for (size_t i = 0; i < 30'000; ++i) {
+					const key_part_type key_part = gen.key_part();
+					// insert two thirds, erase one third
+					if (i % 3 != 2) {
+						REQUIRE(set.insert(key_part).second == expected.insert(key_part).second);
+					} else {
+						REQUIRE(set.erase(key_part) == expected.erase(key_part));
+					}
+					REQUIRE(set.size() == expected.size());
+				}
+				REQUIRE(std::vector<key_part_type>(set.begin(), set.end()) == std::vector<key_part_type>(expected.begin(), expected.end()));
+				for (size_t i = 0; i < 1'000; ++i) {
+					const key_part_type key_part = gen.key_part();
+					REQUIRE(set.contains(key_part) == bool(expected.count(key_part)));
+					auto found = set.find(key_part);
+					if (expected.count(key_part)) {
+						REQUIRE(found != set.end());
+						REQUIRE(*found == key_part);
+						auto next = found;
+						++next;
+						auto expected_next = std::next(expected.find(key_part));
+						REQUIRE((next == set.end()) == (expected_next == expected.end()));
+						if (expected_next != expected.end())
+							REQUIRE(*next == *expected_next);
+					} else {
+						REQUIRE(found == set.end());
+					}
+				}
+				REQUIRE(roaring_bitmap_set<key_part_type>(expected.begin(), expected.end()) == set);
+
+				for (key_part_type key_part : expected)
+					set.erase(key_part);
+				REQUIRE(set.empty());
+				REQUIRE(set.begin() == set.end());
+			}
+		}
+	}
+
+	TEST_CASE("roaring bitmap sets are intersected", "[RoaringBitmapSet]") {
+		for (const auto &[min, max] : key_part_ranges()) {
+			SECTION("key parts {} to {}"_format(min, max)) {
+				utils::RawGenerator<1, key_part_type, bool> gen{min, max};
+				std::set<key_part_type> expected_a;
+				std::set<key_part_type> expected_b;
+				for (size_t i = 0; i < 20'000; ++i)
+					expected_a.insert(gen.key_part());
+				for (size_t i = 0; i < 5'000; ++i)
+					expected_b.insert(gen.key_part());
+				std::vector<key_part_type> expected;
+				std::set_intersection(expected_a.begin(), expected_a.end(), expected_b.begin(), expected_b.end(), std::back_inserter(expected));
+
+				roaring_bitmap_set<key_part_type> a(expected_a.begin(), expected_a.end());
+				roaring_bitmap_set<key_part_type> b(expected_b.begin(), expected_b.end());
+				auto a_and_b = a & b;
+				auto b_and_a = b & a;
+				REQUIRE(a_and_b.size() == expected.size());
+				REQUIRE(std::vector<key_part_type>(a_and_b.begin(), a_and_b.end()) == expected);
+				REQUIRE(a_and_b == b_and_a);
+				std::vector<key_part_type> intersected;
+				b.intersect_into(a, intersected);
+				REQUIRE(intersected == expected);
+				a &= roaring_bitmap_set<key_part_type>{};
+				REQUIRE(a.empty());
+			}
+		}
+	}
+
+	TEST_CASE("hypertries with bitmap leaves", "[RoaringBitmapSet]") {
+		using tr = bitmap_bool_Hypertrie_t;
+		STATIC_REQUIRE(tr::has_bitmap_leaves);
+		STATIC_REQUIRE(not default_bool_Hypertrie_t::has_bitmap_leaves);
+
+		for (size_t depth : {1, 2, 3}) {
+			SECTION("depth {}"_format(depth)) {
+				utils::EntryGenerator<key_part_type, bool> gen{1, 200};
+				auto keys = gen.keys((depth == 1) ? 150 : 2'000, depth);
+				HypertrieContext<tr> context;
+				HypertrieContext<default_bool_Hypertrie_t> default_context;
+				Hypertrie<tr> t{depth, context};
+				Hypertrie<default_bool_Hypertrie_t> expected{depth, default_context};
+				for (const auto &key : keys) {
+					t.set(key, true);
+					expected.set(key, true);
+				}
+				// the node hashes do not depend on the edge container
+				REQUIRE(t.hash() == expected.hash());
+				REQUIRE(t.size() == keys.size());
+				std::set<typename tr::Key> iterated;
+				for (const auto &key : t)
+					iterated.insert(key);
+				REQUIRE(iterated == keys);
+				for (const auto &key : keys)
+					REQUIRE(t[key]);
+			}
+		}
+	}
+
+	TEST_CASE("joining depth 1 hypertries with bitmap leaves", "[RoaringBitmapSet]") {
+		using tr = bitmap_bool_Hypertrie_t;
+		HypertrieContext<tr> context;
+		utils::RawGenerator<1, key_part_type, bool> gen{1, 100'000};
+
+		std::vector<std::set<key_part_type>> operand_keys(3);
+		std::vector<Hypertrie<tr>> operand_hypertries;
+		for (auto [size, keys] : iter::zip(std::vector<size_t>{50'000, 20'000, 30'000}, operand_keys)) {
+			auto &operand = operand_hypertries.emplace_back(1, context);
+			while (keys.size() < size) {
+				auto key_part = gen.key_part();
+				keys.insert(key_part);
+				operand.set({key_part}, true);
+			}
+		}
+		std::vector<const_Hypertrie<tr>> operands(operand_hypertries.begin(), operand_hypertries.end());
+		std::vector<key_part_type> expected(operand_keys[0].begin(), operand_keys[0].end());
+		for (const auto &keys : internal::util::skip<1>(operand_keys)) {
+			std::vector<key_part_type> intersection;
+			std::set_intersection(expected.begin(), expected.end(), keys.begin(), keys.end(), std::back_inserter(intersection));
+			expected = std::move(intersection);
+		}
+
+		SECTION("all operands are joined") {
+			HashJoin<tr> join{operands, {{0}, {0}, {0}}};
+			std::vector<key_part_type> joined;
+			for (auto it = join.begin(); it; ++it) {
+				auto [result, key_part] = *it;
+				REQUIRE(result.empty());
+				joined.push_back(key_part);
+			}
+			REQUIRE(joined == expected);
+		}
+
+		SECTION("an operand is not joined") {
+			Hypertrie<tr> other{2, context};
+			other.set({1, 2}, true);
+			other.set({3, 4}, true);
+			auto all_operands = operands;
+			all_operands.push_back(other);
+			HashJoin<tr> join{all_operands, {{0}, {0}, {0}, {}}};
+			std::vector<key_part_type> joined;
+			for (auto it = join.begin(); it; ++it) {
+				auto [result, key_part] = *it;
+				REQUIRE(result.size() == 1);
+				REQUIRE(result[0].hash() == other.hash());
+				joined.push_back(key_part);
+			}
+			REQUIRE(joined == expected);
+		}
+
+		SECTION("an operand has a single entry") {
+			Hypertrie<tr> single{1, context};
+			single.set({expected.front()}, true);
+			HashJoin<tr> join{{operands[0], operands[1], single}, {{0}, {0}, {0}}};
+			std::vector<key_part_type> joined;
+			for (auto it = join.begin(); it; ++it)
+				joined.push_back((*it).second);
+			REQUIRE(joined == std::vector<key_part_type>{expected.front()});
+		}
+	}
+
+};// namespace hypertrie::tests::roaring_bitmap_set
+
+#endif//HYPERTRIE_TESTROARINGBITMAPSET_HPP
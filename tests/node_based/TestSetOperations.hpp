@@ -0,0 +1,91 @@
+#ifndef HYPERTRIE_TESTSETOPERATIONS_HPP
+#define HYPERTRIE_TESTSETOPERATIONS_HPP
+
+#include <Dice/hypertrie/internal/Hypertrie.hpp>
+#include <Dice/hypertrie/internal/HypertrieContext.hpp>
+#include <Dice/hypertrie/internal/SetOperations.hpp>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+
+
+namespace hypertrie::tests::set_operations {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+
+	template<HypertrieTrait tr, size_t depth>
+	void test_set_operations() {
+		using key_part_type = typename tr::key_part_type;
+		using value_type = typename tr::value_type;
+		using Key = typename tr::Key;
+
+		SECTION("depth {}"_format(depth)) {
+			utils::EntryGenerator<key_part_type, value_type, tr::lsb_unused> gen{1, 100};
+			auto common_keys = gen.keys(80, depth);
+			auto a_keys = gen.keys(10, depth);
+			// fewer keys only in b, so that the intersection is computed from either operand depending on the order
+			auto b_keys = gen.keys(5, depth);
+
+			HypertrieContext<tr> context;
+			Hypertrie<tr> a{depth, context};
+			Hypertrie<tr> b{depth, context};
+			std::set<Key> a_entries;
+			std::set<Key> b_entries;
+			for (const auto &key : common_keys) {
+				a.set(key, true);
+				a_entries.insert(key);
+				b.set(key, true);
+				b_entries.insert(key);
+			}
+			for (const auto &key : a_keys) {
+				a.set(key, true);
+				a_entries.insert(key);
+			}
+			for (const auto &key : b_keys) {
+				b.set(key, true);
+				b_entries.insert(key);
+			}
+
+			std::set<Key> expected_union = a_entries;
+			expected_union.insert(b_entries.begin(), b_entries.end());
+			std::set<Key> expected_intersection;
+			std::set<Key> expected_difference;
+			for (const auto &key : a_entries)
+				if (b_entries.count(key))
+					expected_intersection.insert(key);
+				else
+					expected_difference.insert(key);
+
+			auto check = [](const const_Hypertrie<tr> &actual, const std::set<Key> &expected) {
+				REQUIRE(actual.size() == expected.size());
+				for (const auto &key : expected)
+					REQUIRE(actual[key]);
+			};
+
+			check(set_union<tr>(a, b), expected_union);
+			check(set_intersection<tr>(a, b), expected_intersection);
+			check(set_intersection<tr>(b, a), expected_intersection);
+			check(set_difference<tr>(a, b), expected_difference);
+			// the operands are not modified
+			check(a, a_entries);
+			check(b, b_entries);
+
+			// operations on identical hypertries share the operand
+			REQUIRE(set_union<tr>(a, a) == a);
+			REQUIRE(set_intersection<tr>(a, a) == a);
+			REQUIRE(set_difference<tr>(a, a).empty());
+		}
+	}
+
+	TEMPLATE_TEST_CASE("test_set_operations", "[SetOperations]", lsbunused_bool_Hypertrie_t, default_bool_Hypertrie_t) {
+		using tr = TestType;
+		test_set_operations<tr, 1>();
+		test_set_operations<tr, 2>();
+		test_set_operations<tr, 3>();
+		test_set_operations<tr, 4>();
+	}
+
+};// namespace hypertrie::tests::set_operations
+
+#endif//HYPERTRIE_TESTSETOPERATIONS_HPP
@@ -0,0 +1,196 @@
+#ifndef HYPERTRIE_TESTSHARDEDHYPERTRIE_HPP
+#define HYPERTRIE_TESTSHARDEDHYPERTRIE_HPP
+
+#include <Dice/hypertrie/hypertrie.hpp>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+
+
+namespace hypertrie::tests::sharded_hypertrie {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+
+	using tr = default_bool_Hypertrie_t;
+	using Key = typename tr::Key;
+
+	std::vector<Key> generateKeys(size_t count) {
+		utils::EntryGenerator<unsigned long, bool, false> gen{1, 15};
+		auto keys = gen.keys(count, 3);
+		return {keys.begin(), keys.end()};
+	}
+
+	TEST_CASE("entries are partitioned into shards", "[ShardedHypertrie]") {
+		const auto keys = generateKeys(300);
+		HypertrieContext<tr> context;
+		Hypertrie<tr> reference{3, context};
+		for (const auto &key : keys)
+			reference.set(key, true);
+
+		for (pos_type shard_pos : {0, 2}) {
+			ShardedHypertrie<tr> sharded{3, 4, shard_pos};
+			for (const auto &key : keys)
+				sharded.set(key, true);
+			REQUIRE(sharded.size() == reference.size());
+			for (const auto &key : keys) {
+				REQUIRE(sharded[key]);
+				REQUIRE(sharded.shard(sharded.shardOf(key))[key]);
+			}
+			REQUIRE(sharded.getCards({shard_pos}) == reference.getCards({shard_pos}));
+			for (pos_type pos = 0; pos < 3; ++pos)
+				REQUIRE(sharded.getCards({pos})[0] >= reference.getCards({pos})[0]);
+		}
+	}
+
+	TEST_CASE("shards are bulk loaded in parallel", "[ShardedHypertrie]") {
+		const auto keys = generateKeys(1'000);
+		ShardedHypertrie<tr> reference{3, 3};
+		for (const auto &key : keys)
+			reference.set(key, true);
+
+		ShardedHypertrie<tr> bulk_loaded{3, 3};
+		bulk_loaded.bulk_insert(keys);
+
+		ShardedHypertrie<tr> inserted{3, 3};
+		{
+			ShardedBulkInserter<tr> inserter{inserted, 100};
+			for (const auto &key : keys)
+				inserter.add(key);
+		}
+
+		for (size_t i = 0; i < reference.shardCount(); ++i) {
+			REQUIRE(bulk_loaded.shard(i).hash() == reference.shard(i).hash());
+			REQUIRE(inserted.shard(i).hash() == reference.shard(i).hash());
+		}
+	}
+
+	TEST_CASE("many shards are bulk loaded concurrently", "[ShardedHypertrie]") {
+		utils::EntryGenerator<unsigned long, bool, false> gen{1, 200};
+		const auto generated = gen.keys(20'000, 3);
+		const std::vector<Key> keys{generated.begin(), generated.end()};
+		HypertrieContext<tr> context;
+		Hypertrie<tr> reference{3, context};
+		for (const auto &key : keys)
+			reference.set(key, true);
+
+		ShardedHypertrie<tr> serial{3, 8};
+		for (const auto &key : keys)
+			serial.set(key, true);
+
+		// several rounds, so that the shards are modified concurrently while they are not empty
+		ShardedHypertrie<tr> bulk_loaded{3, 8};
+		const size_t round_size = keys.size() / 4;
+		for (size_t begin = 0; begin < keys.size(); begin += round_size)
+			bulk_loaded.bulk_insert({keys.begin() + begin, keys.begin() + std::min(begin + round_size, keys.size())});
+
+		REQUIRE(bulk_loaded.size() == reference.size());
+		for (size_t i = 0; i < bulk_loaded.shardCount(); ++i) {
+			REQUIRE(bulk_loaded.shard(i).hash() == serial.shard(i).hash());
+			for (const auto &key : bulk_loaded.shard(i))
+				REQUIRE(reference[key]);
+		}
+	}
+
+	template<typename value_type>
+	void test_sharded_einsum(const std::string &subscript_string, pos_type shard_pos, bool mixed) {
+		SECTION("{} sharded by {}{}"_format(subscript_string, shard_pos, (mixed) ? " mixed" : "")) {
+			const auto keys = generateKeys(200);
+			HypertrieContext<tr> context;
+			Hypertrie<tr> reference{3, context};
+			ShardedHypertrie<tr> sharded{3, 4, shard_pos};
+			for (const auto &key : keys) {
+				reference.set(key, true);
+				sharded.set(key, true);
+			}
+
+			auto subscript = std::make_shared<Subscript>(subscript_string);
+			const size_t operand_count = subscript->getRawSubscript().operands.size();
+			std::vector<const_Hypertrie<tr>> operands(operand_count, reference);
+			std::vector<ShardedOperand<tr>> sharded_operands;
+			for (size_t i = 0; i < operand_count; ++i) {
+				if (mixed and i % 2 == 1)
+					sharded_operands.emplace_back(reference);
+				else
+					sharded_operands.emplace_back(sharded);
+			}
+
+			const auto expected = einsum2map<value_type, tr>(subscript, operands);
+			REQUIRE(sharded_einsum2map<value_type, tr>(subscript, sharded_operands, TimePoint::max(), 3) == expected);
+
+			decltype(einsum2map<value_type, tr>(subscript, operands)) actual;
+			size_t count = 0;
+			ShardedEinsum<value_type, tr> einsum{subscript, sharded_operands};
+			for (auto &&entry : einsum) {
+				actual[entry.key] += entry.value;
+				++count;
+			}
+			REQUIRE(actual == expected);
+			if constexpr (std::is_same_v<value_type, bool>)
+				REQUIRE(count == expected.size());
+		}
+	}
+
+	TEST_CASE("einsum over sharded operands", "[ShardedHypertrie]") {
+		for (bool mixed : {false, true}) {
+			// projections, join on the shard label, cycle through the shard label
+			for (const auto &subscript : {"abc->a", "abc->b", "abc,ade->bcde", "abc,adb->cd"}) {
+				test_sharded_einsum<size_t>(subscript, 0, mixed);
+				test_sharded_einsum<bool>(subscript, 0, mixed);
+			}
+		}
+		// unsharded operands may be joined on other labels
+		test_sharded_einsum<size_t>("abc,cde->ae", 0, true);
+		test_sharded_einsum<bool>("abc,cde->ae", 0, true);
+		test_sharded_einsum<size_t>("abc,cde->ae", 2, true);
+	}
+
+	TEST_CASE("sharded einsum bypasses the slice cache of a shared context", "[ShardedHypertrie]") {
+		const auto keys = generateKeys(200);
+		HypertrieContext<tr> reference_context;
+		Hypertrie<tr> reference{3, reference_context};
+		HypertrieContext<tr> cached_context{64};
+		Hypertrie<tr> cached{3, cached_context};
+		ShardedHypertrie<tr> sharded{3, 4};
+		for (const auto &key : keys) {
+			reference.set(key, true);
+			cached.set(key, true);
+			sharded.set(key, true);
+		}
+
+		// the threads evaluating the shard combinations all slice the unsharded operand
+		auto subscript = std::make_shared<Subscript>("abc,ade->bcde");
+		const auto expected = einsum2map<size_t, tr>(subscript, std::vector<const_Hypertrie<tr>>{reference, reference});
+		const std::vector<ShardedOperand<tr>> operands{sharded, cached};
+		for (size_t run = 0; run < 4; ++run)
+			REQUIRE(sharded_einsum2map<size_t, tr>(subscript, operands, TimePoint::max(), 4) == expected);
+		const auto &cache = *cached_context.sliceCache();
+		REQUIRE(cache.hits() + cache.misses() == 0);
+		REQUIRE(cache.size() == 0);
+
+		// the calling thread still uses the cache
+		const_Hypertrie<tr> slice = std::get<0>(cached[typename tr::SliceKey{keys.front()[0], std::nullopt, std::nullopt}]);
+		REQUIRE(not slice.empty());
+		REQUIRE(cache.misses() == 1);
+	}
+
+	TEST_CASE("sharded operands must be co-partitioned", "[ShardedHypertrie]") {
+		const auto keys = generateKeys(50);
+		ShardedHypertrie<tr> sharded{3, 4, 0};
+		ShardedHypertrie<tr> fewer_shards{3, 2, 0};
+		for (const auto &key : keys) {
+			sharded.set(key, true);
+			fewer_shards.set(key, true);
+		}
+		const std::vector<ShardedOperand<tr>> other_labels{sharded, sharded};
+		const std::vector<ShardedOperand<tr>> other_shard_counts{sharded, fewer_shards};
+		for (const auto &[subscript_string, operands] : {std::pair{"abc,cde->ae", other_labels}, std::pair{"abc,ade->bcde", other_shard_counts}}) {
+			auto subscript = std::make_shared<Subscript>(subscript_string);
+			REQUIRE_THROWS_AS((ShardedEinsum<size_t, tr>{subscript, operands}), std::invalid_argument);
+			REQUIRE_THROWS_AS((sharded_einsum2map<size_t, tr>(subscript, operands)), std::invalid_argument);
+		}
+	}
+
+};// namespace hypertrie::tests::sharded_hypertrie
+
+#endif//HYPERTRIE_TESTSHARDEDHYPERTRIE_HPP
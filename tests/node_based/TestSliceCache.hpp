@@ -0,0 +1,127 @@
+#ifndef HYPERTRIE_TESTSLICECACHE_HPP
+#define HYPERTRIE_TESTSLICECACHE_HPP
+
+#include <Dice/hypertrie/internal/Hypertrie.hpp>
+#include <Dice/hypertrie/internal/HypertrieContext.hpp>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+
+
+namespace hypertrie::tests::slice_cache {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+
+	/**
+	 * The entries of a hypertrie. Returns an empty set for non-bool hypertries, as const_Hypertrie::iterator only supports bool.
+	 */
+	template<HypertrieTrait tr>
+	std::set<typename tr::Key> entries(const const_Hypertrie<tr> &hypertrie) {
+		std::set<typename tr::Key> result;
+		if constexpr (tr::is_bool_valued)
+			for (const auto &entry : hypertrie)
+				result.insert(entry);
+		return result;
+	}
+
+	template<HypertrieTrait tr, size_t depth>
+	void test_slice_cache() {
+		using key_part_type = typename tr::key_part_type;
+		using value_type = typename tr::value_type;
+		using SliceKey = typename tr::SliceKey;
+
+		SECTION("depth {}"_format(depth)) {
+			utils::EntryGenerator<key_part_type, value_type, tr::lsb_unused> gen{1, 15};
+			auto keys = gen.keys(100, depth);
+
+			HypertrieContext<tr> uncached_context;
+			HypertrieContext<tr> context{1000};
+			Hypertrie<tr> uncached{depth, uncached_context};
+			Hypertrie<tr> t{depth, context};
+			for (const auto &key : keys) {
+				uncached.set(key, value_type(1));
+				t.set(key, value_type(1));
+			}
+			auto &cache = *context.sliceCache();
+
+			std::vector<SliceKey> slice_keys;
+			for (const auto &key : keys) {
+				SliceKey slice_key(depth);
+				slice_key[0] = key[0];
+				slice_keys.push_back(slice_key);
+				slice_key[depth - 1] = key[depth - 1];
+				slice_keys.push_back(slice_key);
+			}
+
+			for (size_t round = 0; round < 2; ++round)
+				for (const auto &slice_key : slice_keys) {
+					auto expected = uncached[slice_key];
+					auto actual = t[slice_key];
+					REQUIRE(expected.index() == actual.index());
+					if (actual.index() == 0) {
+						const auto &sliced = std::get<0>(actual);
+						REQUIRE(sliced.hash() == std::get<0>(expected).hash());
+						REQUIRE(sliced.size() == std::get<0>(expected).size());
+						REQUIRE(entries(sliced) == entries(std::get<0>(expected)));
+					}
+				}
+			REQUIRE(cache.hits() + cache.misses() > 0);
+			REQUIRE(cache.hits() >= cache.misses());
+			const size_t cached = cache.size();
+
+			// modifying the hypertrie changes the hash of its root, so the old entries are not hit anymore
+			const SliceKey &slice_key = slice_keys.front();
+			const_Hypertrie<tr> before = std::get<0>(t[slice_key]);
+			auto before_entries = entries(before);
+			auto new_key = *keys.begin();
+			new_key[depth - 1] = key_part_type(16 * ((tr::lsb_unused) ? 2 : 1));
+			uncached.set(new_key, value_type(1));
+			t.set(new_key, value_type(1));
+			const size_t misses = cache.misses();
+			auto after = t[slice_key];
+			REQUIRE(cache.misses() == misses + 1);
+			REQUIRE(std::get<0>(after).hash() == std::get<0>(uncached[slice_key]).hash());
+			REQUIRE(std::get<0>(after).size() == before.size() + 1);
+			// results of the old version stay valid
+			REQUIRE(entries(before) == before_entries);
+			REQUIRE(cache.size() == cached + 1);
+
+			cache.clear();
+			REQUIRE(cache.size() == 0);
+			REQUIRE(std::get<0>(t[slice_key]).hash() == std::get<0>(after).hash());
+		}
+	}
+
+	TEMPLATE_TEST_CASE("slices are cached", "[SliceCache]", lsbunused_bool_Hypertrie_t, default_bool_Hypertrie_t, default_long_Hypertrie_t) {
+		test_slice_cache<TestType, 2>();
+		test_slice_cache<TestType, 3>();
+		test_slice_cache<TestType, 4>();
+	}
+
+	TEST_CASE("slice cache is bounded", "[SliceCache]") {
+		using tr = default_bool_Hypertrie_t;
+		HypertrieContext<tr> context{3};
+		Hypertrie<tr> t{2, context};
+		for (unsigned long i = 1; i <= 10; ++i)
+			for (unsigned long j = 1; j <= i; ++j)
+				t.set({i, j}, true);
+		auto &cache = *context.sliceCache();
+		for (unsigned long i = 1; i <= 10; ++i) {
+			REQUIRE(std::get<0>(t[tr::SliceKey{i, std::nullopt}]).size() == i);
+			REQUIRE(cache.size() == std::min<size_t>(i, cache.capacity()));
+		}
+		// the most recently used entries are kept
+		REQUIRE(std::get<0>(t[tr::SliceKey{10, std::nullopt}]).size() == 10);
+		REQUIRE(cache.hits() == 1);
+		REQUIRE(std::get<0>(t[tr::SliceKey{1, std::nullopt}]).size() == 1);
+		REQUIRE(cache.hits() == 1);
+
+		context.disableSliceCache();
+		REQUIRE(context.sliceCache() == nullptr);
+		REQUIRE(std::get<0>(t[tr::SliceKey{1, std::nullopt}]).size() == 1);
+	}
+
+};// namespace hypertrie::tests::slice_cache
+
+#endif//HYPERTRIE_TESTSLICECACHE_HPP
@@ -0,0 +1,101 @@
+#ifndef HYPERTRIE_TESTSORTEDINTERSECTION_HPP
+#define HYPERTRIE_TESTSORTEDINTERSECTION_HPP
+
+#include <Dice/hypertrie/internal/HashJoin.hpp>
+#include <Dice/hypertrie/internal/Hypertrie.hpp>
+#include <Dice/hypertrie/internal/HypertrieContext.hpp>
+#include <Dice/hypertrie/internal/util/SortedIntersection.hpp>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+
+
+namespace hypertrie::tests::sorted_intersection {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+	using namespace hypertrie::internal::util::sorted_intersection;
+
+	using key_part_type = unsigned long;
+
+	std::vector<key_part_type> sorted_key_parts(utils::RawGenerator<1, key_part_type, bool> &gen, size_t size) {
+		std::set<key_part_type> key_parts;
+		while (key_parts.size() < size)
+			key_parts.insert(gen.key_part());
+		return {key_parts.begin(), key_parts.end()};
+	}
+
+	TEST_CASE("sorted ranges are intersected", "[SortedIntersection]") {
+		utils::RawGenerator<1, key_part_type, bool> gen{1, 20'000};
+		for (auto [a_size, b_size] : std::vector<std::pair<size_t, size_t>>{{0, 10}, {1, 1}, {7, 13}, {1'000, 1'000}, {5'000, 3'000}, {10, 10'000}, {10'000, 20}}) {
+			SECTION("sizes {} and {}"_format(a_size, b_size)) {
+				auto a = sorted_key_parts(gen, a_size);
+				auto b = sorted_key_parts(gen, b_size);
+				std::vector<key_part_type> expected;
+				std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+				std::vector<key_part_type> out(std::min(a.size(), b.size()));
+				out.resize(intersect_merge<key_part_type>(a, b, out.data()));
+				REQUIRE(out == expected);
+
+				out.assign(std::min(a.size(), b.size()), 0);
+				out.resize(intersect_gallop<key_part_type>((a.size() < b.size()) ? a : b, (a.size() < b.size()) ? b : a, out.data()));
+				REQUIRE(out == expected);
+
+				// in place
+				a.resize(intersect<key_part_type>(a, b, a.data()));
+				REQUIRE(a == expected);
+			}
+		}
+	}
+
+	template<HypertrieTrait tr>
+	void test_depth_1_join(const std::vector<size_t> &sizes) {
+		using value_type = typename tr::value_type;
+		SECTION("operand sizes {}"_format(fmt::join(sizes, ", "))) {
+			HypertrieContext<tr> context;
+			utils::RawGenerator<1, key_part_type, bool> gen{1, 10'000};
+
+			std::vector<Hypertrie<tr>> operand_hypertries;
+			std::vector<key_part_type> expected;
+			for (size_t size : sizes) {
+				auto key_parts = sorted_key_parts(gen, size);
+				auto &operand = operand_hypertries.emplace_back(1, context);
+				for (auto key_part : key_parts)
+					operand.set({key_part}, value_type(2));
+				if (operand_hypertries.size() == 1) {
+					expected = key_parts;
+				} else {
+					std::vector<key_part_type> intersection;
+					std::set_intersection(expected.begin(), expected.end(), key_parts.begin(), key_parts.end(), std::back_inserter(intersection));
+					expected = std::move(intersection);
+				}
+			}
+			std::vector<const_Hypertrie<tr>> operands(operand_hypertries.begin(), operand_hypertries.end());
+			std::vector<typename HashJoin<tr>::poss_type> positions(operands.size(), {0});
+
+			HashJoin<tr> join{operands, positions};
+			std::vector<key_part_type> joined;
+			for (auto it = join.begin(); it; ++it) {
+				auto [result, key_part] = *it;
+				REQUIRE(result.empty());
+				joined.push_back(key_part);
+			}
+			// skewed joins are computed with the diagonals, which are not ordered
+			std::sort(joined.begin(), joined.end());
+			REQUIRE(joined == expected);
+		}
+	}
+
+	TEMPLATE_TEST_CASE("joining depth 1 hypertries", "[SortedIntersection]", default_bool_Hypertrie_t, default_long_Hypertrie_t) {
+		test_depth_1_join<TestType>({2, 3});
+		test_depth_1_join<TestType>({5'000, 5'000});
+		test_depth_1_join<TestType>({8'000, 50, 6'000});
+		test_depth_1_join<TestType>({3'000, 4'000, 5'000, 6'000});
+		// skewed beyond the size ratio of the sorted intersection
+		test_depth_1_join<TestType>({2, 9'000});
+	}
+
+};// namespace hypertrie::tests::sorted_intersection
+
+#endif//HYPERTRIE_TESTSORTEDINTERSECTION_HPP
@@ -0,0 +1,76 @@
+#ifndef HYPERTRIE_TESTSTATICEINSUM_HPP
+#define HYPERTRIE_TESTSTATICEINSUM_HPP
+
+#include <Dice/hypertrie/hypertrie.hpp>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+
+
+namespace hypertrie::tests::static_einsum {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+
+	using tr = default_bool_Hypertrie_t;
+
+	template<::einsum::internal::SubscriptLiteral subscript, typename value_type>
+	void test_static_einsum(const Hypertrie<tr> &hypertrie, const Hypertrie<tr> &graph) {
+		const std::string subscript_string{subscript.chars.data()};
+		SECTION("{} {}"_format(subscript_string, (std::is_same_v<value_type, bool>) ? "bool" : "size_t")) {
+			std::vector<const_Hypertrie<tr>> operands;
+			for (std::size_t operand = 0; operand < StaticEinsum<subscript, value_type, tr>::operand_count; ++operand)
+				operands.push_back((StaticEinsum<subscript, value_type, tr>::plan.operand_depths[operand] == 2) ? graph : hypertrie);
+			const auto expected = einsum2map<value_type, tr>(std::make_shared<Subscript>(subscript_string), operands);
+			REQUIRE(static_einsum2map<subscript, value_type, tr>(operands) == expected);
+
+			// every entry is produced once for bool
+			if constexpr (std::is_same_v<value_type, bool>) {
+				size_t count = 0;
+				StaticEinsum<subscript, value_type, tr>::run(operands, [&](const auto &, bool) { ++count; });
+				REQUIRE(count == expected.size());
+			}
+		}
+	}
+
+	template<::einsum::internal::SubscriptLiteral subscript>
+	void test_static_einsum(const Hypertrie<tr> &hypertrie, const Hypertrie<tr> &graph) {
+		test_static_einsum<subscript, size_t>(hypertrie, graph);
+		test_static_einsum<subscript, bool>(hypertrie, graph);
+	}
+
+	TEST_CASE("static einsum computes the same results as einsum", "[StaticEinsum]") {
+		utils::EntryGenerator<unsigned long, bool, false> gen{1, 10};
+		HypertrieContext<tr> context;
+		Hypertrie<tr> hypertrie{3, context};
+		for (const auto &key : gen.keys(200, 3))
+			hypertrie.set(key, true);
+		Hypertrie<tr> graph{2, context};
+		for (const auto &key : gen.keys(40, 2))
+			graph.set(key, true);
+
+		test_static_einsum<"ab,bc->ac">(hypertrie, graph);
+		test_static_einsum<"ab,ac,ad->bcd">(hypertrie, graph);
+		test_static_einsum<"abc,cde->ae">(hypertrie, graph);
+		test_static_einsum<"abc,ade->bcde">(hypertrie, graph);
+		test_static_einsum<"ab,bc,ca->a">(hypertrie, graph);
+		test_static_einsum<"axb,byc,cza->">(hypertrie, graph);
+		test_static_einsum<"aab,bc->c">(hypertrie, graph);
+		test_static_einsum<"abc->a">(hypertrie, graph);
+		test_static_einsum<"abc->">(hypertrie, graph);
+	}
+
+	TEST_CASE("static einsum checks its operands", "[StaticEinsum]") {
+		HypertrieContext<tr> context;
+		Hypertrie<tr> graph{2, context};
+		graph.set({1, 2}, true);
+		Hypertrie<tr> empty{2, context};
+
+		REQUIRE_THROWS_AS((static_einsum2map<"ab,bc->ac">({graph})), std::invalid_argument);
+		REQUIRE_THROWS_AS((static_einsum2map<"abc,bc->ac">({graph, graph})), std::invalid_argument);
+		REQUIRE((static_einsum2map<"ab,bc->ac">({graph, empty})).empty());
+	}
+
+};// namespace hypertrie::tests::static_einsum
+
+#endif//HYPERTRIE_TESTSTATICEINSUM_HPP
@@ -0,0 +1,102 @@
+#ifndef HYPERTRIE_TESTSTATICHYPERTRIE_HPP
+#define HYPERTRIE_TESTSTATICHYPERTRIE_HPP
+
+#include <Dice/hypertrie/internal/Hypertrie.hpp>
+#include <Dice/hypertrie/internal/HypertrieContext.hpp>
+#include <Dice/hypertrie/internal/StaticHypertrie.hpp>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+
+
+namespace hypertrie::tests::static_hypertrie {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+
+	template<HypertrieTrait tr, size_t depth>
+	void test_static_hypertrie() {
+		using key_part_type = typename tr::key_part_type;
+		using value_type = typename tr::value_type;
+		using Key = typename tr::Key;
+		using StaticKey = typename StaticHypertrie<depth, tr>::Key;
+
+		SECTION("depth {}"_format(depth)) {
+			utils::EntryGenerator<key_part_type, value_type, tr::lsb_unused> gen{1, 15};
+			auto keys = gen.keys((depth == 1) ? 5 : 100, depth);
+
+			HypertrieContext<tr> context;
+			StaticHypertrie<depth, tr> t{context};
+			Hypertrie<tr> expected{depth, context};
+			for (const auto &key : keys) {
+				StaticKey static_key;
+				std::copy(key.begin(), key.end(), static_key.begin());
+				t.set(static_key, true);
+				expected.set(key, true);
+				REQUIRE(t[static_key]);
+			}
+			// identical tensors are stored in the same nodes
+			REQUIRE(t == expected);
+			REQUIRE(t.size() == keys.size());
+			REQUIRE(t.getCards({0}) == expected.getCards({0}));
+
+			std::set<Key> iterated;
+			for (auto it = t.begin(); it != t.end(); ++it)
+				iterated.insert(*it);
+			REQUIRE(iterated == keys);
+
+			std::set<Key> iterated_raw;
+			for (auto it = t.rawKeyBegin(); it; ++it)
+				iterated_raw.insert(Key(it->begin(), it->end()));
+			REQUIRE(iterated_raw == keys);
+
+			const Key &first_key = *keys.begin();
+			if constexpr (depth > 1) {
+				auto sliced = t.template slice<1>({{{0, first_key[0]}}});
+				STATIC_REQUIRE(decltype(sliced)::depth() == depth - 1);
+				typename tr::SliceKey dynamic_slice_key(depth);
+				dynamic_slice_key[0] = first_key[0];
+				REQUIRE(sliced == std::get<0>(expected[dynamic_slice_key]));
+
+				typename const_StaticHypertrie<depth, tr>::SliceKey static_slice_key{};
+				static_slice_key[0] = first_key[0];
+				REQUIRE(std::get<0>(t[static_slice_key]) == sliced.dynamic());
+			}
+
+			// interoperation with the dynamic types
+			const const_Hypertrie<tr> &as_dynamic = t;
+			REQUIRE(as_dynamic.depth() == depth);
+			REQUIRE(as_dynamic.size() == keys.size());
+			Hypertrie<tr> dynamic_copy = t.toHypertrie();
+			StaticHypertrie<depth, tr> from_dynamic{expected};
+			REQUIRE(from_dynamic == t);
+			REQUIRE_THROWS_AS((StaticHypertrie<depth + 1, tr>{expected}), std::invalid_argument);
+
+			// copies share the nodes until they are modified
+			auto snapshot = t.snapshot();
+			Key new_key;
+			do
+				new_key = gen.key(depth);
+			while (keys.count(new_key));
+			StaticKey new_static_key;
+			std::copy(new_key.begin(), new_key.end(), new_static_key.begin());
+			t.set(new_static_key, true);
+			REQUIRE(t.size() == keys.size() + 1);
+			REQUIRE(snapshot.size() == keys.size());
+			REQUIRE(not snapshot[new_static_key]);
+			REQUIRE(not dynamic_copy[new_key]);
+			REQUIRE(not from_dynamic[new_static_key]);
+		}
+	}
+
+	TEMPLATE_TEST_CASE("test_static_hypertrie", "[StaticHypertrie]", lsbunused_bool_Hypertrie_t, default_bool_Hypertrie_t) {
+		using tr = TestType;
+		test_static_hypertrie<tr, 1>();
+		test_static_hypertrie<tr, 2>();
+		test_static_hypertrie<tr, 3>();
+		test_static_hypertrie<tr, 4>();
+	}
+
+};// namespace hypertrie::tests::static_hypertrie
+
+#endif//HYPERTRIE_TESTSTATICHYPERTRIE_HPP
@@ -0,0 +1,100 @@
+#ifndef HYPERTRIE_TESTSWISSTABLE_HPP
+#define HYPERTRIE_TESTSWISSTABLE_HPP
+
+#include <Dice/hypertrie/internal/container/SwissMap.hpp>
+#include <Dice/hypertrie/internal/container/SwissSet.hpp>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+
+
+namespace hypertrie::tests::swiss_table {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+	using hypertrie::internal::container::swiss_map;
+	using hypertrie::internal::container::swiss_set;
+
+	using key_part_type = unsigned long;
+
+	TEST_CASE("swiss map behaves like std::map", "[SwissTable]") {
+		for (key_part_type max : {key_part_type(100), key_part_type(100'000)}) {
+			SECTION("key parts up to {}"_format(max)) {
+				utils::RawGenerator<1, key_part_type, bool> gen{1, max};
+				std::map<key_part_type, long> expected;
+				swiss_map<key_part_type, long> map;
+				for (size_t i = 0; i < 20'000; ++i) {
+					const key_part_type key = gen.key_part();
+					switch (i % 4) {
+						case 0:
+						case 1:
+							REQUIRE(map.insert({key, long(i)}).second == expected.insert({key, long(i)}).second);
+							break;
+						case 2:
+							map[key] += 1;
+							expected[key] += 1;
+							break;
+						default:
+							REQUIRE(map.erase(key) == expected.erase(key));
+					}
+					REQUIRE(map.size() == expected.size());
+				}
+				for (const auto &[key, value] : expected) {
+					auto found = map.find(key);
+					REQUIRE(found != map.end());
+					REQUIRE(found->second == value);
+				}
+				REQUIRE(std::map<key_part_type, long>(map.begin(), map.end()) == expected);
+				for (size_t i = 0; i < 1'000; ++i) {
+					const key_part_type key = gen.key_part();
+					REQUIRE(map.count(key) == expected.count(key));
+				}
+
+				// copies and moves
+				auto copy = map;
+				REQUIRE(copy == map);
+				auto moved = std::move(copy);
+				REQUIRE(moved == map);
+				REQUIRE(copy.empty());
+				copy = moved;
+				REQUIRE(copy == map);
+
+				// erase during iteration
+				for (auto it = map.begin(); it != map.end();) {
+					if (it->first % 2 == 0)
+						it = map.erase(it);
+					else
+						++it;
+				}
+				for (const auto &[key, value] : map)
+					REQUIRE(key % 2 == 1);
+				REQUIRE(map.size() == size_t(std::count_if(expected.begin(), expected.end(), [](const auto &entry) { return entry.first % 2 == 1; })));
+				map.clear();
+				REQUIRE(map.empty());
+				REQUIRE(map.begin() == map.end());
+			}
+		}
+	}
+
+	TEST_CASE("swiss set behaves like std::set", "[SwissTable]") {
+		utils::RawGenerator<1, key_part_type, bool> gen{1, 10'000};
+		std::set<key_part_type> expected;
+		swiss_set<key_part_type> set{1, 2, 3};
+		expected.insert({1, 2, 3});
+		for (size_t i = 0; i < 30'000; ++i) {
+			const key_part_type key = gen.key_part();
+			if (i % 3 != 2) {
+				REQUIRE(set.insert(key).second == expected.insert(key).second);
+			} else {
+				REQUIRE(set.erase(key) == expected.erase(key));
+			}
+		}
+		REQUIRE(set.size() == expected.size());
+		REQUIRE(std::set<key_part_type>(set.begin(), set.end()) == expected);
+		for (auto key : expected)
+			REQUIRE(set.contains(key));
+	}
+
+};// namespace hypertrie::tests::swiss_table
+
+#endif//HYPERTRIE_TESTSWISSTABLE_HPP
@@ -0,0 +1,176 @@
+#ifndef HYPERTRIE_TESTWRITEAHEADLOG_HPP
+#define HYPERTRIE_TESTWRITEAHEADLOG_HPP
+
+#include <csignal>
+#include <filesystem>
+#include <system_error>
+
+#include <sys/resource.h>
+
+#include <Dice/hypertrie/internal/BulkInserter.hpp>
+#include <Dice/hypertrie/internal/Hypertrie.hpp>
+#include <Dice/hypertrie/internal/HypertrieContext.hpp>
+#include <Dice/hypertrie/internal/WriteAheadLog.hpp>
+
+#include <fmt/format.h>
+
+#include "../utils/AssetGenerator.hpp"
+#include "../utils/TemporaryFile.hpp"
+
+
+namespace hypertrie::tests::write_ahead_log {
+	using namespace fmt::literals;
+	using namespace hypertrie::tests::utils;
+
+	template<HypertrieTrait tr, size_t depth>
+	void test_replay(size_t group_size) {
+		using key_part_type = typename tr::key_part_type;
+		using value_type = typename tr::value_type;
+		using Key = typename tr::Key;
+		SECTION("depth {}, group size {}"_format(depth, group_size)) {
+			TemporaryFile file{"replay", "wal"};
+			utils::RawGenerator<depth, key_part_type, value_type, size_t(tr::lsb_unused)> gen{1, 20, value_type(1), value_type(5)};
+
+			HypertrieContext<tr> context;
+			Hypertrie<tr> hypertrie{depth, context};
+			{
+				WriteAheadLog<tr> log{file.path, {group_size, false}};
+				std::vector<Key> keys;
+				for (size_t i = 0; i < 500; ++i) {
+					auto raw_key = gen.key();
+					Key key{raw_key.begin(), raw_key.end()};
+					value_type value = gen.value();
+					// overwrite previously set keys now and then
+					if (i % 3 == 2 and not keys.empty())
+						key = keys[i % keys.size()];
+					log.set(hypertrie, key, value);
+					keys.push_back(key);
+				}
+			}
+
+			HypertrieContext<tr> replay_context;
+			Hypertrie<tr> replayed{depth, replay_context};
+			WriteAheadLog<tr> log{file.path, {group_size, false}};
+			REQUIRE(log.replay(replayed) == 500);
+			REQUIRE(replayed.size() == hypertrie.size());
+			REQUIRE(replayed.hash() == hypertrie.hash());
+		}
+	}
+
+	TEMPLATE_TEST_CASE("replaying a write-ahead log", "[WriteAheadLog]", default_bool_Hypertrie_t, lsbunused_bool_Hypertrie_t, default_long_Hypertrie_t) {
+		for (size_t group_size : {size_t(1), size_t(64), size_t(0)}) {
+			test_replay<TestType, 1>(group_size);
+			test_replay<TestType, 2>(group_size);
+			test_replay<TestType, 3>(group_size);
+		}
+	}
+
+	TEST_CASE("logging bulk inserted batches", "[WriteAheadLog]") {
+		using tr = default_bool_Hypertrie_t;
+		TemporaryFile file{"bulk", "wal"};
+		utils::RawGenerator<3, unsigned long, bool> gen{1, 50};
+
+		HypertrieContext<tr> context;
+		Hypertrie<tr> hypertrie{3, context};
+		{
+			WriteAheadLog<tr> log{file.path, {0, true}};
+			BulkInserter<tr> bulk_inserter{hypertrie, 1'000, &log};
+			for (size_t i = 0; i < 5'000; ++i) {
+				auto raw_key = gen.key();
+				bulk_inserter.add(tr::Key{raw_key.begin(), raw_key.end()});
+			}
+			bulk_inserter.flush(true);
+			REQUIRE(log.pending() == 0);
+			// single sets and batches can be mixed
+			log.set(hypertrie, tr::Key{51, 51, 51}, true);
+		}
+
+		HypertrieContext<tr> replay_context;
+		Hypertrie<tr> replayed{3, replay_context};
+		WriteAheadLog<tr> log{file.path};
+		log.replay(replayed);
+		REQUIRE(replayed[tr::Key{51, 51, 51}]);
+		REQUIRE(replayed.size() == hypertrie.size());
+		REQUIRE(replayed.hash() == hypertrie.hash());
+	}
+
+	TEST_CASE("a torn record at the end of a write-ahead log is discarded", "[WriteAheadLog]") {
+		using tr = default_long_Hypertrie_t;
+		TemporaryFile file{"torn", "wal"};
+
+		HypertrieContext<tr> context;
+		Hypertrie<tr> hypertrie{2, context};
+		{
+			WriteAheadLog<tr> log{file.path, {2, false}};
+			log.set(hypertrie, {1, 2}, 3);
+			log.set(hypertrie, {2, 3}, 4);
+			log.set(hypertrie, {3, 4}, 5);
+			log.set(hypertrie, {4, 5}, 6);
+		}
+		// cut off a part of the second record
+		std::filesystem::resize_file(file.path, std::filesystem::file_size(file.path) - 5);
+
+		{
+			HypertrieContext<tr> replay_context;
+			Hypertrie<tr> replayed{2, replay_context};
+			WriteAheadLog<tr> log{file.path, {2, false}};
+			REQUIRE(log.replay(replayed) == 2);
+			REQUIRE(replayed.size() == 2);
+			REQUIRE(replayed[tr::Key{2, 3}] == 4);
+			REQUIRE(replayed[tr::Key{3, 4}] == 0);
+			// entries appended after a replay follow the last valid record
+			log.set(replayed, {5, 6}, 7);
+		}
+
+		HypertrieContext<tr> replay_context;
+		Hypertrie<tr> replayed{2, replay_context};
+		WriteAheadLog<tr> log{file.path};
+		REQUIRE(log.replay(replayed) == 3);
+		REQUIRE(replayed[tr::Key{5, 6}] == 7);
+
+		Hypertrie<tr> wrong_depth{3, replay_context};
+		REQUIRE_THROWS_AS(log.replay(wrong_depth), std::invalid_argument);
+
+		log.reset();
+		REQUIRE(std::filesystem::file_size(file.path) == 0);
+	}
+
+	TEST_CASE("a group that fails to be written is cut off the write-ahead log", "[WriteAheadLog]") {
+		using tr = default_long_Hypertrie_t;
+		TemporaryFile file{"failed_commit", "wal"};
+
+		HypertrieContext<tr> context;
+		Hypertrie<tr> hypertrie{2, context};
+		WriteAheadLog<tr> log{file.path, {0, false}};
+		log.set(hypertrie, {1, 2}, 3);
+		log.commit();
+		const auto committed_size = std::filesystem::file_size(file.path);
+		for (unsigned long i = 1; i <= 1'000; ++i)
+			log.set(hypertrie, {i, i + 1}, long(i));
+
+		// the file size limit lets the write of the group stop in the middle of it
+		rlimit file_size_limit;
+		REQUIRE(::getrlimit(RLIMIT_FSIZE, &file_size_limit) == 0);
+		rlimit lowered_limit = file_size_limit;
+		lowered_limit.rlim_cur = committed_size + 100;
+		const auto previous_handler = std::signal(SIGXFSZ, SIG_IGN);
+		REQUIRE(::setrlimit(RLIMIT_FSIZE, &lowered_limit) == 0);
+		REQUIRE_THROWS_AS(log.commit(), std::system_error);
+		REQUIRE(::setrlimit(RLIMIT_FSIZE, &file_size_limit) == 0);
+		std::signal(SIGXFSZ, previous_handler);
+
+		REQUIRE(std::filesystem::file_size(file.path) == committed_size);
+		REQUIRE(log.pending() == 1'000);
+		// the retry follows the last committed group
+		log.commit();
+
+		HypertrieContext<tr> replay_context;
+		Hypertrie<tr> replayed{2, replay_context};
+		WriteAheadLog<tr> replay_log{file.path};
+		REQUIRE(replay_log.replay(replayed) == 1'001);
+		REQUIRE(replayed.hash() == hypertrie.hash());
+	}
+
+};// namespace hypertrie::tests::write_ahead_log
+
+#endif//HYPERTRIE_TESTWRITEAHEADLOG_HPP
@@ -97,9 +97,9 @@ namespace hypertrie::tests::utils {
 					RawKey<depth - diag_depth> sub_key;
 					{
 						auto sub_key_pos = 0;
-						auto diag_pos = 0;
+						size_t diag_pos = 0;
 						for (auto [pos, key_part] : iter::enumerate(key)) {
-							if (diagonal_positions[diag_pos] == pos) {
+							if (diag_pos < diagonal_positions.size() and diagonal_positions[diag_pos] == pos) {
 								diag_pos++;
 								continue;
 							} else {
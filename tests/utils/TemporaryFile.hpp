@@ -0,0 +1,37 @@
+#ifndef HYPERTRIE_TEMPORARYFILE_HPP
+#define HYPERTRIE_TEMPORARYFILE_HPP
+
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+namespace hypertrie::tests::utils {
+
+	/**
+	 * A path in the temporary directory that is unique per test process. A file at the path is removed when the
+	 * TemporaryFile is created and when it goes out of scope, also if a test fails.
+	 */
+	struct TemporaryFile {
+		std::filesystem::path path;
+
+		TemporaryFile(const std::string &name, const std::string &extension)
+			: path(std::filesystem::temp_directory_path() / fmt::format("hypertrie_test_{}_{}.{}", name, ::getpid(), extension)) {
+			std::filesystem::remove(path);
+		}
+
+		TemporaryFile(const TemporaryFile &) = delete;
+		TemporaryFile &operator=(const TemporaryFile &) = delete;
+
+		~TemporaryFile() {
+			std::error_code ignored;
+			std::filesystem::remove(path, ignored);
+		}
+	};
+
+}// namespace hypertrie::tests::utils
+
+#endif//HYPERTRIE_TEMPORARYFILE_HPP